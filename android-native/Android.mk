@@ -446,6 +446,7 @@ LOCAL_SRC_FILES := \
   src/ndn-cpp/src/digest-sha256-signature.cpp \
   src/ndn-cpp/src/exclude.cpp \
   src/ndn-cpp/src/face.cpp \
+  src/ndn-cpp/src/face-reactor.cpp \
   src/ndn-cpp/src/generic-signature.cpp \
   src/ndn-cpp/src/hmac-with-sha256-signature.cpp \
   src/ndn-cpp/src/interest-filter.cpp \
@@ -491,6 +492,7 @@ LOCAL_SRC_FILES := \
   src/ndn-cpp/src/impl/interest-filter-table.cpp \
   src/ndn-cpp/src/impl/pending-interest-table.cpp \
   src/ndn-cpp/src/impl/registered-prefix-table.cpp \
+  src/ndn-cpp/src/impl/wakeup-event.cpp \
   src/ndn-cpp/src/lite/control-parameters-lite.cpp \
   src/ndn-cpp/src/lite/control-response-lite.cpp \
   src/ndn-cpp/src/lite/data-lite.cpp \
@@ -541,6 +543,7 @@ LOCAL_SRC_FILES := \
   src/ndn-cpp/src/security/policy/no-verify-policy-manager.cpp \
   src/ndn-cpp/src/security/policy/policy-manager.cpp \
   src/ndn-cpp/src/security/policy/self-verify-policy-manager.cpp \
+  src/ndn-cpp/src/security/policy/verifier-pool.cpp \
   src/ndn-cpp/src/transport/async-tcp-transport.cpp \
   src/ndn-cpp/src/transport/async-unix-transport.cpp \
   src/ndn-cpp/src/transport/tcp-transport.cpp \
@@ -553,6 +556,7 @@ LOCAL_SRC_FILES := \
   src/ndn-cpp/src/util/dynamic-uint8-vector.cpp \
   src/ndn-cpp/src/util/exponential-re-express.cpp \
   src/ndn-cpp/src/util/logging.cpp \
+  src/ndn-cpp/src/util/mapped-content-store.cpp \
   src/ndn-cpp/src/util/memory-content-cache.cpp \
   src/ndn-cpp/src/util/segment-fetcher.cpp \
   src/ndn-cpp/src/util/regex/ndn-regex-backref-manager.cpp \
@@ -97,6 +97,11 @@
 #define NDN_CPP_HAVE_MEMCPY 1
 #endif
 
+/* Define to 1 if you have the `memmove' function. */
+#ifndef NDN_CPP_HAVE_MEMMOVE
+#define NDN_CPP_HAVE_MEMMOVE 1
+#endif
+
 /* Define to 1 if you have the <memory.h> header file. */
 #ifndef NDN_CPP_HAVE_MEMORY_H
 #define NDN_CPP_HAVE_MEMORY_H 1
@@ -0,0 +1,125 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2017 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+/**
+ * This benchmarks the per-packet cost of the internal PendingInterestTable as
+ * the number of pending interests grows. For each incoming Data packet, find
+ * and remove the matching entry, then add a new entry for the same name so
+ * that the size of the table stays the same.
+ * Usage: test-pending-interest-table-benchmark [maxEntries]
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <sys/time.h>
+#include <stdexcept>
+#include <ndn-cpp/data.hpp>
+#include "../src/impl/pending-interest-table.hpp"
+
+using namespace std;
+using namespace ndn;
+
+static double
+getNowSeconds()
+{
+  struct timeval t;
+  gettimeofday(&t, 0);
+  return t.tv_sec + t.tv_usec / 1000000.0;
+}
+
+static void
+onData(const ptr_lib::shared_ptr<const Interest>& interest,
+       const ptr_lib::shared_ptr<Data>& data)
+{
+}
+
+/**
+ * Fill a PendingInterestTable with nEntries interests, then receive
+ * nIterations Data packets, each of which matches one entry.
+ * @param nEntries The number of entries in the pending interest table.
+ * @param nIterations The number of Data packets to process.
+ * @return The number of seconds for all iterations.
+ */
+static double
+benchmarkPendingInterestTableSeconds(int nEntries, int nIterations)
+{
+  PendingInterestTable table;
+  uint64_t lastPendingInterestId = 0;
+
+  // Make a pool of interests and matching Data packets which we reuse.
+  int nPool = nEntries < 1000 ? nEntries : 1000;
+  vector<ptr_lib::shared_ptr<const Interest> > interests;
+  vector<ptr_lib::shared_ptr<Data> > dataPackets;
+  for (int i = 0; i < nEntries; ++i) {
+    Name name("/ndn/benchmark/stream");
+    name.appendSequenceNumber(i);
+    ptr_lib::shared_ptr<const Interest> interest(new Interest(name, 4000.0));
+    table.add(++lastPendingInterestId, interest, onData, OnTimeout(),
+              OnNetworkNack());
+
+    if (i < nPool) {
+      interests.push_back(interest);
+      dataPackets.push_back(ptr_lib::make_shared<Data>
+        (Name(name).appendSegment(0)));
+    }
+  }
+
+  vector<ptr_lib::shared_ptr<PendingInterestTable::Entry> > entries;
+  double start = getNowSeconds();
+  for (int i = 0; i < nIterations; ++i) {
+    int iPool = i % nPool;
+
+    entries.clear();
+    table.extractEntriesForExpressedInterest(*dataPackets[iPool], entries);
+    if (entries.size() != 1)
+      throw runtime_error("Expected one matching pending interest");
+
+    // Replace the entry so that the table keeps the same size.
+    table.add(++lastPendingInterestId, interests[iPool], onData, OnTimeout(),
+              OnNetworkNack());
+  }
+  double finish = getNowSeconds();
+
+  return finish - start;
+}
+
+int
+main(int argc, char** argv)
+{
+  try {
+    int maxEntries = 1000000;
+    if (argc > 1)
+      maxEntries = atoi(argv[1]);
+
+    int nIterations = 100000;
+    for (int nEntries = 10; nEntries <= maxEntries; nEntries *= 10) {
+      double duration = benchmarkPendingInterestTableSeconds
+        (nEntries, nIterations);
+      cout << "PendingInterestTable entries: " << nEntries
+           << ", Duration sec, Hz, usec per packet: " << duration << ", "
+           << (nIterations / duration) << ", "
+           << (duration * 1000000.0 / nIterations) << endl;
+    }
+  } catch (std::exception& e) {
+    cout << "exception: " << e.what() << endl;
+  }
+  return 0;
+}
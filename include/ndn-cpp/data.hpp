@@ -288,6 +288,9 @@ public:
   }
 
 private:
+  // IdentityManager sets the default wire encoding after signing.
+  friend class IdentityManager;
+
   void
   setDefaultWireEncoding
     (const SignedBlob& defaultWireEncoding,
@@ -0,0 +1,211 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2017 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+#ifndef NDN_FACE_REACTOR_HPP
+#define NDN_FACE_REACTOR_HPP
+
+#include <map>
+#include <vector>
+#include "face.hpp"
+#if NDN_CPP_HAVE_STD_THREAD
+#include <mutex>
+#endif
+
+namespace ndn {
+
+class WakeupEvent;
+
+/**
+ * A FaceReactor runs the event loop for many Face objects on one thread,
+ * instead of calling processEvents for each Face. The reactor waits on the
+ * sockets of all the faces together (with epoll where it is available) and
+ * only processes the faces whose socket has data to receive. It also keeps
+ * one heap of the next call time (from callLater or an interest timeout) of
+ * each face, so that the cost of processEvents depends on the number of
+ * active faces and not on the total number of faces.
+ * processEvents also calls the callbacks given to Face.post, such as for
+ * signature verification on worker threads.
+ * Each Face must use a socket transport such as TcpTransport, UdpTransport or
+ * UnixTransport. A Face which is not yet connected is added to the wait set
+ * when it connects (for example on the first call to expressInterest).
+ * @note This class is an experimental feature. The API may change.
+ */
+class FaceReactor {
+public:
+  /**
+   * Create a FaceReactor with no faces.
+   * @throws std::runtime_error if the system can't create the wait set.
+   */
+  FaceReactor();
+
+  ~FaceReactor();
+
+  /**
+   * Add the face to the faces processed by processEvents. The FaceReactor
+   * takes over calling the callbacks for the face, so you should not call
+   * face.processEvents while the face is added.
+   * @param face The Face to add. This does not make a copy, so the Face must
+   * remain valid until you call removeFace or the FaceReactor is destroyed.
+   * If the face is already added, do nothing.
+   * @throws std::runtime_error if the face transport is async, such as for a
+   * ThreadsafeFace.
+   */
+  void
+  addFace(Face& face);
+
+  /**
+   * Remove the face so that processEvents no longer processes it. Call this
+   * before you call face.shutdown() or destroy the face. After this, you can
+   * call face.processEvents again. If the face was not added, do nothing.
+   * @param face The Face to remove.
+   */
+  void
+  removeFace(Face& face);
+
+  /**
+   * Wait until any face has data to receive or until the next call time of any
+   * face, but no longer than maxWaitMilliseconds. Then process the received
+   * packets of each ready face, call the timed-out calls and call the
+   * callbacks from Face.post, which calls callbacks such as onData, onInterest
+   * or onTimeout. If another thread calls Face.post while this is waiting,
+   * the wait ends so that the callback is called promptly. You should
+   * repeatedly call this from your event loop, on the thread which calls
+   * expressInterest, etc. on the faces.
+   * @param maxWaitMilliseconds The maximum time to wait in milliseconds.
+   * @throws This may throw an exception for reading data or in the callback
+   * for processing the data. If you call this from an main event loop, you
+   * may want to catch and log/disregard all exceptions.
+   */
+  void
+  processEvents(Milliseconds maxWaitMilliseconds);
+
+  /**
+   * Get the number of faces which were added.
+   * @return The number of faces.
+   */
+  size_t
+  size() const { return faces_.size(); }
+
+private:
+  /**
+   * A FaceEntry holds the state of one added Face.
+   */
+  class FaceEntry {
+  public:
+    FaceEntry(Face& face)
+    : face_(&face), socketDescriptor_(-1), callTime_(-1)
+    {
+    }
+
+    Face* face_;
+    // The socket in the wait set, or -1 if not waiting.
+    int socketDescriptor_;
+    // The call time in timerHeap_, or -1 if none.
+    MillisecondsSince1970 callTime_;
+  };
+
+  typedef std::pair<MillisecondsSince1970, Face*> Timer;
+
+  /**
+   * Add the socket of the face transport to the wait set if it is connected.
+   */
+  void
+  watchSocket(FaceEntry& entry);
+
+  /**
+   * Remove the socket of the entry from the wait set.
+   */
+  void
+  unwatchSocket(FaceEntry& entry);
+
+  /**
+   * Receive from the face which is ready and call its callbacks.
+   * @param face The face which is ready.
+   * @param hasData True if the socket has data to receive.
+   * @param isClosed True if the peer closed the connection.
+   * @param hasError True if the socket has a pending error.
+   */
+  void
+  processReadyFace(Face* face, bool hasData, bool isClosed, bool hasError);
+
+  /**
+   * Call the timed-out calls of the faces whose call time is due.
+   */
+  void
+  processTimers();
+
+  /**
+   * This is called when the face DelayedCallTable has a new next call time.
+   */
+  void
+  onNewFirstCall(Face* face, MillisecondsSince1970 callTime);
+
+  /**
+   * This is called by the face Node, possibly on another thread, when
+   * Face.post adds a call.
+   */
+  void
+  onPostedCall(Face* face);
+
+  /**
+   * Call the calls from Face.post of each face which onPostedCall added to
+   * postedFaces_.
+   */
+  void
+  processPostedCalls();
+
+  /**
+   * Push a timer for the entry unless the entry already has an earlier one.
+   */
+  void
+  scheduleTimer(FaceEntry& entry, MillisecondsSince1970 callTime);
+
+  /**
+   * Don't allow the copy constructor.
+   */
+  FaceReactor(const FaceReactor& other);
+
+  /**
+   * Don't allow the assignment operator.
+   */
+  FaceReactor& operator=(const FaceReactor& other);
+
+  std::map<Face*, ptr_lib::shared_ptr<FaceEntry> > faces_;
+  // The entries whose transport is not connected yet.
+  std::vector<Face*> unconnectedFaces_;
+  // A heap ordered so that the earliest call time is at front(). Entries which
+  // don't match the FaceEntry callTime_ are stale and skipped.
+  std::vector<Timer> timerHeap_;
+  // The epoll descriptor, or -1 if epoll is not used.
+  int epollDescriptor_;
+  // The faces which have calls from Face.post. Other threads may add to this.
+  std::vector<Face*> postedFaces_;
+  // This is in the wait set so that onPostedCall on another thread can end the
+  // wait. It is signaled while postedFaces_ is not empty.
+  ptr_lib::shared_ptr<WakeupEvent> wakeupEvent_;
+#if NDN_CPP_HAVE_STD_THREAD
+  std::mutex postedFacesMutex_;
+#endif
+};
+
+}
+
+#endif
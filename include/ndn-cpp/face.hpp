@@ -616,6 +616,15 @@ public:
   virtual void
   send(const uint8_t *encoding, size_t encodingLength);
 
+  /**
+   * Send any packets which the Transport has queued. While processEvents calls
+   * the callbacks, the socket transports queue the packets which the callbacks
+   * send (such as with putData) and send them together with a few system calls
+   * when processEvents returns. Call this to send the queued packets sooner.
+   */
+  virtual void
+  flush();
+
   /**
    * Process any packets to receive and call callbacks such as onData,
    * onInterest or onTimeout. This returns immediately if there is no data to
@@ -631,6 +640,23 @@ public:
   void
   processEvents();
 
+  /**
+   * Wait until there are packets to receive or until the next timeout (such as
+   * an interest timeout or a call from callLater) is due, but no longer than
+   * maxWaitMilliseconds, then process events the same as processEvents().
+   * With a socket transport, an event loop can call this repeatedly without
+   * calling sleep, and packets are processed as soon as they arrive. The
+   * transport waits with poll on its socket. A call to post from another
+   * thread also ends the wait. If the transport doesn't support waiting, this
+   * is the same as processEvents().
+   * @param maxWaitMilliseconds The maximum time to wait in milliseconds.
+   * @throws This may throw an exception for reading data or in the callback
+   * for processing the data. If you call this from an main event loop, you
+   * may want to catch and log/disregard all exceptions.
+   */
+  void
+  processEvents(Milliseconds maxWaitMilliseconds);
+
   /**
    * Check if the face is local based on the current connection through the
    * Transport; some Transport may cause network I/O (e.g. an IP host name lookup).
@@ -640,6 +666,28 @@ public:
   virtual bool
   isLocal();
 
+  /**
+   * Get the number of Interest and Data packets which this Face has received
+   * and decoded.
+   * @return The number of received packets.
+   * @note This is an experimental feature. This API may change in the future.
+   */
+  uint64_t
+  getNReceivedPackets() const;
+
+  /**
+   * Get the number of times that this Face had to allocate a new Interest or
+   * Data object to decode a received packet. The Face reuses the object for
+   * the previous received packet if the application did not keep a
+   * shared_ptr to it, so in steady state this count should not grow with
+   * getNReceivedPackets().
+   * @return The number of Interest and Data objects allocated for received
+   * packets.
+   * @note This is an experimental feature. This API may change in the future.
+   */
+  uint64_t
+  getNReceivedPacketAllocations() const;
+
   /**
    * Shut down and disconnect this Face.
    */
@@ -671,6 +719,57 @@ public:
   virtual void
   callLater(Milliseconds delayMilliseconds, const Callback& callback);
 
+  /**
+   * A CancellableCall is returned by callLaterCancellable so that the call can
+   * be cancelled before it is made.
+   */
+  class CancellableCall {
+  public:
+    virtual
+    ~CancellableCall();
+
+    /**
+     * Cancel the call so that the callback is not called, and release the
+     * callback. If the call was already made or cancelled, do nothing.
+     */
+    virtual void
+    cancel() = 0;
+  };
+
+  /**
+   * Call callback() after the given delay, the same as callLater, but return
+   * a CancellableCall which can cancel it. The library uses this for interest
+   * timeouts so that the timeout is released when the pending interest is
+   * removed. Even though this is public, it is not part of the public API of
+   * Face. This default implementation schedules the call with callLater, so a
+   * subclass which overrides only callLater still makes the call. If callLater
+   * is not overridden, cancel() also removes the call from the delayed call
+   * table of Node. A subclass can override this to cancel the call in its own
+   * event loop.
+   * @param delayMilliseconds The delay in milliseconds.
+   * @param callback This calls callback() after the delay.
+   * @return The CancellableCall for the new call. The library only keeps a
+   * weak_ptr to it, so the scheduled call must keep it alive until the call is
+   * made or cancelled.
+   */
+  virtual ptr_lib::shared_ptr<CancellableCall>
+  callLaterCancellable
+    (Milliseconds delayMilliseconds, const Callback& callback);
+
+  /**
+   * Call callback() on the thread which processes events for this Face, as
+   * soon as possible. Unlike callLater, this is thread-safe so that another
+   * thread, such as a worker thread which verifies signatures, can use it to
+   * call application callbacks on the thread of the Face. This default
+   * implementation adds the callback to the calls which processEvents() calls.
+   * (If the thread is waiting in processEvents(maxWaitMilliseconds), this
+   * ends the wait so that the callback is called promptly.) A subclass can
+   * override.
+   * @param callback This calls callback().
+   */
+  virtual void
+  post(const Callback& callback);
+
 protected:
   /**
    * If the forwarder's Unix socket file path exists, then return the file path.
@@ -706,6 +805,8 @@ protected:
   Name commandCertificateName_;
 
 private:
+  friend class FaceReactor;
+
   static ptr_lib::shared_ptr<Transport>
   getDefaultTransport();
 
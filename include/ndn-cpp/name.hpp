@@ -31,6 +31,13 @@
 #include "util/blob.hpp"
 #include "encoding/wire-format.hpp"
 #include "lite/name-lite.hpp"
+// common.hpp (from blob.hpp) includes ndn-cpp-config.h.
+#if NDN_CPP_HAVE_CXX11
+#include <functional>
+#include <unordered_map>
+#else
+#include <map>
+#endif
 
 namespace ndn {
 
@@ -525,6 +532,14 @@ public:
     Component
     getSuccessor() const;
 
+    /**
+     * Get a hash code of the component value for use in a hash table such as
+     * std::unordered_map. Equal components have the same hash code.
+     * @return The hash code.
+     */
+    size_t
+    hash() const;
+
     /**
      * Check if this is the same component as other.
      * @param other The other Component to compare with.
@@ -617,7 +632,7 @@ public:
    * Create a new Name with no components.
    */
   Name()
-  : changeCount_(0)
+  : changeCount_(0), haveHashCode_(false)
   {
   }
 
@@ -626,7 +641,7 @@ public:
    * @param components A vector of Component
    */
   Name(const std::vector<Component>& components)
-  : components_(components), changeCount_(0)
+  : components_(components), changeCount_(0), haveHashCode_(false)
   {
   }
 
@@ -635,7 +650,7 @@ public:
    * @param uri The URI string.
    */
   Name(const char* uri)
-  : changeCount_(0)
+  : changeCount_(0), haveHashCode_(false)
   {
     set(uri);
   }
@@ -645,7 +660,7 @@ public:
    * @param uri The URI string.
    */
   Name(const std::string& uri)
-  : changeCount_(0)
+  : changeCount_(0), haveHashCode_(false)
   {
     set(uri.c_str());
   }
@@ -661,7 +676,11 @@ public:
   get(NameLite& nameLite) const;
 
   /**
-   * Clear this name, and set the components by copying from nameLite.
+   * Clear this name, and set the components by copying from nameLite. If a
+   * component of this name already has the same type and value as the
+   * component at the same index in nameLite, keep it without copying, so that
+   * decoding into the same Name object again only allocates for the components
+   * which changed.
    * @param nameLite A NameLite object.
    */
   void
@@ -1198,6 +1217,18 @@ public:
   uint64_t
   getChangeCount() const { return changeCount_; }
 
+  /**
+   * Get a hash code of this name for use in a hash table such as
+   * std::unordered_map. Equal names have the same hash code. This saves the
+   * hash code and only computes it again after the name is changed, according
+   * to getChangeCount(). Because saving the hash code modifies this object,
+   * don't call this (or look up this Name in a NameMap) from multiple threads
+   * at the same time without a lock, even though it is const.
+   * @return The hash code.
+   */
+  size_t
+  hash() const;
+
   /**
    * Compare this to the other Name using NDN canonical ordering. If the first
    * components of each name are not equal, this returns -1 if the first comes
@@ -1391,6 +1422,9 @@ public:
 private:
   std::vector<Component> components_;
   uint64_t changeCount_;
+  mutable size_t hashCode_;
+  mutable uint64_t hashCodeChangeCount_;
+  mutable bool haveHashCode_;
 };
 
 inline std::ostream&
@@ -1400,7 +1434,45 @@ operator << (std::ostream& os, const Name& name)
   return os;
 }
 
+/**
+ * NameMap<T>::type is a map from Name to T for the library's tables which are
+ * keyed by name. If the compiler supports C++11, this is a
+ * std::unordered_map which uses Name::hash(). Otherwise, this is a std::map
+ * which uses the NDN canonical ordering. Like the standard containers, a
+ * NameMap is not thread-safe. Also, since Name::hash() saves the hash code in
+ * the Name, even a lookup (a const operation) modifies the key object, so a
+ * class which shares a NameMap between threads must lock around lookups, as
+ * CertificateCache does.
+ */
+template<class T> class NameMap {
+public:
+#if NDN_CPP_HAVE_CXX11
+  typedef std::unordered_map<Name, T> type;
+#else
+  typedef std::map<Name, T> type;
+#endif
+};
+
+}
+
+#if NDN_CPP_HAVE_CXX11
+namespace std {
+
+template<> struct hash<ndn::Name> {
+  size_t
+  operator()(const ndn::Name& name) const { return name.hash(); }
+};
+
+template<> struct hash<ndn::Name::Component> {
+  size_t
+  operator()(const ndn::Name::Component& component) const
+  {
+    return component.hash();
+  }
+};
+
 }
+#endif
 
 #endif
 
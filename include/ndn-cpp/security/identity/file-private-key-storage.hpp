@@ -23,8 +23,15 @@
 #ifndef NDN_FILE_PRIVATE_KEY_STORAGE_HPP
 #define NDN_FILE_PRIVATE_KEY_STORAGE_HPP
 
+#include <ctime>
 #include <string>
+#include <map>
+#include "../../lite/security/ec-private-key-lite.hpp"
+#include "../../lite/security/rsa-private-key-lite.hpp"
 #include "private-key-storage.hpp"
+#if NDN_CPP_HAVE_STD_THREAD
+#include <mutex>
+#endif
 
 namespace ndn {
 
@@ -76,6 +83,8 @@ public:
 
   /**
    * Fetch the private key for keyName and sign the data, returning a signature Blob.
+   * This keeps the decoded private key in memory and only reads the private
+   * key file again if its modification time or size changes.
    * @param data Pointer to the input byte array.
    * @param dataLength The length of data.
    * @param keyName The name of the signing key.
@@ -124,7 +133,100 @@ public:
   virtual bool
   doesKeyExist(const Name& keyName, KeyClass keyClass);
 
+  /**
+   * Check if sign can be called at the same time from multiple threads. This
+   * is true if the library was built with std::mutex to protect the cache of
+   * decoded private keys.
+   * @return True if sign is thread safe.
+   */
+  virtual bool
+  isSignThreadSafe();
+
 private:
+  /**
+   * A FileStatus holds the fields of the file status which we use to check if
+   * a file has changed. The modification time has nanoseconds so that a
+   * rewrite in the same second is noticed, and the inode changes when a new
+   * file is renamed over the old one.
+   */
+  class FileStatus {
+  public:
+    FileStatus()
+    : modificationTime_(0), modificationNanoseconds_(0), inode_(0), size_(0)
+    {
+    }
+
+    bool
+    equals(const FileStatus& other) const
+    {
+      return modificationTime_ == other.modificationTime_ &&
+             modificationNanoseconds_ == other.modificationNanoseconds_ &&
+             inode_ == other.inode_ && size_ == other.size_;
+    }
+
+    time_t modificationTime_;
+    long modificationNanoseconds_;
+    uint64_t inode_;
+    int64_t size_;
+  };
+
+  /**
+   * A PrivateKey holds a private key decoded from a private key file, along
+   * with the file status so that we can check if the file has changed.
+   */
+  class PrivateKey {
+  public:
+    PrivateKey
+      (KeyType keyType, const std::string& filePath,
+       const FileStatus& fileStatus)
+    : keyType_(keyType), filePath_(filePath), fileStatus_(fileStatus)
+    {
+    }
+
+    const std::string&
+    getFilePath() const { return filePath_; }
+
+    /**
+     * Check if the private key file still has the file status from when it
+     * was decoded.
+     * @param fileStatus The current status of the file.
+     * @return True if the file has not changed.
+     */
+    bool
+    isFileUnchanged(const FileStatus& fileStatus) const
+    {
+      return fileStatus.equals(fileStatus_);
+    }
+
+    KeyType
+    getKeyType() const { return keyType_; }
+
+    RsaPrivateKeyLite&
+    getRsaPrivateKey() { return rsaPrivateKey_; }
+
+    EcPrivateKeyLite&
+    getEcPrivateKey() { return ecPrivateKey_; }
+
+  private:
+    KeyType keyType_;
+    std::string filePath_;
+    FileStatus fileStatus_;
+    RsaPrivateKeyLite rsaPrivateKey_;
+    EcPrivateKeyLite ecPrivateKey_;
+  };
+
+  /**
+   * Get the decoded private key for keyName from privateKeyCache_. If it is
+   * not in the cache or the private key file has changed, read and decode the
+   * file and update the cache.
+   * @param keyName The name of the private key.
+   * @return The decoded private key.
+   * @throws SecurityException if the private key file doesn't exist or can't
+   * be decoded.
+   */
+  ptr_lib::shared_ptr<PrivateKey>
+  getPrivateKey(const Name& keyName);
+
   std::string
   nameTransform(const std::string& keyName, const std::string& extension);
 
@@ -138,6 +240,11 @@ private:
   maintainMapping(const std::string& keyName);
 
   std::string keyStorePath_;
+  // The key is the key name URI.
+  std::map<std::string, ptr_lib::shared_ptr<PrivateKey> > privateKeyCache_;
+#if NDN_CPP_HAVE_STD_THREAD
+  std::mutex privateKeyCacheMutex_;
+#endif
 };
 
 }
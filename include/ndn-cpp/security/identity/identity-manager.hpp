@@ -23,11 +23,15 @@
 #ifndef NDN_IDENTITY_MANAGER_HPP
 #define NDN_IDENTITY_MANAGER_HPP
 
+#include <map>
 #include "../certificate/identity-certificate.hpp"
 #include "../../interest.hpp"
 #include "identity-storage.hpp"
 #include "../certificate/public-key.hpp"
 #include "private-key-storage.hpp"
+#if NDN_CPP_HAVE_STD_THREAD
+#include <mutex>
+#endif
 
 namespace ndn {
 
@@ -309,6 +313,7 @@ public:
   addCertificate(const IdentityCertificate& certificate)
   {
     identityStorage_->addCertificate(certificate);
+    signatureTemplates_.clear();
   }
 
   /**
@@ -433,7 +438,10 @@ public:
   }
 
   /**
-   * Sign data packet based on the certificate name.
+   * Sign data packet based on the certificate name. If the wireFormat is the
+   * default TLV wire format and the signature has the same length as the last
+   * signature by this certificate, this encodes the Data packet only once and
+   * copies the signature bits into the encoding.
    * @param data The Data object to sign and update its signature.
    * @param certificateName The Name identifying the certificate which identifies the signing key.
    * @param wireFormat The WireFormat for calling encodeData, or WireFormat::getDefaultWireFormat() if omitted.
@@ -441,6 +449,30 @@ public:
   void
   signByCertificate(Data& data, const Name& certificateName, WireFormat& wireFormat = *WireFormat::getDefaultWireFormat());
 
+  /**
+   * Sign all the Data packets in the list based on the certificate name, using
+   * multiple threads if the library was built with std::thread and
+   * privateKeyStorage isSignThreadSafe(). This returns when all the packets
+   * are signed. With OpenSSL before 1.1.0, the application must set the
+   * OpenSSL locking callbacks before signing from multiple threads.
+   * @param dataList The list of pointers to the Data objects to sign. This
+   * updates the signature and wire encoding of each. The list must not have
+   * the same Data object twice.
+   * @param certificateName The Name identifying the certificate which
+   * identifies the signing key.
+   * @param nThreads (optional) The number of threads to use. If omitted or
+   * 0, use the number of hardware threads.
+   * @param wireFormat (optional) The WireFormat for calling encodeData, or
+   * WireFormat::getDefaultWireFormat() if omitted.
+   * @throws SecurityException if signing fails for any Data packet. In this
+   * case some of the other packets may already be signed.
+   */
+  void
+  signByCertificate
+    (const std::vector<Data*>& dataList, const Name& certificateName,
+     int nThreads = 0,
+     WireFormat& wireFormat = *WireFormat::getDefaultWireFormat());
+
   /**
    * Append a SignatureInfo to the Interest name, sign the name components and
    * append a final name component with the signature bits.
@@ -514,6 +546,82 @@ private:
   makeSignatureByCertificate
     (const Name& certificateName, DigestAlgorithm& digestAlgorithm);
 
+  /**
+   * Get the Signature object from signatureTemplates_ for the certificate,
+   * creating it if needed. The first time, this calls
+   * privateKeyStorage_->getPublicKey to get the key type and sets the
+   * KeyLocator. signByCertificate(Data) also sets the signature value of the
+   * template to zeros with the length of the last signature so that it can use
+   * the length, without keeping the signature bits of another packet. Methods
+   * which add a key or certificate clear the templates.
+   * @param certificateName The certificate name.
+   * @param digestAlgorithm Set digestAlgorithm to the signature algorithm's
+   * digest algorithm, e.g. DIGEST_ALGORITHM_SHA256.
+   * @return The template Signature object. Do not give it to the application;
+   * use clone() instead.
+   */
+  const ptr_lib::shared_ptr<Signature>&
+  getSignatureTemplate
+    (const Name& certificateName, DigestAlgorithm& digestAlgorithm);
+
+  /**
+   * Set the signature of data to a copy of signatureTemplate, encode, sign and
+   * put the signature bits in the encoding. This only reads this object's
+   * fields, so it can be called from multiple threads if
+   * privateKeyStorage_->isSignThreadSafe().
+   * @param data The Data object to sign.
+   * @param signatureTemplate The Signature from getSignatureTemplate.
+   * @param keyName The name of the signing key.
+   * @param digestAlgorithm The digest algorithm from getSignatureTemplate.
+   * @param wireFormat The WireFormat for calling encodeData.
+   * @return The signature bits.
+   */
+  Blob
+  signWithTemplate
+    (Data& data, const Signature& signatureTemplate, const Name& keyName,
+     DigestAlgorithm digestAlgorithm, WireFormat& wireFormat);
+
+  /**
+   * Set the signature value of the template Signature to zeros of the given
+   * length.
+   * @param signature The Signature from getSignatureTemplate.
+   * @param length The length of the signature value.
+   */
+  static void
+  setPlaceholderSignature(Signature& signature, size_t length);
+
+  /**
+   * Set the signature bits in the Data packet's Signature and make the Data
+   * packet's default wire encoding include them. If the encoding is the default
+   * TLV wire encoding where the SignatureValue is the last field and
+   * signatureBits has the same length as the placeholder signature value, this
+   * copies the encoding with signatureBits in place of the placeholder instead
+   * of encoding the Data packet again. Otherwise, this encodes again.
+   * @param data The Data packet which has the placeholder signature value.
+   * @param encoding The encoding from data.wireEncode(wireFormat) with the
+   * placeholder signature value.
+   * @param signatureBits The signature bits.
+   * @param wireFormat The WireFormat which was used to make the encoding.
+   */
+  static void
+  setSignatureAndEncoding
+    (Data& data, const SignedBlob& encoding, const Blob& signatureBits,
+     WireFormat& wireFormat);
+
+#if NDN_CPP_HAVE_STD_THREAD
+  /**
+   * This is the thread function for signByCertificate(dataList). Sign every
+   * nThreads'th Data packet in dataList, starting at iThread. If signing
+   * throws an exception, set errorMessage if it is not already set and stop.
+   */
+  void
+  signBatchWorker
+    (const std::vector<Data*>* dataList, int iThread, int nThreads,
+     const Signature* signatureTemplate, const Name* keyName,
+     DigestAlgorithm digestAlgorithm, WireFormat* wireFormat,
+     std::string* errorMessage, std::mutex* errorMessageMutex);
+#endif
+
   /**
    * Get the IdentityStorage from the pib value in the configuration file if
    * supplied. Otherwise, get the default for this platform.
@@ -547,6 +655,8 @@ private:
 
   ptr_lib::shared_ptr<IdentityStorage> identityStorage_;
   ptr_lib::shared_ptr<PrivateKeyStorage> privateKeyStorage_;
+  // The key is the certificate name. See getSignatureTemplate.
+  std::map<Name, ptr_lib::shared_ptr<Signature> > signatureTemplates_;
 };
 
 }
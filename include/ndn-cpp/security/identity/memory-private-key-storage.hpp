@@ -193,6 +193,14 @@ public:
   virtual bool
   doesKeyExist(const Name& keyName, KeyClass keyClass);
 
+  /**
+   * Check if sign can be called at the same time from multiple threads. This
+   * returns true because sign only reads the decoded private keys.
+   * @return True.
+   */
+  virtual bool
+  isSignThreadSafe() { return true; }
+
 private:
   /**
    * PrivateKey is a simple class to hold an RSA or EC private key.
@@ -135,6 +135,15 @@ public:
   virtual bool
   doesKeyExist(const Name& keyName, KeyClass keyClass) = 0;
 
+  /**
+   * Check if sign can be called at the same time from multiple threads, for
+   * example by KeyChain::signBatch. The caller must still not modify the keys
+   * (generate, delete, etc.) while signing on other threads.
+   * @return True if sign is thread safe. This base class returns false.
+   */
+  virtual bool
+  isSignThreadSafe() { return false; }
+
   /**
    * Encode the private key to a PKCS #8 private key. We do this explicitly here
    * to avoid linking to extra OpenSSL libraries.
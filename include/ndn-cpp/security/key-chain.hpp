@@ -33,6 +33,7 @@
 namespace ndn {
 
 class PolicyManager;
+class VerifierPool;
 
 /**
  * KeyChain is the main class of the security library.
@@ -322,6 +323,29 @@ public:
     identityManager_->signByCertificate(data, certificateName, wireFormat);
   }
 
+  /**
+   * Wire encode and sign all the Data objects in the list, using multiple
+   * threads if available. This returns when all the packets are signed. See
+   * IdentityManager::signByCertificate(dataList) for details.
+   * @param dataList The list of pointers to the Data objects to sign. This
+   * updates the signature and wire encoding of each.
+   * @param certificateName The certificate name of the key to use for signing.
+   * @param nThreads (optional) The number of threads to use. If omitted or
+   * 0, use the number of hardware threads.
+   * @param wireFormat (optional) A WireFormat object used to encode the input.
+   * If omitted, use WireFormat getDefaultWireFormat().
+   * @throws SecurityException if signing fails for any Data packet.
+   */
+  void
+  signBatch
+    (const std::vector<Data*>& dataList, const Name& certificateName,
+     int nThreads = 0,
+     WireFormat& wireFormat = *WireFormat::getDefaultWireFormat())
+  {
+    identityManager_->signByCertificate
+      (dataList, certificateName, nThreads, wireFormat);
+  }
+
   /**
    * Wire encode the Data object, sign it with the default identity and set its
    * signature.
@@ -475,6 +499,10 @@ public:
    * NOTE: The library will log any exceptions thrown by this callback, but for
    * better error handling the callback should catch and properly handle any
    * exceptions.
+   * If you call setVerifierPool, the policy manager may verify the signature
+   * on a worker thread and call onVerified or onValidationFailed later on the
+   * thread of the Face, so you should call verifyData on the thread of the
+   * Face.
    */
   void
   verifyData
@@ -547,6 +575,40 @@ public:
      const OnVerifyInterestFailed& onVerifyFailed, int stepCount = 0,
      WireFormat& wireFormat = *WireFormat::getDefaultWireFormat());
 
+  /**
+   * Enable a cache of the Data packets which verifyData has verified, so that
+   * verifying a Data packet with the same implicit SHA-256 digest again calls
+   * onVerified without checking the policy and signature. The cache is cleared
+   * when the change count of the policy manager changes, for example when
+   * ConfigPolicyManager::reset() is called or a trust anchor directory is
+   * refreshed. Only successful verifications are cached.
+   * @param maxEntries The maximum number of verified Data packets to remember.
+   * When the cache is full, remove the least recently used entry. If 0, disable
+   * the cache, which is the default.
+   * @param lifetime The number of milliseconds to remember each verified Data
+   * packet.
+   */
+  void
+  setVerifiedDataCache(size_t maxEntries, Milliseconds lifetime);
+
+  /**
+   * Set the VerifierPool which the policy manager uses to verify Data
+   * signatures on worker threads, so that the public-key crypto does not block
+   * the thread of the Face. The policy manager still checks its rules and
+   * finds the certificate on the calling thread. The VerifierPool posts the
+   * result to its Face, which calls onVerified or onValidationFailed. Only a
+   * policy manager such as ConfigPolicyManager which supports it uses the pool.
+   * Signed interests are still verified on the calling thread. With OpenSSL
+   * before 1.1.0, the application must set the OpenSSL locking callbacks
+   * before calling this.
+   * @param verifierPool The VerifierPool, for example
+   * ptr_lib::make_shared<VerifierPool>(face, 4). The KeyChain keeps a pointer
+   * to it, so its Face must remain valid while the KeyChain uses it. If null,
+   * verify on the calling thread, which is the default.
+   */
+  void
+  setVerifierPool(const ptr_lib::shared_ptr<VerifierPool>& verifierPool);
+
   /**
    * Set the Face which will be used to fetch required certificates.
    * @param face A pointer to the Face object.
@@ -620,6 +682,24 @@ public:
   static const RsaKeyParams DEFAULT_KEY_PARAMS;
 
 private:
+  /**
+   * A VerifiedDataCache holds the full names of the Data packets which were
+   * verified. This is defined in the source file.
+   */
+  class VerifiedDataCache;
+
+  /**
+   * This is called by the policy manager when the Data packet is verified. Add
+   * its full name to verifiedDataCache_, then call onVerified(data).
+   * @param policyChangeCount The policy manager's change count when
+   * verification started. If the policy changed since then, don't cache.
+   */
+  void
+  onDataVerified
+    (const ptr_lib::shared_ptr<Data>& data,
+     const ptr_lib::shared_ptr<Name>& fullName, uint64_t policyChangeCount,
+     const OnVerified& onVerified);
+
   void
   onCertificateData
     (const ptr_lib::shared_ptr<const Interest> &interest, const ptr_lib::shared_ptr<Data> &data, ptr_lib::shared_ptr<ValidationRequest> nextStep);
@@ -660,6 +740,8 @@ private:
   ptr_lib::shared_ptr<IdentityManager> identityManager_;
   ptr_lib::shared_ptr<PolicyManager> policyManager_;
   Face* face_;
+  // verifiedDataCache_ is null if the cache is disabled.
+  ptr_lib::shared_ptr<VerifiedDataCache> verifiedDataCache_;
 };
 
 }
@@ -24,27 +24,64 @@
 #ifndef NDN_CERTIFICATE_CACHE_HPP
 #define NDN_CERTIFICATE_CACHE_HPP
 
-#include <map>
+#include <list>
 #include "../certificate/identity-certificate.hpp"
+#if NDN_CPP_HAVE_STD_THREAD
+#include <mutex>
+#endif
 
 namespace ndn {
 
 /**
  * A CertificateCache is used to save other users' certificate during
- * verification.
+ * verification. The cache holds decoded certificates so that getCertificate
+ * doesn't need to decode. When the number of certificates reaches the
+ * capacity, inserting a certificate removes the least recently used one.
+ * Even getCertificate updates the order of use, so each method locks a mutex
+ * (if the library is built with std::mutex) so that multiple threads can use
+ * the cache.
  */
 class CertificateCache {
 public:
+  /**
+   * Create a CertificateCache with the given capacity.
+   * @param capacity (optional) The maximum number of certificates to keep. If
+   * 0, there is no limit. If omitted, use DEFAULT_CAPACITY.
+   */
+  CertificateCache(size_t capacity = DEFAULT_CAPACITY)
+  : capacity_(capacity)
+  {
+  }
+
   /**
    * Insert the certificate into the cache. Assumes the timestamp is not yet
-   * removed from the name.
+   * removed from the name. If the cache is full, remove the least recently
+   * used certificate.
    * @param certificate The certificate to copy and insert.
    */
   void
   insertCertificate(const IdentityCertificate& certificate)
   {
     Name certName = certificate.getName().getPrefix(-1);
-    cache_[certName.toUri()] = certificate.wireEncode();
+    ptr_lib::shared_ptr<const IdentityCertificate> copy
+      (new IdentityCertificate(certificate));
+
+#if NDN_CPP_HAVE_STD_THREAD
+    std::lock_guard<std::mutex> lock(mutex_);
+#endif
+    NameMap<Entry>::type::iterator entry(cache_.find(certName));
+    if (entry != cache_.end()) {
+      entry->second.first = copy;
+      touch(entry->second);
+      return;
+    }
+
+    if (capacity_ > 0 && cache_.size() >= capacity_) {
+      cache_.erase(leastRecentlyUsed_.back());
+      leastRecentlyUsed_.pop_back();
+    }
+    leastRecentlyUsed_.push_front(certName);
+    cache_[certName] = Entry(copy, leastRecentlyUsed_.begin());
   }
 
   /**
@@ -55,31 +92,35 @@ public:
   void
   deleteCertificate(const Name& certificateName)
   {
-    std::map<std::string, Blob>::iterator entry
-      (cache_.find(certificateName.toUri()));
-    if (entry != cache_.end())
+#if NDN_CPP_HAVE_STD_THREAD
+    std::lock_guard<std::mutex> lock(mutex_);
+#endif
+    NameMap<Entry>::type::iterator entry(cache_.find(certificateName));
+    if (entry != cache_.end()) {
+      leastRecentlyUsed_.erase(entry->second.second);
       cache_.erase(entry);
+    }
   }
 
   /**
-   * Fetch a certificate from the cache.
-   * @param certificateName The name of the certificate to remove. Assumes there
+   * Fetch a certificate from the cache and mark it as the most recently used.
+   * @param certificateName The name of the certificate to fetch. Assumes there
    * is no timestamp in the name.
-   * @return A new copy of the IdentityCertificate, or a null shared_ptr if not
-   * found.
+   * @return The cached IdentityCertificate, or a null shared_ptr if not found.
+   * This is shared with the cache, so it is const. To modify it, make a copy.
    */
-  ptr_lib::shared_ptr<IdentityCertificate>
+  ptr_lib::shared_ptr<const IdentityCertificate>
   getCertificate(const Name& certificateName) const
   {
-    std::map<std::string, Blob>::const_iterator entry
-      (cache_.find(certificateName.toUri()));
+#if NDN_CPP_HAVE_STD_THREAD
+    std::lock_guard<std::mutex> lock(mutex_);
+#endif
+    NameMap<Entry>::type::const_iterator entry(cache_.find(certificateName));
     if (entry == cache_.end())
-      return ptr_lib::shared_ptr<IdentityCertificate>();
+      return ptr_lib::shared_ptr<const IdentityCertificate>();
 
-    ptr_lib::shared_ptr<IdentityCertificate> cert(new IdentityCertificate());
-    Blob certData = entry->second;
-    cert->wireDecode(certData);
-    return cert;
+    touch(entry->second);
+    return entry->second.first;
   }
 
   /**
@@ -88,12 +129,60 @@ public:
   void
   reset()
   {
+#if NDN_CPP_HAVE_STD_THREAD
+    std::lock_guard<std::mutex> lock(mutex_);
+#endif
     cache_.clear();
+    leastRecentlyUsed_.clear();
+  }
+
+  /**
+   * Get the number of certificates in the cache.
+   * @return The number of certificates.
+   */
+  size_t
+  size() const
+  {
+#if NDN_CPP_HAVE_STD_THREAD
+    std::lock_guard<std::mutex> lock(mutex_);
+#endif
+    return cache_.size();
   }
 
+  /**
+   * Get the maximum number of certificates to keep.
+   * @return The capacity, or 0 if there is no limit.
+   */
+  size_t
+  getCapacity() const { return capacity_; }
+
+  static const size_t DEFAULT_CAPACITY = 1000;
+
 private:
-  // The key is the certificate name URI. The value is the wire encoding.
-  std::map<std::string, Blob> cache_;
+  // The certificate and its position in leastRecentlyUsed_.
+  typedef std::pair<ptr_lib::shared_ptr<const IdentityCertificate>,
+                    std::list<Name>::iterator> Entry;
+
+  /**
+   * Move the entry to the front of leastRecentlyUsed_. The caller must hold
+   * the lock on mutex_.
+   */
+  void
+  touch(const Entry& entry) const
+  {
+    leastRecentlyUsed_.splice
+      (leastRecentlyUsed_.begin(), leastRecentlyUsed_, entry.second);
+  }
+
+  // The key is the certificate name.
+  NameMap<Entry>::type cache_;
+  // The names in cache_, with the most recently used at the front. This is
+  // mutable so that getCertificate can update it.
+  mutable std::list<Name> leastRecentlyUsed_;
+  size_t capacity_;
+#if NDN_CPP_HAVE_STD_THREAD
+  mutable std::mutex mutex_;
+#endif
 };
 
 }
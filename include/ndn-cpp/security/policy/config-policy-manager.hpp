@@ -35,6 +35,7 @@ class TestVerificationRules_NameRelation_Test;
 class TestVerificationRules_SimpleRegex_Test;
 class TestVerificationRules_Hierarchical_Test;
 class TestVerificationRules_HyperRelation_Test;
+class TestVerificationRules_RuleOrder_Test;
 
 namespace ndn {
 
@@ -99,7 +100,9 @@ public:
   reset();
 
   /**
-   * Call reset() and load the configuration rules from the file.
+   * Call reset() and load the configuration rules from the file. This parses
+   * the names and compiles the regular expressions in the rules once so that
+   * they are not parsed again for each packet.
    * @param configFileName The path to the configuration file containing the
    * verification rules.
    */
@@ -107,7 +110,9 @@ public:
   load(const std::string& configFileName);
 
   /**
-   * Call reset() and load the configuration rules from the input.
+   * Call reset() and load the configuration rules from the input. This parses
+   * the names and compiles the regular expressions in the rules once so that
+   * they are not parsed again for each packet.
    * @param input The contents of the configuration rules, with lines separated
    * by "\n" or "\r\n".
    * @param inputName Used for log messages, etc.
@@ -227,12 +232,30 @@ public:
   virtual Name
   inferSigningIdentity(const Name& dataName);
 
+  /**
+   * Get the change count of this policy, which is incremented by reset() (and
+   * so by load()) and when refreshing a trust anchor directory changes its
+   * certificates.
+   * @return The change count.
+   */
+  virtual uint64_t
+  getChangeCount() const { return changeCount_; }
+
+  /**
+   * Reload each trust anchor directory whose refresh period has passed, and
+   * increment the change count if this changed the trust anchors. This does
+   * no file I/O if no refresh period has passed.
+   */
+  virtual void
+  refresh();
+
 private:
   // Give friend access to the tests.
   friend TestVerificationRules_NameRelation_Test;
   friend TestVerificationRules_SimpleRegex_Test;
   friend TestVerificationRules_Hierarchical_Test;
   friend TestVerificationRules_HyperRelation_Test;
+  friend TestVerificationRules_RuleOrder_Test;
 
   /**
    * TrustAnchorRefreshManager manages the trust-anchor certificates, including
@@ -240,15 +263,17 @@ private:
    */
   class TrustAnchorRefreshManager {
   public:
+    // Use capacity 0 so that the cache never removes a trust anchor.
     TrustAnchorRefreshManager()
+    : certificateCache_(0)
     {
     }
 
     static ptr_lib::shared_ptr<IdentityCertificate>
     loadIdentityCertificateFromFile(const std::string& filename);
 
-    ptr_lib::shared_ptr<IdentityCertificate>
-    getCertificate(Name certificateName) const
+    ptr_lib::shared_ptr<const IdentityCertificate>
+    getCertificate(const Name& certificateName) const
     {
       // Assume the timestamp is already removed.
       return certificateCache_.getCertificate(certificateName);
@@ -257,7 +282,13 @@ private:
     void
     addDirectory(const std::string& directoryName, Milliseconds refreshPeriod);
 
-    void
+    /**
+     * Reload the certificates in each directory whose refresh period has
+     * passed. A directory without a refresh period is not reloaded.
+     * @return True if the reload added, removed or changed a certificate,
+     * false if the certificates are the same or no directory was reloaded.
+     */
+    bool
     refreshAnchors();
 
   private:
@@ -282,6 +313,20 @@ private:
     std::map<std::string, ptr_lib::shared_ptr<DirectoryInfo> > refreshDirectories_;
   };
 
+  /**
+   * A CompiledRule holds a validator/rule from the configuration with its
+   * names parsed and its regular expressions compiled. This is defined in the
+   * source file.
+   */
+  class CompiledRule;
+
+  /**
+   * A RuleSet holds the CompiledRule for each validator/rule in the loaded
+   * configuration, indexed by the name in the rule's first relation filter.
+   * This is defined in the source file.
+   */
+  class RuleSet;
+
   /**
    * The configuration file allows 'trust anchor' certificates to be preloaded.
    * The certificates may also be loaded from a directory, and if the 'refresh'
@@ -310,6 +355,15 @@ private:
     (const Name& signatureName, const Name& objectName, 
      const BoostInfoTree& rule, std::string& failureReason);
 
+  /**
+   * This is the same as checkSignatureMatch for the BoostInfoTree of the rule,
+   * but uses the rule's prebuilt names and regex matchers.
+   */
+  bool
+  checkSignatureMatch
+    (const Name& signatureName, const Name& objectName,
+     const CompiledRule& rule, std::string& failureReason);
+
   /**
    * This looks up certificates specified as base64-encoded data or file names.
    * These are cached by filename or encoding to avoid repeated reading of files
@@ -318,7 +372,7 @@ private:
    * @param isPath
    * @return
    */
-  ptr_lib::shared_ptr<IdentityCertificate>
+  ptr_lib::shared_ptr<const IdentityCertificate>
   lookupCertificate(const std::string& certID, bool isPath);
 
   /**
@@ -333,6 +387,17 @@ private:
   const BoostInfoTree*
   findMatchingRule(const Name& objName, const std::string& matchType) const;
 
+  /**
+   * This is the same as findMatchingRule, but returns the CompiledRule.
+   * @param objName The name to be matched.
+   * @param matchType The rule type to match, "data" or "interest".
+   * @return A pointer to the CompiledRule for the matching rule, or 0 if not
+   * found.
+   */
+  const CompiledRule*
+  findMatchingCompiledRule
+    (const Name& objName, const std::string& matchType) const;
+
   /**
    * Determines if a name satisfies the relation to another name, based on
    * matchRelation.
@@ -407,6 +472,23 @@ private:
     (const Signature* signatureInfo, const SignedBlob& signedBlob,
      std::string& failureReason) const;
 
+  /**
+   * Check the type of signatureInfo to get the KeyLocator and find the public
+   * key of the certificate with the name in the KeyLocator. This is the part
+   * of verify which runs before the signature crypto.
+   * @param signatureInfo An object of a subclass of Signature, e.g.
+   * Sha256WithRsaSignature.
+   * @param publicKeyDer Set this to the DER-encoded public key, or to a null
+   * Blob if the signature has no KeyLocator (such as DigestSha256).
+   * @param failureReason If the public key can't be found, set failureReason
+   * to the failure reason.
+   * @return True if found (or not needed), false if not.
+   */
+  bool
+  findPublicKeyDer
+    (const Signature* signatureInfo, Blob& publicKeyDer,
+     std::string& failureReason) const;
+
   /**
    * This is a helper for checkVerificationPolicy to verify the rule and return
    * a certificate interest to fetch the next certificate in the hierarchy if
@@ -474,14 +556,17 @@ private:
   int maxTrackedKeys_;
   // fixedCertificateCache_ stores the fixed-signer certificate name associated with
   //    validation rules so we don't keep loading from files.
-  std::map<std::string, std::string> fixedCertificateCache_;
+  std::map<std::string, Name> fixedCertificateCache_;
   // keyTimestamps_ stores the timestamps for each public key used in command
   //   interests to avoid replay attacks.
   // key is the public key name, value is the last timestamp.
-  std::map<std::string, MillisecondsSince1970> keyTimestamps_;
+  NameMap<MillisecondsSince1970>::type keyTimestamps_;
   ptr_lib::shared_ptr<BoostInfoParser> config_;
+  // ruleSet_ has the rules of config_, compiled when the configuration is loaded.
+  ptr_lib::shared_ptr<RuleSet> ruleSet_;
   bool requiresVerification_;
   ptr_lib::shared_ptr<TrustAnchorRefreshManager> refreshManager_;
+  uint64_t changeCount_;
 };
 
 }
@@ -29,6 +29,7 @@
 namespace ndn {
 
 class ValidationRequest;
+class VerifierPool;
 
 /**
  * A PolicyManager is an abstract base class to represent the policy for verifying data packets.
@@ -139,10 +140,48 @@ public:
   virtual Name
   inferSigningIdentity(const Name& dataName) = 0;
 
+  /**
+   * Get the change count of this policy, which a subclass increments when its
+   * rules or trust anchors change so that a previous verification result may
+   * no longer be valid. The KeyChain uses this to clear its cache of verified
+   * Data packets.
+   * @return The change count. This base implementation always returns 0.
+   */
+  virtual uint64_t
+  getChangeCount() const { return 0; }
+
+  /**
+   * Update the policy from a source which can change by itself, such as a
+   * trust anchor directory with a refresh period, and increment the change
+   * count if the policy changed. KeyChain.verifyData calls this before it
+   * checks its cache of verified Data packets so that a cached result is not
+   * used after the policy changes.
+   * This base implementation does nothing.
+   */
+  virtual void
+  refresh() {}
+
+  /**
+   * Set the VerifierPool which a subclass such as ConfigPolicyManager can use
+   * to verify signatures on worker threads. KeyChain.setVerifierPool calls
+   * this.
+   * @param verifierPool The VerifierPool, or null to verify on the calling
+   * thread.
+   */
+  void
+  setVerifierPool(const ptr_lib::shared_ptr<VerifierPool>& verifierPool)
+  {
+    verifierPool_ = verifierPool;
+  }
+
 protected:
   /**
    * Check the type of signature and use the publicKeyDer to verify the
-   * signedBlob using the appropriate signature algorithm.
+   * signedBlob using the appropriate signature algorithm. This keeps a bounded
+   * cache of decoded public keys so that a key is only decoded the first time
+   * it is used. This is thread-safe if the library was built with std::thread.
+   * The threads share the decoded keys, so with OpenSSL before 1.1.0 the
+   * application must set the OpenSSL locking callbacks.
    * @param signature An object of a subclass of Signature, e.g.
    * Sha256WithRsaSignature.
    * @param signedBlob the SignedBlob with the signed portion to verify.
@@ -156,6 +195,13 @@ protected:
   verifySignature
     (const Signature* signature, const SignedBlob& signedBlob,
      const Blob& publicKeyDer);
+
+  // verifierPool_ is null if signatures are verified on the calling thread.
+  ptr_lib::shared_ptr<VerifierPool> verifierPool_;
+
+private:
+  // VerifierPool calls verifySignature on its worker threads.
+  friend class VerifierPool;
 };
 
 }
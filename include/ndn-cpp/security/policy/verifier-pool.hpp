@@ -0,0 +1,167 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2017 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+
+#ifndef NDN_VERIFIER_POOL_HPP
+#define NDN_VERIFIER_POOL_HPP
+
+#include <deque>
+#include <string>
+#include <vector>
+#include "../../util/signed-blob.hpp"
+#include "../../signature.hpp"
+#include "../../face.hpp"
+#if NDN_CPP_HAVE_STD_THREAD
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+namespace ndn {
+
+/**
+ * A VerifierPool runs the public-key crypto of signature verification on a
+ * pool of worker threads so that a CPU-bound verification does not block the
+ * thread which processes events for a Face. The result of each verification
+ * is posted back to the thread of the Face with Face.post, so this works with
+ * Face (the thread which calls processEvents) and with ThreadsafeFace (the
+ * ioService thread). To use it, call KeyChain.setVerifierPool. If the library
+ * is not built with std::thread, this verifies on the calling thread but
+ * still posts the result. The worker threads share the decoded public keys.
+ * With OpenSSL before 1.1.0, the application must set the OpenSSL locking
+ * callbacks before creating a VerifierPool.
+ * @note This class is an experimental feature. The API may change.
+ */
+class VerifierPool {
+public:
+  /**
+   * An OnVerifyResult function object is called on the thread of the Face
+   * with the result of verifySignature.
+   * @param isVerified True if the signature verified.
+   * @param errorMessage If verifying threw an exception (such as for a public
+   * key which can't be decoded), this is the error message. Otherwise, this is
+   * "".
+   */
+  typedef func_lib::function<void
+    (bool isVerified, const std::string& errorMessage)> OnVerifyResult;
+
+  /**
+   * Create a VerifierPool and start the worker threads.
+   * @param face The Face whose post method is used to call the OnVerifyResult
+   * callbacks. This does not make a copy, so the Face must remain valid until
+   * the VerifierPool is destroyed.
+   * @param nThreads (optional) The number of worker threads. If omitted or 0,
+   * use the number of hardware threads.
+   */
+  VerifierPool(Face& face, int nThreads = 0);
+
+  /**
+   * Finish verifying the queued signatures, then stop the worker threads.
+   */
+  ~VerifierPool();
+
+  /**
+   * Queue the signature to be verified by a worker thread, which calls
+   * PolicyManager::verifySignature and posts onResult to the Face. The worker
+   * only uses the given objects, so this does not need to copy the signed
+   * packet.
+   * @param signature The Signature to verify. The worker thread reads this, so
+   * you should not modify it. To verify the signature of a packet which may be
+   * modified, pass a clone.
+   * @param signedBlob The SignedBlob with the signed portion to verify.
+   * @param publicKeyDer The DER-encoded public key used to verify the
+   * signature. This may be null if the signature type does not require a
+   * public key.
+   * @param onResult On the thread of the Face, this calls
+   * onResult(isVerified, errorMessage).
+   */
+  void
+  verifySignature
+    (const ptr_lib::shared_ptr<const Signature>& signature,
+     const SignedBlob& signedBlob, const Blob& publicKeyDer,
+     const OnVerifyResult& onResult);
+
+  /**
+   * Get the number of worker threads.
+   * @return The number of worker threads, or 0 if the library is not built
+   * with std::thread.
+   */
+  size_t
+  getThreadCount() const;
+
+private:
+  /**
+   * A Job holds the values given to verifySignature.
+   */
+  class Job {
+  public:
+    Job
+      (const ptr_lib::shared_ptr<const Signature>& signature,
+       const SignedBlob& signedBlob, const Blob& publicKeyDer,
+       const OnVerifyResult& onResult)
+    : signature_(signature), signedBlob_(signedBlob),
+      publicKeyDer_(publicKeyDer), onResult_(onResult)
+    {
+    }
+
+    ptr_lib::shared_ptr<const Signature> signature_;
+    SignedBlob signedBlob_;
+    Blob publicKeyDer_;
+    OnVerifyResult onResult_;
+  };
+
+  /**
+   * Verify the signature of the job and post the result to the Face.
+   */
+  void
+  processJob(const Job& job);
+
+#if NDN_CPP_HAVE_STD_THREAD
+  /**
+   * Each worker thread runs this to process jobs until isStopping_.
+   */
+  void
+  worker();
+#endif
+
+  /**
+   * Don't allow the copy constructor.
+   */
+  VerifierPool(const VerifierPool& other);
+
+  /**
+   * Don't allow the assignment operator.
+   */
+  VerifierPool& operator=(const VerifierPool& other);
+
+  Face& face_;
+#if NDN_CPP_HAVE_STD_THREAD
+  std::deque<Job> jobs_;
+  bool isStopping_;
+  std::mutex jobsMutex_;
+  std::condition_variable jobsCondition_;
+  std::vector<std::thread> threads_;
+#endif
+};
+
+}
+
+#endif
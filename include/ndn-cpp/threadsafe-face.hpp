@@ -197,6 +197,13 @@ public:
   virtual void
   send(const uint8_t *encoding, size_t encodingLength);
 
+  /**
+   * Override to use the ioService given to the constructor to dispatch flush to
+   * be called in a thread-safe manner. See Face.flush for calling details.
+   */
+  virtual void
+  flush();
+
   /**
    * Override to use the ioService given to the constructor to dispatch shutdown
    * to be called in a thread-safe manner. See Face.shutdown for calling details.
@@ -214,6 +221,26 @@ public:
   virtual void
   callLater(Milliseconds delayMilliseconds, const Callback& callback);
 
+  /**
+   * Override to call callback() after the given delay, the same as callLater,
+   * and return a CancellableCall which cancels the basic_deadline_timer. Even
+   * though this is public, it is not part of the public API of Face.
+   * @param delayMilliseconds The delay in milliseconds.
+   * @param callback This calls callback() after the delay.
+   * @return The CancellableCall for the new call.
+   */
+  virtual ptr_lib::shared_ptr<CancellableCall>
+  callLaterCancellable
+    (Milliseconds delayMilliseconds, const Callback& callback);
+
+  /**
+   * Override to use the ioService given to the constructor to post the
+   * callback to the ioService thread.
+   * @param callback This calls callback().
+   */
+  virtual void
+  post(const Callback& callback);
+
 private:
   static ptr_lib::shared_ptr<Transport>
   getDefaultTransport(boost::asio::io_service& ioService);
@@ -110,15 +110,56 @@ public:
      ElementListener& elementListener, const OnConnected& onConnected);
 
   /**
-   * Send data to the host. To be thread-safe, this must be called from a
-   * dispatch to the ioService which was given to the constructor, as is done by
-   * ThreadsafeFace.
+   * Send data to the host. This copies the data to a send queue and does not
+   * wait for the socket to accept it unless the queue is full (see
+   * setSendQueueLimit). To be thread-safe, this must be called from a dispatch
+   * to the ioService which was given to the constructor, as is done by
+   * ThreadsafeFace. If writing the queue on the ioService failed, the socket
+   * is closed and the next call to send throws that error.
    * @param data A pointer to the buffer of data to send.
    * @param dataLength The number of bytes in data.
    */
   virtual void
   send(const uint8_t *data, size_t dataLength);
 
+  /**
+   * Set the limit of the send queue and what send does when the queue is full.
+   * The default is a limit of 1000 packets with SEND_QUEUE_FULL_BLOCK. To be
+   * thread-safe, this must be called from a dispatch to the ioService.
+   * @param maxSendQueueLength The maximum number of packets in the send queue,
+   * or 0 for no limit.
+   * @param sendQueueFullPolicy What send does when the queue is full.
+   * @param onSendQueueFull (optional) If sendQueueFullPolicy is
+   * SEND_QUEUE_FULL_NOTIFY, send calls onSendQueueFull(packet) with each packet
+   * that it drops.
+   */
+  void
+  setSendQueueLimit
+    (size_t maxSendQueueLength, SendQueueFullPolicy sendQueueFullPolicy,
+     const OnSendQueueFull& onSendQueueFull = OnSendQueueFull());
+
+  /**
+   * Get the number of packets which are waiting to be written to the socket.
+   * @return The number of packets in the send queue.
+   */
+  size_t
+  getSendQueueLength() const;
+
+  /**
+   * Get the number of bytes which are waiting to be written to the socket.
+   * @return The number of bytes in the send queue.
+   */
+  size_t
+  getSendQueueBytes() const;
+
+  /**
+   * Get the number of packets which send has dropped because the send queue
+   * was full.
+   * @return The number of dropped packets.
+   */
+  uint64_t
+  getNDroppedPackets() const;
+
   /**
    * Do nothing since the asio io_service reads the socket.
    */
@@ -115,13 +115,30 @@ public:
      ElementListener& elementListener, const OnConnected& onConnected);
 
   /**
-   * Send data to the host
+   * Send data to the host. If this is called from a callback during
+   * processEvents, copy the data to a queue so that all the packets which the
+   * callbacks send are sent together when processEvents returns.
    * @param data A pointer to the buffer of data to send.
    * @param dataLength The number of bytes in data.
    */
   virtual void
   send(const uint8_t *data, size_t dataLength);
 
+  /**
+   * Send the packets to the host in order, using as few
+   * system calls as possible.
+   * @param packets The encoding of each packet.
+   */
+  virtual void
+  sendBatch(const std::vector<Blob>& packets);
+
+  /**
+   * Send the packets which send has queued during processEvents. You only need
+   * to call this to send the queued packets before processEvents returns.
+   */
+  virtual void
+  flush();
+
   /**
    * Process any data to receive.  For each element received, call
    * elementListener.onReceivedElement. This is non-blocking and will return
@@ -134,6 +151,27 @@ public:
   virtual void
   processEvents();
 
+  /**
+   * Wait until there is data ready to receive on the socket, or until
+   * maxWaitMilliseconds, whichever is first. If the socket is not open, only
+   * wait on the wakeupDescriptor, or return immediately if it is also negative.
+   * You should normally not call this directly since it is called by
+   * Face.processEvents(maxWaitMilliseconds).
+   * @param maxWaitMilliseconds The maximum time to wait in milliseconds. A wait
+   * longer than INT_MAX milliseconds is shortened to INT_MAX.
+   * @param wakeupDescriptor If not negative, also stop waiting when this
+   * descriptor is ready to read. If omitted, use -1.
+   */
+  virtual void
+  waitForReceive(Milliseconds maxWaitMilliseconds, int wakeupDescriptor = -1);
+
+  /**
+   * Get the descriptor of the socket.
+   * @return The socket descriptor, or -1 if not connected.
+   */
+  virtual int
+  getSocketDescriptor();
+
   virtual bool
   getIsConnected();
 
@@ -147,6 +185,8 @@ private:
   ptr_lib::shared_ptr<struct ndn_TcpTransport> transport_;
   ptr_lib::shared_ptr<DynamicUInt8Vector> elementBuffer_;
   bool isConnected_;
+  bool isProcessingEvents_;
+  std::vector<Blob> sendQueue_;
   ConnectionInfo connectionInfo_;
   bool isLocal_;
 };
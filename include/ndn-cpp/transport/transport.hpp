@@ -24,6 +24,7 @@
 
 #include <vector>
 #include "../common.hpp"
+#include "../util/blob.hpp"
 
 namespace ndn {
 
@@ -46,6 +47,21 @@ public:
 
   typedef func_lib::function<void()> OnConnected;
 
+  /**
+   * A SendQueueFullPolicy says what an async transport does when send is
+   * called and its queue of packets waiting to be written is full.
+   */
+  enum SendQueueFullPolicy {
+    /** Block until the socket accepts all the queued packets. */
+    SEND_QUEUE_FULL_BLOCK = 0,
+    /** Drop the packet. */
+    SEND_QUEUE_FULL_DROP = 1,
+    /** Drop the packet and call the OnSendQueueFull callback with it. */
+    SEND_QUEUE_FULL_NOTIFY = 2
+  };
+
+  typedef func_lib::function<void(const Blob& packet)> OnSendQueueFull;
+
   /**
    * Determine whether this transport connecting according to connectionInfo is
    * to a node on the current machine. This affects the processing of
@@ -94,6 +110,23 @@ public:
     send(&data[0], data.size());
   }
 
+  /**
+   * Send the packets to the host in order. This base class implementation
+   * calls send for each packet, but your derived class can override to send
+   * the batch with fewer system calls.
+   * @param packets The encoding of each packet.
+   */
+  virtual void
+  sendBatch(const std::vector<Blob>& packets);
+
+  /**
+   * Send any packets which the transport has queued to send together. This
+   * base class implementation does nothing, but your derived class can
+   * override if its send method queues packets.
+   */
+  virtual void
+  flush();
+
   /**
    * Process any data to receive.  For each element received, call
    * elementListener.onReceivedElement. This is non-blocking and will return
@@ -106,6 +139,30 @@ public:
   virtual void
   processEvents() = 0;
 
+  /**
+   * Wait until there is data ready to receive, or until maxWaitMilliseconds,
+   * whichever is first. This does not call processEvents. This base class
+   * implementation returns immediately, but your derived class can override
+   * to wait on its connection. You should normally not call this directly
+   * since it is called by Face.processEvents(maxWaitMilliseconds).
+   * @param maxWaitMilliseconds The maximum time to wait in milliseconds.
+   * @param wakeupDescriptor If not negative, also stop waiting when this
+   * descriptor is ready to read. Face.processEvents uses this so that
+   * Face.post from another thread ends the wait. If omitted, use -1.
+   */
+  virtual void
+  waitForReceive(Milliseconds maxWaitMilliseconds, int wakeupDescriptor = -1);
+
+  /**
+   * Get the descriptor of the socket which processEvents() receives from, so
+   * that an event loop such as FaceReactor can wait on it. This base class
+   * implementation returns -1, but your derived class can override.
+   * @return The socket descriptor, or -1 if the transport has no socket or is
+   * not connected.
+   */
+  virtual int
+  getSocketDescriptor();
+
   virtual bool
   getIsConnected();
 
@@ -56,7 +56,7 @@ public:
    */
   Blob(const uint8_t* value, size_t valueLength)
   : ptr_lib::shared_ptr<const std::vector<uint8_t> >
-      (value ? new std::vector<uint8_t>(value, value + valueLength) : 0)
+      (makeVector(value, valueLength))
   {
   }
 
@@ -67,7 +67,8 @@ public:
    * @param value A reference to a vector which is copied.
    */
   Blob(const std::vector<uint8_t> &value)
-  : ptr_lib::shared_ptr<const std::vector<uint8_t> >(new std::vector<uint8_t>(value))
+  : ptr_lib::shared_ptr<const std::vector<uint8_t> >
+      (ptr_lib::make_shared<std::vector<uint8_t> >(value))
   {
   }
 
@@ -78,9 +79,7 @@ public:
    */
   Blob(const struct ndn_Blob& blobStruct)
   : ptr_lib::shared_ptr<const std::vector<uint8_t> >
-      (blobStruct.value ?
-        new std::vector<uint8_t>(blobStruct.value, blobStruct.value + blobStruct.length)
-        : 0)
+      (makeVector(blobStruct.value, blobStruct.length))
   {
   }
 
@@ -91,8 +90,7 @@ public:
    */
   Blob(const BlobLite& blobLite)
   : ptr_lib::shared_ptr<const std::vector<uint8_t> >
-      (blobLite.isNull() ? 0
-        : new std::vector<uint8_t>(blobLite.buf(), blobLite.buf() + blobLite.size()))
+      (makeVector(blobLite.buf(), blobLite.size()))
   {
   }
 
@@ -118,13 +116,13 @@ public:
      ((const ptr_lib::shared_ptr<const std::vector<uint8_t> > &)value)
   {
     if (copy)
-      this->reset(new std::vector<uint8_t>(*value));
+      *this = Blob(*value);
   }
   Blob(const ptr_lib::shared_ptr<const std::vector<uint8_t> > &value, bool copy)
   : ptr_lib::shared_ptr<const std::vector<uint8_t> >(value)
   {
     if (copy)
-      this->reset(new std::vector<uint8_t>(*value));
+      *this = Blob(*value);
   }
 
   /**
@@ -240,6 +238,26 @@ public:
     else
       return BlobLite();
   }
+
+private:
+  /**
+   * Make a new vector with a copy of the array. This uses make_shared so that
+   * the vector and the shared_ptr reference count are in one allocation,
+   * which matters when decoding a packet makes a Blob for every field.
+   * @param value A pointer to the byte array which is copied. However, if value
+   * is 0 then return a null pointer.
+   * @param valueLength The length of value.
+   * @return The new vector, or a null pointer if value is 0.
+   */
+  static ptr_lib::shared_ptr<const std::vector<uint8_t> >
+  makeVector(const uint8_t* value, size_t valueLength)
+  {
+    if (value)
+      return ptr_lib::make_shared<std::vector<uint8_t> >
+        (value, value + valueLength);
+    else
+      return ptr_lib::shared_ptr<const std::vector<uint8_t> >();
+  }
 };
 
 inline std::ostream&
@@ -0,0 +1,211 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2017 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+#ifndef NDN_MAPPED_CONTENT_STORE_HPP
+#define NDN_MAPPED_CONTENT_STORE_HPP
+
+#include <string>
+#include <vector>
+#include "blob.hpp"
+
+namespace ndn {
+
+/**
+ * A MappedContentStore holds wire-encoded Data packets in a memory-mapped file
+ * so that a MemoryContentCache in each of several processes on the same host
+ * can share one copy of the content, and so that the content is still
+ * available when a process restarts. To use it, pass it to the
+ * MemoryContentCache constructor.
+ *
+ * The file is a circular log of records with a fixed capacity. When there is
+ * no more room, appending a record overwrites the oldest records. Each record
+ * is identified by its position, which is the total number of bytes which
+ * were appended to the log before it, so that a position is never reused.
+ * Each process locks the file with fcntl while reading or writing. Because
+ * fcntl locks do not exclude threads of the same process, you should only use
+ * a MappedContentStore on the thread which calls processEvents.
+ * The mapped pages are not synced to disk after each write, so a system crash
+ * can leave a record partly written. If the header of the log or of a record
+ * is not valid, the log is reset to empty so that the records are lost but
+ * the file can still be used.
+ * This is only supported on platforms with mmap.
+ * @note This class is an experimental feature. The API may change.
+ */
+class MappedContentStore {
+public:
+  /**
+   * A Record holds a copy of one record from readNewRecords.
+   */
+  class Record {
+  public:
+    Record
+      (uint64_t position, MillisecondsSince1970 addTime, const Blob& encoding)
+    : position(position), addTime(addTime), encoding(encoding)
+    {
+    }
+
+    uint64_t position;
+    MillisecondsSince1970 addTime;
+    Blob encoding;
+  };
+
+  /**
+   * Open the file, creating it if it doesn't exist.
+   * @param filePath The path of the file to memory-map.
+   * @param capacityBytes The size in bytes of the circular log, used only if
+   * this creates the file. If the file exists, use its capacity.
+   * @throws std::runtime_error if the file can't be opened or mapped, or if an
+   * existing file is not a MappedContentStore.
+   */
+  MappedContentStore(const std::string& filePath, size_t capacityBytes);
+
+  ~MappedContentStore();
+
+  /**
+   * Append a record with the wire encoding to the log, overwriting the oldest
+   * records if needed.
+   * @param encoding The wire encoding of the Data packet.
+   * @param encodingLength The length of the encoding.
+   * @param addTime The time when the Data packet was added in milliseconds
+   * since 1970, as returned by ndn_getNowMilliseconds.
+   * @return The position of the new record.
+   * @throws std::runtime_error if the encoding is empty or does not fit in the
+   * capacity.
+   */
+  uint64_t
+  append
+    (const uint8_t* encoding, size_t encodingLength,
+     MillisecondsSince1970 addTime);
+
+  /**
+   * Copy the wire encoding of the record at the position.
+   * @param position The position from append or readNewRecords.
+   * @param encoding Set this to a copy of the encoding.
+   * @return True for success, or false if the record was overwritten.
+   */
+  bool
+  read(uint64_t position, Blob& encoding);
+
+  /**
+   * Append to records a copy of each record which was appended to the log (by
+   * any process) from the position to the end of the log, then set position
+   * to the end of the log for the next call. If position is before the oldest
+   * record, start from the oldest record.
+   * @param position The position to start from. To read all the records, use
+   * 0. This is updated to the position after the last record which was read.
+   * @param records Append each Record to this vector.
+   * @param maxBytes (optional) If not 0, stop after the record which makes the
+   * total size of the encodings read at least maxBytes, and leave position at
+   * the next record so that the next call continues from it. If omitted or 0,
+   * read to the end of the log.
+   * @return The position of the oldest record. Records at an earlier position
+   * have been overwritten.
+   */
+  uint64_t
+  readNewRecords
+    (uint64_t& position, std::vector<Record>& records, size_t maxBytes = 0);
+
+  /**
+   * Get the capacity of the circular log.
+   * @return The capacity in bytes.
+   */
+  size_t
+  getCapacity() const;
+
+private:
+  class Header;
+  class RecordHeader;
+  class FileLock;
+
+  /**
+   * Get the record header at the position.
+   */
+  RecordHeader*
+  getRecordHeader(uint64_t position) const;
+
+  /**
+   * Do the work of readNewRecords while holding the read lock.
+   * @return True for success, or false if the log is corrupted.
+   */
+  bool
+  readNewRecordsLocked
+    (uint64_t& position, std::vector<Record>& records, size_t maxBytes);
+
+  /**
+   * Advance the position of the oldest record until the log has room to write
+   * up to endPosition. If a record header is not valid, reset the log. This
+   * must be called while holding the write lock.
+   */
+  void
+  makeRoom(uint64_t endPosition);
+
+  /**
+   * Check that the positions in the file header are consistent.
+   */
+  bool
+  isValidHeader() const;
+
+  /**
+   * Check that the record at the position is within the log and that its
+   * lengths are consistent. This assumes that the file header is valid.
+   */
+  bool
+  isValidRecord(uint64_t position, const RecordHeader& record) const;
+
+  /**
+   * Check the file header and every record from the oldest to the end.
+   */
+  bool
+  isValidLog() const;
+
+  /**
+   * Remove all the records, keeping the positions increasing. This must be
+   * called while holding the write lock.
+   */
+  void
+  resetLog();
+
+  /**
+   * Get the write lock and reset the log if it is still not valid.
+   */
+  void
+  repairLog();
+
+  /**
+   * Don't allow the copy constructor.
+   */
+  MappedContentStore(const MappedContentStore& other);
+
+  /**
+   * Don't allow the assignment operator.
+   */
+  MappedContentStore& operator=(const MappedContentStore& other);
+
+  int fd_;
+  uint8_t* map_;
+  size_t mapLength_;
+  Header* header_;
+  uint8_t* log_;
+};
+
+}
+
+#endif
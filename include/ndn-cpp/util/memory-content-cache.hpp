@@ -23,8 +23,9 @@
 #define NDN_MEMORY_CONTENT_CACHE_HPP
 
 #include <map>
-#include <deque>
+#include <queue>
 #include "../face.hpp"
+#include "mapped-content-store.hpp"
 
 namespace ndn {
 
@@ -32,11 +33,33 @@ namespace ndn {
  * A MemoryContentCache holds a set of Data packets and answers an Interest to
  * return the correct Data packet. The cache is periodically cleaned up to
  * remove each stale Data packet based on its FreshnessPeriod (if it has one).
+ * If you call setContentLimits, the cache also evicts Data packets according
+ * to the eviction policy to stay within the limits.
  * @note This class is an experimental feature.  See the API docs for more detail at
  * http://named-data.net/doc/ndn-ccl-api/memory-content-cache.html .
  */
 class MemoryContentCache {
 public:
+  /**
+   * An EvictionPolicy selects which content to remove when the cache exceeds
+   * the limits given to setContentLimits.
+   */
+  enum EvictionPolicy {
+    /** Remove the least recently used content. */
+    LRU = 0,
+    /**
+     * Remove the least frequently used content. Among content with the same
+     * use count, remove the least recently used.
+     */
+    LFU = 1,
+    /**
+     * Use the CLOCK approximation of LRU. Remove the oldest content, but give
+     * content which was used since it was last checked a second chance. A hit
+     * only sets a flag, which is cheaper than updating the LRU order.
+     */
+    CLOCK = 2
+  };
+
   /**
    * Create a new MemoryContentCache to use the given Face.
    * @param face The Face to use to call registerPrefix and setInterestFilter,
@@ -48,7 +71,36 @@ public:
    */
   MemoryContentCache
     (Face* face, Milliseconds cleanupIntervalMilliseconds = 1000.0)
-  : impl_(new Impl(face, cleanupIntervalMilliseconds))
+  : impl_(new Impl
+      (face, cleanupIntervalMilliseconds,
+       ptr_lib::shared_ptr<MappedContentStore>()))
+  {
+    impl_->initialize();
+  }
+
+  /**
+   * Create a new MemoryContentCache to use the given Face, which keeps the
+   * wire encoding of the Data packets in the contentStore instead of in
+   * memory. The MemoryContentCache objects in other processes which use the
+   * same file for their MappedContentStore share the content, so that an
+   * interest can be answered with a Data packet which another process added.
+   * The content which is already in the contentStore is available right away,
+   * so that a restarted process has a warm cache. The cache only keeps the
+   * name index in memory, and checks the contentStore for new content when it
+   * receives an interest or adds content. Content which is overwritten in the
+   * circular log of the contentStore is removed from the cache, and passed to
+   * the OnContentRemoved callback.
+   * @param face The Face to use to call registerPrefix and setInterestFilter,
+   * and which will call this object's OnInterest callback.
+   * @param contentStore The MappedContentStore for the Data packets.
+   * @param cleanupIntervalMilliseconds (optional) The interval in milliseconds
+   * between each check to clean up stale content in the cache. If omitted,
+   * use a default of 1000 milliseconds.
+   */
+  MemoryContentCache
+    (Face* face, const ptr_lib::shared_ptr<MappedContentStore>& contentStore,
+     Milliseconds cleanupIntervalMilliseconds = 1000.0)
+  : impl_(new Impl(face, cleanupIntervalMilliseconds, contentStore))
   {
     impl_->initialize();
   }
@@ -131,6 +183,16 @@ public:
     : name_(data.getName()), dataEncoding_(data.wireEncode())
     {}
 
+    /**
+     * Create a new Content entry with the given name and wire encoding.
+     * @param name The content Name, which is copied.
+     * @param dataEncoding The encoded Data packet, or a null Blob if the
+     * encoding is in a MappedContentStore.
+     */
+    Content(const Name& name, const Blob& dataEncoding)
+    : name_(name), dataEncoding_(dataEncoding)
+    {}
+
     /**
      * Get the content Name.
      * @return The content Name.
@@ -140,7 +202,9 @@ public:
 
     /**
      * Get the encoded content Data packet.
-     * @return The encoded content Blob.
+     * @return The encoded content Blob. If the MemoryContentCache uses a
+     * MappedContentStore, this is a null Blob because the encoding is in the
+     * store.
      */
     const Blob&
     getDataEncoding() const { return dataEncoding_; }
@@ -311,15 +375,16 @@ public:
 
   /**
    * Add the Data packet to the cache so that it is available to use to
-   * answer interests. If data.getMetaInfo().getFreshnessPeriod() is not
-   * negative, set the staleness time to now plus
-   * data.getMetaInfo().getFreshnessPeriod(), which is checked during cleanup to
-   * remove stale content. This also checks if cleanupIntervalMilliseconds
-   * milliseconds have passed and removes stale content from the cache. After
-   * removing stale content, remove timed-out pending interests from
-   * storePendingInterest(), then if the added Data packet satisfies any
-   * interest, send it through the transport and remove the interest from the
-   * pending interest table.
+   * answer interests. If the cache already has a Data packet with the same
+   * name, this replaces it without calling the OnContentRemoved callback. If
+   * data.getMetaInfo().getFreshnessPeriod() is not negative, set the staleness
+   * time to now plus data.getMetaInfo().getFreshnessPeriod(), which is checked
+   * during cleanup to remove stale content. This also checks if
+   * cleanupIntervalMilliseconds milliseconds have passed and removes stale
+   * content from the cache. After removing stale content, remove timed-out
+   * pending interests from storePendingInterest(), then if the added Data
+   * packet satisfies any interest, send it through the transport and remove
+   * the interest from the pending interest table.
    * Because this modifies the internal tables, you should call this on the same
    * thread as processEvents, which can also modify the tables.
    * @param data The Data packet object to put in the cache. This copies the
@@ -398,11 +463,75 @@ public:
     impl_->getPendingInterestsWithPrefix(prefix, pendingInterests);
   }
 
+  /**
+   * Set limits on the size of the cache. When add() makes the cache exceed a
+   * limit, remove content according to the eviction policy (see
+   * setEvictionPolicy) until the cache is within the limits, and call the
+   * OnContentRemoved callback (see setOnContentRemoved) with the evicted
+   * content. This never evicts the Data packet which add() just added, so one
+   * Data packet larger than maxBytes stays in the cache until it is replaced.
+   * If the cache already exceeds the new limits, this evicts content now.
+   * @param maxEntries The maximum number of Data packets in the cache, or 0 for
+   * no limit.
+   * @param maxBytes The maximum total size in bytes of the wire encoding of
+   * the Data packets in the cache, or 0 for no limit.
+   */
+  void
+  setContentLimits(size_t maxEntries, size_t maxBytes)
+  {
+    impl_->setContentLimits(maxEntries, maxBytes);
+  }
+
+  /**
+   * Set the policy to select which content to evict when the cache exceeds the
+   * limits given to setContentLimits. If you don't call this, use LRU.
+   * @param evictionPolicy The EvictionPolicy.
+   */
+  void
+  setEvictionPolicy(EvictionPolicy evictionPolicy)
+  {
+    impl_->setEvictionPolicy(evictionPolicy);
+  }
+
+  /**
+   * Get the number of interests which onInterest answered from the cache.
+   * @return The number of cache hits.
+   */
+  uint64_t
+  getNHits() const { return impl_->getNHits(); }
+
+  /**
+   * Get the number of interests for which onInterest did not find a Data
+   * packet in the cache.
+   * @return The number of cache misses.
+   */
+  uint64_t
+  getNMisses() const { return impl_->getNMisses(); }
+
+  /**
+   * Get the number of Data packets which were evicted to stay within the
+   * limits given to setContentLimits. This does not count stale content.
+   * @return The number of evictions.
+   */
+  uint64_t
+  getNEvictions() const { return impl_->getNEvictions(); }
+
+  /**
+   * Get the total size in bytes of the wire encoding of the Data packets in
+   * the cache.
+   * @return The number of bytes.
+   */
+  size_t
+  getNContentBytes() const { return impl_->getNContentBytes(); }
+
   /**
    * Set the OnContentRemoved callback to call when stale content is removed
-   * from the cache during cleanup. Note: Because onContentRemoved is called
-   * while processing incoming Interests, it should return quickly to allow the
-   * Interest to be processed quickly.
+   * from the cache during cleanup, when content is evicted to stay within
+   * the limits given to setContentLimits, or when content is overwritten in
+   * the MappedContentStore. This is not called when add() replaces content
+   * which has the same name, since the name is still in the cache. Note:
+   * Because onContentRemoved is called while processing incoming Interests, it
+   * should return quickly to allow the Interest to be processed quickly.
    * @param onContentRemoved This calls onContentRemoved(contentList) where
    * contentList is the list of MemoryContentCache::Content objects that were
    * removed, where each Content has the Name and encoding of the removed
@@ -427,7 +556,9 @@ private:
      * call initialize().  See the MemoryContentCache constructor for parameter
      * documentation.
      */
-    Impl(Face* face, Milliseconds cleanupIntervalMilliseconds);
+    Impl
+      (Face* face, Milliseconds cleanupIntervalMilliseconds,
+       const ptr_lib::shared_ptr<MappedContentStore>& contentStore);
 
     /**
      * Complete the work of the constructor. This is needed because we can't
@@ -480,13 +611,34 @@ private:
       onContentRemoved_ = onContentRemoved;
     }
 
+    void
+    setContentLimits(size_t maxEntries, size_t maxBytes);
+
+    void
+    setEvictionPolicy(EvictionPolicy evictionPolicy);
+
+    uint64_t
+    getNHits() const { return nHits_; }
+
+    uint64_t
+    getNMisses() const { return nMisses_; }
+
+    uint64_t
+    getNEvictions() const { return nEvictions_; }
+
+    size_t
+    getNContentBytes() const { return nContentBytes_; }
+
     /**
      * This is the OnInterestCallback which is called when the library receives
      * an interest whose name has the prefix given to registerPrefix. First
      * check if cleanupIntervalMilliseconds milliseconds have passed and remove
      * stale content from the cache. Then search the cache for the Data packet,
      * matching any interest selectors including ChildSelector, and send the
-     * Data packet to the transport. If no matching Data packet is in the cache,
+     * Data packet to the transport. Since contentByName_ is sorted in NDN
+     * canonical order, this only searches the range of names which have the
+     * interest name as a prefix, forward for the leftmost child or backward
+     * for the rightmost child. If no matching Data packet is in the cache,
      * call the callback in onDataNotFoundForPrefix_ (if defined).
      */
     void
@@ -497,6 +649,8 @@ private:
        const ptr_lib::shared_ptr<const InterestFilter>& filter);
 
   private:
+    class PendingInterestIndex;
+
     /**
      * StaleTimeContent extends Content to include the staleTimeMilliseconds
      * for when this entry should be cleaned up from the cache.
@@ -511,6 +665,19 @@ private:
        */
       StaleTimeContent(const Data& data);
 
+      /**
+       * Create a new StaleTimeContent with the name and a null encoding for
+       * content which is in the MappedContentStore.
+       * @param name The content Name, which is copied.
+       * @param staleTimeMilliseconds The time when the content becomes stale
+       * in milliseconds according to ndn_getNowMilliseconds.
+       */
+      StaleTimeContent
+        (const Name& name, MillisecondsSince1970 staleTimeMilliseconds)
+      : Content(name, Blob()), staleTimeMilliseconds_(staleTimeMilliseconds)
+      {
+      }
+
       /**
        * Check if this content is stale.
        * @param nowMilliseconds The current time in milliseconds from
@@ -525,6 +692,8 @@ private:
 
       /**
        * Compare shared_ptrs to Content based only on staleTimeMilliseconds_.
+       * This is "greater than" so that a priority_queue puts the content which
+       * goes stale first at the top.
        */
       class Compare {
       public:
@@ -533,7 +702,7 @@ private:
           (const ptr_lib::shared_ptr<const StaleTimeContent>& x,
            const ptr_lib::shared_ptr<const StaleTimeContent>& y) const
         {
-          return x->staleTimeMilliseconds_ < y->staleTimeMilliseconds_;
+          return x->staleTimeMilliseconds_ > y->staleTimeMilliseconds_;
         }
       };
 
@@ -542,12 +711,129 @@ private:
         becomse stale in milliseconds according to ndn_getNowMilliseconds */
     };
 
+    /**
+     * The key in evictionOrder_, where the first key is evicted first. The
+     * first value is the use count for LFU, otherwise 0. The second value is
+     * from evictionSequence_ which increases for each new key.
+     */
+    typedef std::pair<uint64_t, uint64_t> EvictionKey;
+
+    /**
+     * An Entry is the value in contentByName_ which holds the content and
+     * its state for the eviction policy.
+     */
+    class Entry {
+    public:
+      Entry
+        (const ptr_lib::shared_ptr<const Content>& content, size_t nBytes,
+         uint64_t storePosition)
+      : content_(content), nBytes_(nBytes), storePosition_(storePosition),
+        useCount_(0), isReferenced_(true)
+      {
+      }
+
+      ptr_lib::shared_ptr<const Content> content_;
+      size_t nBytes_; /**< The size of the wire encoding. */
+      uint64_t storePosition_; /**< The position in contentStore_, if used. */
+      EvictionKey evictionKey_;
+      uint64_t useCount_;
+      bool isReferenced_; /**< For CLOCK, true if used since last checked. */
+    };
+
+    typedef std::map<Name, Entry> ContentMap;
+    typedef std::map<EvictionKey, ContentMap::iterator> EvictionMap;
+
+    /**
+     * Add the content to contentByName_, replacing any content with the same
+     * name, then evict content if the cache exceeds the limits. If the content
+     * is a StaleTimeContent, the caller should also add it to staleTimeHeap_.
+     * @param content The Content.
+     * @param nBytes The size of the wire encoding.
+     * @param storePosition The position in contentStore_, if used.
+     */
+    void
+    addContent
+      (const ptr_lib::shared_ptr<const Content>& content, size_t nBytes,
+       uint64_t storePosition);
+
+    /**
+     * Add the content which was appended to contentStore_ (by any process)
+     * since the last call, and remove the content which was overwritten. If
+     * onContentRemoved_ is defined, this calls it with the overwritten content.
+     */
+    void
+    syncContentStore();
+
+    /**
+     * Remove the entry whose content was overwritten in contentStore_.
+     * @param entry The iterator in contentByName_.
+     * @param contentList If onContentRemoved_ is defined, add the removed
+     * content to this list, first creating it if it is null.
+     */
+    void
+    removeOverwrittenEntry
+      (ContentMap::iterator entry, ptr_lib::shared_ptr<ContentList>& contentList);
+
+    /**
+     * Get the wire encoding of the entry's content, reading from contentStore_
+     * if used.
+     * @param entry The iterator in contentByName_.
+     * @param encoding Set this to the encoding.
+     * @return True for success, or false if the content was overwritten in
+     * contentStore_.
+     */
+    bool
+    getDataEncoding(ContentMap::iterator entry, Blob& encoding);
+
+    /**
+     * Set the entry's evictionKey_ based on evictionPolicy_ and add it to
+     * evictionOrder_ as the last entry for its use count.
+     * @param entry The iterator in contentByName_.
+     */
+    void
+    addEvictionKey(ContentMap::iterator entry);
+
+    /**
+     * Update the entry's state for the eviction policy when onInterest sends
+     * its content.
+     * @param entry The iterator in contentByName_.
+     */
+    void
+    onContentUsed(ContentMap::iterator entry);
+
+    /**
+     * Remove the entry from contentByName_, evictionOrder_ and
+     * entryByStorePosition_, and update nContentBytes_.
+     * @param entry The iterator in contentByName_.
+     */
+    void
+    removeEntry(ContentMap::iterator entry);
+
+    /**
+     * Evict content according to evictionPolicy_ until the cache is within
+     * maxEntries_ and maxBytes_.
+     * @param keep Don't evict this entry, or contentByName_.end() for none.
+     * @param contentList If onContentRemoved_ is defined, add the evicted
+     * content to this list, first creating it if it is null.
+     */
+    void
+    evictContent
+      (ContentMap::iterator keep, ptr_lib::shared_ptr<ContentList>& contentList);
+
+    /**
+     * If onContentRemoved_ and contentList are defined, call
+     * onContentRemoved_(contentList), logging any exception.
+     * @param contentList The removed content, or null for none.
+     */
+    void
+    callOnContentRemoved(const ptr_lib::shared_ptr<ContentList>& contentList);
+
     /**
      * Check if now is greater than nextCleanupTime_ and, if so, remove stale
-     * content from staleTimeCache_ and reset nextCleanupTime_ based on
-     * cleanupIntervalMilliseconds_. Since add(Data) does a sorted insert into
-     * staleTimeCache_, the check for stale data is quick and does not require
-     * searching the entire staleTimeCache_. If onContentRemoved_ is defined,
+     * content from contentByName_ and reset nextCleanupTime_ based on
+     * cleanupIntervalMilliseconds_. Since staleTimeHeap_ has the content which
+     * goes stale first at the top, the check for stale data is quick and does
+     * not require searching the entire cache. If onContentRemoved_ is defined,
      * this calls onContentRemoved_(content) for the removed content.
      */
     void
@@ -571,18 +857,37 @@ private:
     Face* face_;
     Milliseconds cleanupIntervalMilliseconds_;
     MillisecondsSince1970 nextCleanupTime_;
-    std::map<std::string, OnInterestCallback> onDataNotFoundForPrefix_; /**< The map key is the prefix.toUri() */
+    NameMap<OnInterestCallback>::type onDataNotFoundForPrefix_; /**< The map key is the prefix. */
     std::vector<uint64_t> interestFilterIdList_;
     std::vector<uint64_t> registeredPrefixIdList_;
-    std::vector<ptr_lib::shared_ptr<const Content> > noStaleTimeCache_;
-    // Use a deque so we can efficiently remove from the front.
-    std::deque<ptr_lib::shared_ptr<const StaleTimeContent> > staleTimeCache_;
-    StaleTimeContent::Compare contentCompare_;
-    Name::Component emptyComponent_;
-    std::vector<ptr_lib::shared_ptr<const PendingInterest> > pendingInterestTable_;
+    // The content sorted by name in NDN canonical order, so that all the names
+    // with a given prefix are in one range.
+    ContentMap contentByName_;
+    // The content with a FreshnessPeriod, where the top goes stale first. This
+    // may still have content which was evicted, or replaced in contentByName_
+    // by content with the same name.
+    std::priority_queue
+      <ptr_lib::shared_ptr<const StaleTimeContent>,
+       std::vector<ptr_lib::shared_ptr<const StaleTimeContent> >,
+       StaleTimeContent::Compare> staleTimeHeap_;
+    ptr_lib::shared_ptr<PendingInterestIndex> pendingInterestIndex_;
     OnInterestCallback storePendingInterestCallback_;
     OnContentRemoved onContentRemoved_;
     bool isDoingCleanup_;
+    EvictionMap evictionOrder_;
+    uint64_t evictionSequence_;
+    EvictionPolicy evictionPolicy_;
+    size_t maxEntries_;
+    size_t maxBytes_;
+    size_t nContentBytes_;
+    uint64_t nHits_;
+    uint64_t nMisses_;
+    uint64_t nEvictions_;
+    ptr_lib::shared_ptr<MappedContentStore> contentStore_;
+    // The position in contentStore_ for the next call to syncContentStore.
+    uint64_t storeReadPosition_;
+    // The key is the position in contentStore_ of the entry's content.
+    std::map<uint64_t, ContentMap::iterator> entryByStorePosition_;
   };
 
   ndn::ptr_lib::shared_ptr<Impl> impl_;
@@ -79,6 +79,28 @@ static __inline void ndn_ElementReader_reset
 ndn_Error ndn_ElementReader_onReceivedData
   (struct ndn_ElementReader *self, const uint8_t *data, size_t dataLength);
 
+/**
+ * Call (*elementListener->onReceivedElement)(element, elementLength) for each
+ * whole element in the datagram. Unlike ndn_ElementReader_onReceivedData, an
+ * element is never continued in the next datagram, so if the datagram ends
+ * in the middle of an element then drop it. Since a datagram normally holds
+ * whole elements, this does not copy the data.
+ * @param self pointer to the ndn_ElementReader struct
+ * @param data pointer to the buffer with the datagram
+ * @param dataLength length of data
+ * @return 0 for success, else an error code
+ */
+static __inline ndn_Error ndn_ElementReader_onReceivedDatagram
+  (struct ndn_ElementReader *self, const uint8_t *data, size_t dataLength)
+{
+  ndn_Error error = ndn_ElementReader_onReceivedData(self, data, dataLength);
+  if (self->usePartialData) {
+    self->usePartialData = 0;
+    ndn_TlvStructureDecoder_reset(&self->tlvStructureDecoder);
+  }
+  return error;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -27,6 +27,7 @@
 #include "tlv/tlv-lp-packet.h"
 #include "tlv/tlv-delegation-set.h"
 #include "tlv/tlv-encrypted-content.h"
+#include "../util/ndn_memory.h"
 #include "tlv-0_2-wire-format.h"
 
 ndn_Error
@@ -64,12 +65,19 @@ ndn_Tlv0_2WireFormat_encodeInterest
 {
   ndn_Error error;
   struct ndn_TlvEncoder encoder;
+  size_t beginFromBack, endFromBack;
   ndn_TlvEncoder_initialize(&encoder, output);
-  error = ndn_encodeTlvInterest
-    (interest, signedPortionBeginOffset, signedPortionEndOffset, &encoder);
+  // Prepend at the back of the output so that each nested length is known
+  // when it is written, then move the encoding to the front.
+  if ((error = ndn_prependTlvInterest(interest, &beginFromBack, &endFromBack, &encoder)))
+    return error;
+  ndn_memmove
+    (output->array, ndn_TlvEncoder_getPrependedArray(&encoder), encoder.offset);
+  *signedPortionBeginOffset = encoder.offset - beginFromBack;
+  *signedPortionEndOffset = encoder.offset - endFromBack;
   *encodingLength = encoder.offset;
 
-  return error;
+  return NDN_ERROR_success;
 }
 
 ndn_Error
@@ -91,12 +99,19 @@ ndn_Tlv0_2WireFormat_encodeData
 {
   ndn_Error error;
   struct ndn_TlvEncoder encoder;
+  size_t beginFromBack, endFromBack;
   ndn_TlvEncoder_initialize(&encoder, output);
-  error = ndn_encodeTlvData
-    (data, signedPortionBeginOffset, signedPortionEndOffset, &encoder);
+  // Prepend at the back of the output so that each nested length is known
+  // when it is written, then move the encoding to the front.
+  if ((error = ndn_prependTlvData(data, &beginFromBack, &endFromBack, &encoder)))
+    return error;
+  ndn_memmove
+    (output->array, ndn_TlvEncoder_getPrependedArray(&encoder), encoder.offset);
+  *signedPortionBeginOffset = encoder.offset - beginFromBack;
+  *signedPortionEndOffset = encoder.offset - endFromBack;
   *encodingLength = encoder.offset;
 
-  return error;
+  return NDN_ERROR_success;
 }
 
 ndn_Error
@@ -24,30 +24,46 @@
 #include "tlv-data.h"
 
 /**
- * This private function is called by ndn_TlvEncoder_writeNestedTlv to write the TLVs in the body of the MetaInfo value.
- * @param context This is the ndn_MetaInfo struct pointer which was passed to writeTlv.
- * @param encoder the ndn_TlvEncoder which is calling this.
+ * Prepend the encoding of the MetaInfo. The TLVs are prepended in reverse
+ * order.
+ * @param metaInfo A pointer to the ndn_MetaInfo struct to encode.
+ * @param encoder the ndn_TlvEncoder which receives the encoding.
  * @return 0 for success, else an error code.
  */
 static ndn_Error
-encodeMetaInfoValue(const void *context, struct ndn_TlvEncoder *encoder)
+prependMetaInfo
+  (const struct ndn_MetaInfo *metaInfo, struct ndn_TlvEncoder *encoder)
 {
-  struct ndn_MetaInfo *metaInfo = (struct ndn_MetaInfo *)context;
-
+  size_t saveOffset = encoder->offset;
   ndn_Error error;
 
+  if (metaInfo->finalBlockId.value.value &&
+      metaInfo->finalBlockId.value.length > 0) {
+    // The FinalBlockId has an inner NameComponent.
+    size_t finalBlockIdSaveOffset = encoder->offset;
+    if ((error = ndn_prependTlvNameComponent(&metaInfo->finalBlockId, encoder)))
+      return error;
+    if ((error = ndn_TlvEncoder_prependTypeAndLength
+         (encoder, ndn_Tlv_FinalBlockId,
+          encoder->offset - finalBlockIdSaveOffset)))
+      return error;
+  }
+  if ((error = ndn_TlvEncoder_prependOptionalNonNegativeIntegerTlvFromDouble
+      (encoder, ndn_Tlv_FreshnessPeriod, metaInfo->freshnessPeriod)))
+    return error;
+
   if (!((int)metaInfo->type < 0 || metaInfo->type == ndn_ContentType_BLOB)) {
     // Not the default, so we need to encode the type.
     if (metaInfo->type == ndn_ContentType_LINK ||
         metaInfo->type == ndn_ContentType_KEY ||
         metaInfo->type == ndn_ContentType_NACK) {
       // The ContentType enum is set up with the correct integer for each NDN-TLV ContentType.
-      if ((error = ndn_TlvEncoder_writeNonNegativeIntegerTlv
+      if ((error = ndn_TlvEncoder_prependNonNegativeIntegerTlv
           (encoder, ndn_Tlv_ContentType, metaInfo->type)))
         return error;
     }
     else if (metaInfo->type == ndn_ContentType_OTHER_CODE) {
-      if ((error = ndn_TlvEncoder_writeNonNegativeIntegerTlv
+      if ((error = ndn_TlvEncoder_prependNonNegativeIntegerTlv
           (encoder, ndn_Tlv_ContentType, metaInfo->otherTypeCode)))
         return error;
     }
@@ -56,78 +72,41 @@ encodeMetaInfoValue(const void *context, struct ndn_TlvEncoder *encoder)
       return NDN_ERROR_unrecognized_ndn_ContentType;
   }
 
-  if ((error = ndn_TlvEncoder_writeOptionalNonNegativeIntegerTlvFromDouble
-      (encoder, ndn_Tlv_FreshnessPeriod, metaInfo->freshnessPeriod)))
-    return error;
-  if (metaInfo->finalBlockId.value.value &&
-      metaInfo->finalBlockId.value.length > 0) {
-    // The FinalBlockId has an inner NameComponent.
-    if ((error = ndn_TlvEncoder_writeTypeAndLength
-         (encoder, ndn_Tlv_FinalBlockId, ndn_TlvEncoder_sizeOfBlobTlv
-            (metaInfo->finalBlockId.type, &metaInfo->finalBlockId.value))))
-      return error;
-    if ((error = ndn_encodeTlvNameComponent(&metaInfo->finalBlockId, encoder)))
-      return error;
-  }
-
-  return NDN_ERROR_success;
+  return ndn_TlvEncoder_prependTypeAndLength
+    (encoder, ndn_Tlv_MetaInfo, encoder->offset - saveOffset);
 }
 
-/* An DataValueContext is for passing the context to encodeDataValue so that we can include
- * signedPortionBeginOffset and signedPortionEndOffset.
- */
-struct DataValueContext {
-  const struct ndn_Data *data;
-  size_t *signedPortionBeginOffset;
-  size_t *signedPortionEndOffset;
-};
-
-/**
- * This private function is called by ndn_TlvEncoder_writeNestedTlv to write the TLVs in the body of the Data value.
- * @param context This is the DataValueContext struct pointer which was passed to writeTlv.
- * @param encoder the ndn_TlvEncoder which is calling this.
- * @return 0 for success, else an error code.
- */
-static ndn_Error
-encodeDataValue(const void *context, struct ndn_TlvEncoder *encoder)
+ndn_Error
+ndn_prependTlvData
+  (const struct ndn_Data *data, size_t *signedPortionBeginOffset,
+   size_t *signedPortionEndOffset, struct ndn_TlvEncoder *encoder)
 {
-  const struct DataValueContext *dataValueContext = (const struct DataValueContext *)context;
-  const struct ndn_Data *data = dataValueContext->data;
+  size_t saveOffset = encoder->offset;
   ndn_Error error;
   size_t dummyBeginOffset, dummyEndOffset;
 
-  *dataValueContext->signedPortionBeginOffset = encoder->offset;
-
-  if ((error = ndn_encodeTlvName
-       (&data->name, &dummyBeginOffset, &dummyEndOffset, encoder)))
+  // Prepend the TLVs in reverse order.
+  if ((error = ndn_TlvEncoder_prependBlobTlv
+       (encoder, ndn_Tlv_SignatureValue, &data->signature.signature)))
     return error;
-  if ((error = ndn_TlvEncoder_writeNestedTlv(encoder, ndn_Tlv_MetaInfo, encodeMetaInfoValue, &data->metaInfo, 0)))
+
+  *signedPortionEndOffset = encoder->offset;
+
+  if ((error = ndn_prependTlvSignatureInfo(&data->signature, encoder)))
     return error;
-  if ((error = ndn_TlvEncoder_writeBlobTlv(encoder, ndn_Tlv_Content, &data->content)))
+  if ((error = ndn_TlvEncoder_prependBlobTlv
+       (encoder, ndn_Tlv_Content, &data->content)))
     return error;
-  if ((error = ndn_encodeTlvSignatureInfo(&data->signature, encoder)))
+  if ((error = prependMetaInfo(&data->metaInfo, encoder)))
     return error;
-
-  *dataValueContext->signedPortionEndOffset = encoder->offset;
-
-  if ((error = ndn_TlvEncoder_writeBlobTlv(encoder, ndn_Tlv_SignatureValue, &data->signature.signature)))
+  if ((error = ndn_prependTlvName
+       (&data->name, &dummyBeginOffset, &dummyEndOffset, encoder)))
     return error;
 
-  return NDN_ERROR_success;
-}
-
-ndn_Error
-ndn_encodeTlvData
-  (const struct ndn_Data *data, size_t *signedPortionBeginOffset,
-   size_t *signedPortionEndOffset, struct ndn_TlvEncoder *encoder)
-{
-  // Create the context to pass to encodeDataValue.
-  struct DataValueContext dataValueContext;
-  dataValueContext.data = data;
-  dataValueContext.signedPortionBeginOffset = signedPortionBeginOffset;
-  dataValueContext.signedPortionEndOffset = signedPortionEndOffset;
+  *signedPortionBeginOffset = encoder->offset;
 
-  return ndn_TlvEncoder_writeNestedTlv(encoder, ndn_Tlv_Data, encodeDataValue, &dataValueContext, 0);
+  return ndn_TlvEncoder_prependTypeAndLength
+    (encoder, ndn_Tlv_Data, encoder->offset - saveOffset);
 }
 
 static ndn_Error
@@ -30,17 +30,22 @@ extern "C" {
 #endif
 
 /**
- * Encode the data packet as NDN-TLV.
+ * Prepend the encoding of the data packet as NDN-TLV. This computes each
+ * length while encoding so that nested TLVs are written only once.
  * @param data Pointer to the data object to encode.
- * @param signedPortionBeginOffset Return the offset in the encoding of the beginning of the signed portion.
+ * @param signedPortionBeginOffset Return the offset of the beginning of the
+ * signed portion as the number of bytes from the back of the output (like
+ * encoder->offset).
  * If you are not encoding in order to sign, you can ignore this returned value.
- * @param signedPortionEndOffset Return the offset in the encoding of the end of the signed portion.
+ * @param signedPortionEndOffset Return the offset of the end of the signed
+ * portion as the number of bytes from the back of the output.
  * If you are not encoding in order to sign, you can ignore this returned value.
- * @param encoder Pointer to the ndn_TlvEncoder struct which receives the encoding.
+ * @param encoder Pointer to the ndn_TlvEncoder struct which receives the
+ * encoding.
  * @return 0 for success, else an error code.
  */
 ndn_Error
-ndn_encodeTlvData
+ndn_prependTlvData
   (const struct ndn_Data *data, size_t *signedPortionBeginOffset,
    size_t *signedPortionEndOffset, struct ndn_TlvEncoder *encoder);
 
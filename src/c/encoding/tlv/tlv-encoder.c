@@ -246,3 +246,88 @@ ndn_TlvEncoder_writeNestedTlv
 
   return NDN_ERROR_success;
 }
+
+/**
+ * Make room for length more bytes in front of the bytes already prepended to
+ * the output and advance self->offset.
+ * @param self A pointer to the ndn_TlvEncoder struct.
+ * @param length The number of bytes to prepend.
+ * @param front Set front to point to the new first byte of the encoding.
+ * @return 0 for success, else an error code.
+ */
+static ndn_Error
+prependSpace(struct ndn_TlvEncoder *self, size_t length, uint8_t **front)
+{
+  ndn_Error error;
+  if ((error = ndn_DynamicUInt8Array_ensureLengthFromBack
+       (self->output, self->offset + length)))
+    return error;
+
+  self->offset += length;
+  *front = ndn_TlvEncoder_getPrependedArray(self);
+  return NDN_ERROR_success;
+}
+
+/**
+ * Write value to p as a big endian integer in nBytes bytes.
+ */
+static void
+writeBigEndian(uint8_t *p, uint64_t value, size_t nBytes)
+{
+  while (nBytes > 0) {
+    p[--nBytes] = value & 0xff;
+    value >>= 8;
+  }
+}
+
+ndn_Error
+ndn_TlvEncoder_prependArray
+  (struct ndn_TlvEncoder *self, const uint8_t *array, size_t arrayLength)
+{
+  ndn_Error error;
+  uint8_t *front;
+  if ((error = prependSpace(self, arrayLength, &front)))
+    return error;
+
+  if (arrayLength > 0)
+    ndn_memcpy(front, array, arrayLength);
+  return NDN_ERROR_success;
+}
+
+ndn_Error
+ndn_TlvEncoder_prependVarNumber(struct ndn_TlvEncoder *self, uint64_t varNumber)
+{
+  ndn_Error error;
+  uint8_t *front;
+  size_t size = ndn_TlvEncoder_sizeOfVarNumber(varNumber);
+  if ((error = prependSpace(self, size, &front)))
+    return error;
+
+  if (size == 1)
+    *front = (uint8_t)varNumber;
+  else {
+    if (size == 3)
+      *front = 253;
+    else if (size == 5)
+      *front = 254;
+    else
+      *front = 255;
+    writeBigEndian(front + 1, varNumber, size - 1);
+  }
+
+  return NDN_ERROR_success;
+}
+
+ndn_Error
+ndn_TlvEncoder_prependNonNegativeInteger
+  (struct ndn_TlvEncoder *self, uint64_t value)
+{
+  ndn_Error error;
+  uint8_t *front;
+  size_t size = ndn_TlvEncoder_sizeOfNonNegativeInteger(value);
+  if ((error = prependSpace(self, size, &front)))
+    return error;
+
+  writeBigEndian(front, value, size);
+  return NDN_ERROR_success;
+}
@@ -35,10 +35,14 @@ extern "C" {
 /** An ndn_TlvEncoder struct is used by all the TLV encoding functions.  You should initialize it with
  * ndn_TlvEncoder_initialize.  You can set enableOutput to 0 to only advance self->offset without writing to output
  * as a way to pre-compute the length of child elements.
+ * The ndn_TlvEncoder_prepend functions instead encode from back to front at the
+ * back of output, so that the length of each element is known when its type and
+ * length are written. When using these, offset is the number of bytes already
+ * written at the back of output.array, and enableOutput is ignored.
  */
 struct ndn_TlvEncoder {
   struct ndn_DynamicUInt8Array *output; /**< A pointer to a ndn_DynamicUInt8Array which receives the encoded output. */
-  size_t offset;                        /**< The offset into output.array for the next encoding. */
+  size_t offset;                        /**< The offset into output.array for the next encoding, or the offset from the back when prepending. */
   int enableOutput;                     /**< If 0, then only advance offset without writing to output. */
 };
 
@@ -375,6 +379,160 @@ ndn_TlvEncoder_writeNestedTlv
    ndn_Error (*writeValue)(const void *context, struct ndn_TlvEncoder *encoder),
    const void *context, int omitZeroLength);
 
+/**
+ * Get a pointer to the front of the bytes which were prepended to the output.
+ * @param self A pointer to the ndn_TlvEncoder struct.
+ * @return A pointer to the front of the encoding, which has self->offset bytes.
+ */
+static __inline uint8_t *
+ndn_TlvEncoder_getPrependedArray(struct ndn_TlvEncoder *self)
+{
+  return self->output->array + (self->output->length - self->offset);
+}
+
+/**
+ * Copy the array to the output in front of the bytes which were already
+ * prepended, and advance self->offset. Note that this does not encode a type
+ * and length; for that see prependBlobTlv.
+ * @param self pointer to the ndn_TlvEncoder struct.
+ * @param array the array to copy.
+ * @param arrayLength the length of the array.
+ * @return 0 for success, else an error code.
+ */
+ndn_Error
+ndn_TlvEncoder_prependArray
+  (struct ndn_TlvEncoder *self, const uint8_t *array, size_t arrayLength);
+
+/**
+ * Encode varNumber as a VAR-NUMBER in NDN-TLV and prepend it to the output.
+ * @param self A pointer to the ndn_TlvEncoder struct.
+ * @param varNumber The number to encode.
+ * @return 0 for success, else an error code.
+ */
+ndn_Error
+ndn_TlvEncoder_prependVarNumber(struct ndn_TlvEncoder *self, uint64_t varNumber);
+
+/**
+ * Prepend the type and length to the output. Call this after prepending the
+ * value, when the length is known.
+ * @param self A pointer to the ndn_TlvEncoder struct.
+ * @param type the type of the TLV.
+ * @param length The length of the TLV.
+ * @return 0 for success, else an error code.
+ */
+static __inline ndn_Error
+ndn_TlvEncoder_prependTypeAndLength
+  (struct ndn_TlvEncoder *self, unsigned int type, size_t length)
+{
+  ndn_Error error;
+  if ((error = ndn_TlvEncoder_prependVarNumber(self, (uint64_t)length)))
+    return error;
+  return ndn_TlvEncoder_prependVarNumber(self, (uint64_t)type);
+}
+
+/**
+ * Encode value as a non-negative integer in NDN-TLV and prepend it to the
+ * output. This does not write a type or length for the value.
+ * @param self A pointer to the ndn_TlvEncoder struct.
+ * @param value The integer to encode.
+ * @return 0 for success, else an error code.
+ */
+ndn_Error
+ndn_TlvEncoder_prependNonNegativeInteger
+  (struct ndn_TlvEncoder *self, uint64_t value);
+
+/**
+ * Prepend the type, then the length of the blob then the blob value to the
+ * output.
+ * @param self A pointer to the ndn_TlvEncoder struct.
+ * @param type the type of the TLV.
+ * @param value A Blob with the array of bytes for the value.
+ * @return 0 for success, else an error code.
+ */
+static __inline ndn_Error
+ndn_TlvEncoder_prependBlobTlv
+  (struct ndn_TlvEncoder *self, unsigned int type, const struct ndn_Blob *value)
+{
+  ndn_Error error;
+  if ((error = ndn_TlvEncoder_prependArray(self, value->value, value->length)))
+    return error;
+  return ndn_TlvEncoder_prependTypeAndLength(self, type, value->length);
+}
+
+/**
+ * If value or valueLen is 0 then do nothing, otherwise call
+ * ndn_TlvEncoder_prependBlobTlv.
+ * @param self A pointer to the ndn_TlvEncoder struct.
+ * @param type the type of the TLV.
+ * @param value A Blob with the array of bytes for the value.
+ * @return 0 for success, else an error code.
+ */
+static __inline ndn_Error
+ndn_TlvEncoder_prependOptionalBlobTlv
+  (struct ndn_TlvEncoder *self, unsigned int type, const struct ndn_Blob *value)
+{
+  if (value->value && value->length > 0)
+    return ndn_TlvEncoder_prependBlobTlv(self, type, value);
+  else
+    return NDN_ERROR_success;
+}
+
+/**
+ * Prepend the type, then the length of the encoded value then encode value as
+ * a non-negative integer.
+ * @param self A pointer to the ndn_TlvEncoder struct.
+ * @param type the type of the TLV.
+ * @param value The integer to encode.
+ * @return 0 for success, else an error code.
+ */
+static __inline ndn_Error
+ndn_TlvEncoder_prependNonNegativeIntegerTlv
+  (struct ndn_TlvEncoder *self, unsigned int type, uint64_t value)
+{
+  ndn_Error error;
+  if ((error = ndn_TlvEncoder_prependNonNegativeInteger(self, value)))
+    return error;
+  return ndn_TlvEncoder_prependTypeAndLength
+    (self, type, ndn_TlvEncoder_sizeOfNonNegativeInteger(value));
+}
+
+/**
+ * If value is negative then do nothing, otherwise call
+ * ndn_TlvEncoder_prependNonNegativeIntegerTlv.
+ * @param self A pointer to the ndn_TlvEncoder struct.
+ * @param type the type of the TLV.
+ * @param value Negative for none, otherwise use (uint64_t)value.
+ * @return 0 for success, else an error code.
+ */
+static __inline ndn_Error
+ndn_TlvEncoder_prependOptionalNonNegativeIntegerTlv
+  (struct ndn_TlvEncoder *self, unsigned int type, int value)
+{
+  if (value >= 0)
+    return ndn_TlvEncoder_prependNonNegativeIntegerTlv(self, type, (uint64_t)value);
+  else
+    return NDN_ERROR_success;
+}
+
+/**
+ * If value is negative then do nothing, otherwise round value to uint64_t and
+ * call ndn_TlvEncoder_prependNonNegativeIntegerTlv.
+ * @param self A pointer to the ndn_TlvEncoder struct.
+ * @param type the type of the TLV.
+ * @param value Negative for none, otherwise use (uint64_t)round(value).
+ * @return 0 for success, else an error code.
+ */
+static __inline ndn_Error
+ndn_TlvEncoder_prependOptionalNonNegativeIntegerTlvFromDouble
+  (struct ndn_TlvEncoder *self, unsigned int type, double value)
+{
+  if (value >= 0.0)
+    return ndn_TlvEncoder_prependNonNegativeIntegerTlv
+      (self, type, (uint64_t)round(value));
+  else
+    return NDN_ERROR_success;
+}
+
 #ifdef  __cplusplus
 }
 #endif
@@ -25,165 +25,153 @@
 #include "tlv-interest.h"
 
 /**
- * This private function is called by ndn_TlvEncoder_writeNestedTlv to write the TLVs in the body of the Exclude value.
- * @param context This is the ndn_Exclude struct pointer which was passed to writeTlv.
- * @param encoder the ndn_TlvEncoder which is calling this.
+ * Get the 4-byte Nonce to encode for the interest. If the interest nonce is
+ * shorter than 4 bytes, generate or pad with random bytes in nonceBuffer. If it
+ * is longer, truncate to 4 bytes.
+ * @param interest A pointer to the ndn_Interest struct with the nonce.
+ * @param nonceBuffer A buffer of 4 bytes for a random or padded nonce.
+ * @param nonceBlob Set this to the 4-byte nonce, which may point into
+ * nonceBuffer or interest->nonce.
  * @return 0 for success, else an error code.
  */
 static ndn_Error
-encodeExcludeValue(const void *context, struct ndn_TlvEncoder *encoder)
+getNonceBlob
+  (const struct ndn_Interest *interest, uint8_t *nonceBuffer,
+   struct ndn_Blob *nonceBlob)
 {
-  struct ndn_Exclude *exclude = (struct ndn_Exclude *)context;
-
-  // TODO: Do we want to order the components (except for ANY)?
   ndn_Error error;
-  size_t i;
-  for (i = 0; i < exclude->nEntries; ++i) {
-    struct ndn_ExcludeEntry *entry = &exclude->entries[i];
 
-    if (entry->type == ndn_Exclude_COMPONENT) {
-      if ((error = ndn_encodeTlvNameComponent(&entry->component, encoder)))
-        return error;
-    }
-    else if (entry->type == ndn_Exclude_ANY) {
-      if ((error = ndn_TlvEncoder_writeTypeAndLength(encoder, ndn_Tlv_Any, 0)))
-        return error;
-    }
-    else
-      return NDN_ERROR_unrecognized_ndn_ExcludeType;
+  nonceBlob->length = 4;
+  if (interest->nonce.length == 0) {
+    // Generate a random nonce.
+    if ((error = ndn_generateRandomBytes(nonceBuffer, 4)))
+      return error;
+    nonceBlob->value = nonceBuffer;
+  }
+  else if (interest->nonce.length < 4) {
+    // TLV encoding requires 4 bytes, so pad out to 4 using random bytes.
+    ndn_memcpy(nonceBuffer, interest->nonce.value, interest->nonce.length);
+    if ((error = ndn_generateRandomBytes
+         (nonceBuffer + interest->nonce.length, 4 - interest->nonce.length)))
+      return error;
+    nonceBlob->value = nonceBuffer;
   }
+  else
+    // TLV encoding requires 4 bytes, so truncate to 4.
+    nonceBlob->value = interest->nonce.value;
 
   return NDN_ERROR_success;
 }
 
 /**
- * This private function is called by ndn_TlvEncoder_writeNestedTlv to write the TLVs in the body of the Selectors value.
- * @param context This is the ndn_Interest struct pointer which was passed to writeTlv.
- * @param encoder the ndn_TlvEncoder which is calling this.
+ * Prepend the encoding of the Selectors, or nothing if all the selectors are
+ * omitted. The TLVs are prepended in reverse order.
+ * @param interest A pointer to the ndn_Interest struct with the selectors.
+ * @param encoder the ndn_TlvEncoder which receives the encoding.
  * @return 0 for success, else an error code.
  */
 static ndn_Error
-encodeSelectorsValue(const void *context, struct ndn_TlvEncoder *encoder)
+prependSelectors
+  (const struct ndn_Interest *interest, struct ndn_TlvEncoder *encoder)
 {
-  struct ndn_Interest *interest = (struct ndn_Interest *)context;
+  size_t saveOffset = encoder->offset;
   ndn_Error error;
 
-  if ((error = ndn_TlvEncoder_writeOptionalNonNegativeIntegerTlv
-      (encoder, ndn_Tlv_MinSuffixComponents, interest->minSuffixComponents)))
-    return error;
-  if ((error = ndn_TlvEncoder_writeOptionalNonNegativeIntegerTlv
-      (encoder, ndn_Tlv_MaxSuffixComponents, interest->maxSuffixComponents)))
-    return error;
+  if (interest->mustBeFresh) {
+    if ((error = ndn_TlvEncoder_prependTypeAndLength
+         (encoder, ndn_Tlv_MustBeFresh, 0)))
+      return error;
+  }
+  // else MustBeFresh == false, so nothing to encode.
 
-  if ((error = ndn_TlvEncoder_writeNestedTlv
-       (encoder, ndn_Tlv_PublisherPublicKeyLocator, ndn_encodeTlvKeyLocatorValue,
-        &interest->keyLocator, 1)))
+  if ((error = ndn_TlvEncoder_prependOptionalNonNegativeIntegerTlv
+      (encoder, ndn_Tlv_ChildSelector, interest->childSelector)))
     return error;
 
   if (interest->exclude.nEntries > 0) {
-    if ((error = ndn_TlvEncoder_writeNestedTlv(encoder, ndn_Tlv_Exclude, encodeExcludeValue, &interest->exclude, 0)))
+    size_t excludeSaveOffset = encoder->offset;
+    size_t i;
+    for (i = interest->exclude.nEntries; i > 0; --i) {
+      const struct ndn_ExcludeEntry *entry = &interest->exclude.entries[i - 1];
+
+      if (entry->type == ndn_Exclude_COMPONENT) {
+        if ((error = ndn_prependTlvNameComponent(&entry->component, encoder)))
+          return error;
+      }
+      else if (entry->type == ndn_Exclude_ANY) {
+        if ((error = ndn_TlvEncoder_prependTypeAndLength
+             (encoder, ndn_Tlv_Any, 0)))
+          return error;
+      }
+      else
+        return NDN_ERROR_unrecognized_ndn_ExcludeType;
+    }
+
+    if ((error = ndn_TlvEncoder_prependTypeAndLength
+         (encoder, ndn_Tlv_Exclude, encoder->offset - excludeSaveOffset)))
       return error;
   }
 
-  if ((error = ndn_TlvEncoder_writeOptionalNonNegativeIntegerTlv
-      (encoder, ndn_Tlv_ChildSelector, interest->childSelector)))
+  if ((error = ndn_prependTlvKeyLocator
+       (ndn_Tlv_PublisherPublicKeyLocator, &interest->keyLocator, 1, encoder)))
     return error;
 
-  if (interest->mustBeFresh) {
-    if ((error = ndn_TlvEncoder_writeTypeAndLength(encoder, ndn_Tlv_MustBeFresh, 0)))
-      return error;
-  }
-  // else MustBeFresh == false, so nothing to encode.
+  if ((error = ndn_TlvEncoder_prependOptionalNonNegativeIntegerTlv
+      (encoder, ndn_Tlv_MaxSuffixComponents, interest->maxSuffixComponents)))
+    return error;
+  if ((error = ndn_TlvEncoder_prependOptionalNonNegativeIntegerTlv
+      (encoder, ndn_Tlv_MinSuffixComponents, interest->minSuffixComponents)))
+    return error;
 
-  return NDN_ERROR_success;
-}
+  if (encoder->offset == saveOffset)
+    // Omit the empty Selectors.
+    return NDN_ERROR_success;
 
-/* An InterestValueContext is for passing the context to encodeInterestValue so
- *   that we can include signedPortionBeginOffset and signedPortionEndOffset.
- */
-struct InterestValueContext {
-  const struct ndn_Interest *interest;
-  size_t *signedPortionBeginOffset;
-  size_t *signedPortionEndOffset;
-};
+  return ndn_TlvEncoder_prependTypeAndLength
+    (encoder, ndn_Tlv_Selectors, encoder->offset - saveOffset);
+}
 
-/**
- * This private function is called by ndn_TlvEncoder_writeNestedTlv to write the TLVs in the body of the Interest value.
- * @param context This is the InterestValueContext struct pointer which was passed to writeTlv.
- * @param encoder the ndn_TlvEncoder which is calling this.
- * @return 0 for success, else an error code.
- */
-static ndn_Error
-encodeInterestValue(const void *context, struct ndn_TlvEncoder *encoder)
+ndn_Error
+ndn_prependTlvInterest
+  (const struct ndn_Interest *interest, size_t *signedPortionBeginOffset,
+   size_t *signedPortionEndOffset, struct ndn_TlvEncoder *encoder)
 {
-  const struct InterestValueContext *interestValueContext =
-    (const struct InterestValueContext *)context;
-  const struct ndn_Interest *interest = interestValueContext->interest;
+  size_t saveOffset = encoder->offset;
   ndn_Error error;
   uint8_t nonceBuffer[4];
   struct ndn_Blob nonceBlob;
 
-  if ((error = ndn_encodeTlvName
-       (&interest->name, interestValueContext->signedPortionBeginOffset,
-        interestValueContext->signedPortionEndOffset, encoder)))
-    return error;
-  // For Selectors, set omitZeroLength true.
-  if ((error = ndn_TlvEncoder_writeNestedTlv(encoder, ndn_Tlv_Selectors, encodeSelectorsValue, interest, 1)))
+  // Prepend the TLVs in reverse order.
+  if ((error = ndn_TlvEncoder_prependOptionalNonNegativeIntegerTlv
+      (encoder, ndn_Tlv_SelectedDelegation, interest->selectedDelegationIndex)))
     return error;
-
-  // Encode the Nonce as 4 bytes.
-  nonceBlob.length = sizeof(nonceBuffer);
-  if (interest->nonce.length == 0) {
-    // Generate a random nonce.
-    if ((error = ndn_generateRandomBytes(nonceBuffer, sizeof(nonceBuffer))))
-      return error;
-    nonceBlob.value = nonceBuffer;
-  }
-  else if (interest->nonce.length < 4) {
-    // TLV encoding requires 4 bytes, so pad out to 4 using random bytes.
-    ndn_memcpy(nonceBuffer, interest->nonce.value, interest->nonce.length);
-    if ((error = ndn_generateRandomBytes
-         (nonceBuffer + interest->nonce.length,
-          sizeof(nonceBuffer) - interest->nonce.length)))
+  if (interest->linkWireEncoding.value) {
+    // Encode the entire link as is.
+    if ((error = ndn_TlvEncoder_prependArray
+        (encoder, interest->linkWireEncoding.value,
+         interest->linkWireEncoding.length)))
       return error;
-    nonceBlob.value = nonceBuffer;
   }
-  else
-    // TLV encoding requires 4 bytes, so truncate to 4.
-    nonceBlob.value = interest->nonce.value;
-  if ((error = ndn_TlvEncoder_writeBlobTlv(encoder, ndn_Tlv_Nonce, &nonceBlob)))
-    return error;
 
-  if ((error = ndn_TlvEncoder_writeOptionalNonNegativeIntegerTlvFromDouble
-      (encoder, ndn_Tlv_InterestLifetime, interest->interestLifetimeMilliseconds)))
+  if ((error = ndn_TlvEncoder_prependOptionalNonNegativeIntegerTlvFromDouble
+      (encoder, ndn_Tlv_InterestLifetime,
+       interest->interestLifetimeMilliseconds)))
     return error;
 
-  if (interest->linkWireEncoding.value) {
-    // Encode the entire link as is.
-    if ((error = ndn_TlvEncoder_writeArray
-        (encoder, interest->linkWireEncoding.value, interest->linkWireEncoding.length)))
-      return error;
-  }
-  if ((error = ndn_TlvEncoder_writeOptionalNonNegativeIntegerTlv
-      (encoder, ndn_Tlv_SelectedDelegation, interest->selectedDelegationIndex)))
+  if ((error = getNonceBlob(interest, nonceBuffer, &nonceBlob)))
+    return error;
+  if ((error = ndn_TlvEncoder_prependBlobTlv(encoder, ndn_Tlv_Nonce, &nonceBlob)))
     return error;
 
-  return NDN_ERROR_success;
-}
+  if ((error = prependSelectors(interest, encoder)))
+    return error;
+  if ((error = ndn_prependTlvName
+       (&interest->name, signedPortionBeginOffset, signedPortionEndOffset,
+        encoder)))
+    return error;
 
-ndn_Error
-ndn_encodeTlvInterest
-  (const struct ndn_Interest *interest, size_t *signedPortionBeginOffset,
-   size_t *signedPortionEndOffset, struct ndn_TlvEncoder *encoder)
-{
-  // Create the context to pass to encodeInterestValue.
-  struct InterestValueContext interestValueContext;
-  interestValueContext.interest = interest;
-  interestValueContext.signedPortionBeginOffset = signedPortionBeginOffset;
-  interestValueContext.signedPortionEndOffset = signedPortionEndOffset;
-
-  return ndn_TlvEncoder_writeNestedTlv
-    (encoder, ndn_Tlv_Interest, encodeInterestValue, &interestValueContext, 0);
+  return ndn_TlvEncoder_prependTypeAndLength
+    (encoder, ndn_Tlv_Interest, encoder->offset - saveOffset);
 }
 
 static ndn_Error
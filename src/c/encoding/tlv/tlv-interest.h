@@ -29,8 +29,14 @@
 extern "C" {
 #endif
 
+/**
+ * Prepend the encoding of the interest as NDN-TLV, computing each length while
+ * encoding so that nested TLVs are written only once. The returned signed
+ * portion offsets are the number of bytes from the back of the output (like
+ * encoder->offset).
+ */
 ndn_Error
-ndn_encodeTlvInterest
+ndn_prependTlvInterest
   (const struct ndn_Interest *interest, size_t *signedPortionBeginOffset,
    size_t *signedPortionEndOffset, struct ndn_TlvEncoder *encoder);
 
@@ -46,6 +46,39 @@ ndn_encodeTlvKeyLocatorValue(const void *context, struct ndn_TlvEncoder *encoder
   return NDN_ERROR_success;
 }
 
+ndn_Error
+ndn_prependTlvKeyLocator
+  (unsigned int type, const struct ndn_KeyLocator *keyLocator,
+   int omitZeroLength, struct ndn_TlvEncoder *encoder)
+{
+  size_t saveOffset = encoder->offset;
+  ndn_Error error;
+
+  if ((int)keyLocator->type >= 0) {
+    if (keyLocator->type == ndn_KeyLocatorType_KEYNAME) {
+      size_t dummyBeginOffset, dummyEndOffset;
+      if ((error = ndn_prependTlvName
+           (&keyLocator->keyName, &dummyBeginOffset, &dummyEndOffset, encoder)))
+        return error;
+    }
+    else if (keyLocator->type == ndn_KeyLocatorType_KEY_LOCATOR_DIGEST &&
+             keyLocator->keyData.length > 0) {
+      if ((error = ndn_TlvEncoder_prependBlobTlv
+           (encoder, ndn_Tlv_KeyLocatorDigest, &keyLocator->keyData)))
+        return error;
+    }
+    else
+      return NDN_ERROR_unrecognized_ndn_KeyLocatorType;
+  }
+
+  if (omitZeroLength && encoder->offset == saveOffset)
+    // Omit the optional TLV.
+    return NDN_ERROR_success;
+
+  return ndn_TlvEncoder_prependTypeAndLength
+    (encoder, type, encoder->offset - saveOffset);
+}
+
 ndn_Error
 ndn_decodeTlvKeyLocator
   (unsigned int expectedType, struct ndn_KeyLocator *keyLocator,
@@ -38,6 +38,22 @@ extern "C" {
 ndn_Error
 ndn_encodeTlvKeyLocatorValue(const void *context, struct ndn_TlvEncoder *encoder);
 
+/**
+ * Prepend the encoding of the key locator to the encoder as NDN-TLV.
+ * @param type The type code of the TLV, e.g. ndn_Tlv_KeyLocator or
+ * ndn_Tlv_PublisherPublicKeyLocator.
+ * @param keyLocator A pointer to the ndn_KeyLocator struct.
+ * @param omitZeroLength If 1 and the key locator has no value, then don't
+ * prepend anything.
+ * @param encoder A pointer to the ndn_TlvEncoder struct which receives
+ * the encoding.
+ * @return 0 for success, else an error code.
+ */
+ndn_Error
+ndn_prependTlvKeyLocator
+  (unsigned int type, const struct ndn_KeyLocator *keyLocator,
+   int omitZeroLength, struct ndn_TlvEncoder *encoder);
+
 /**
  * Expect the next element to be a TLV KeyLocator and decode into the ndn_KeyLocator struct.
  * @param expectedType The expected type code of the TLV, e.g. ndn_Tlv_KeyLocator
@@ -29,6 +29,15 @@ ndn_encodeTlvNameComponent
   return ndn_TlvEncoder_writeBlobTlv(encoder, type, &component->value);
 }
 
+ndn_Error
+ndn_prependTlvNameComponent
+  (const struct ndn_NameComponent *component, struct ndn_TlvEncoder *encoder)
+{
+  unsigned int type = ndn_NameComponent_isImplicitSha256Digest(component) ?
+    ndn_Tlv_ImplicitSha256DigestComponent : ndn_Tlv_NameComponent;
+  return ndn_TlvEncoder_prependBlobTlv(encoder, type, &component->value);
+}
+
 ndn_Error
 ndn_decodeTlvNameComponent
   (struct ndn_NameComponent *component, struct ndn_TlvDecoder *decoder)
@@ -88,6 +97,32 @@ ndn_encodeTlvName
   return NDN_ERROR_success;
 }
 
+ndn_Error
+ndn_prependTlvName
+  (const struct ndn_Name *name, size_t *signedPortionBeginOffset,
+   size_t *signedPortionEndOffset, struct ndn_TlvEncoder *encoder)
+{
+  size_t saveOffset = encoder->offset;
+  size_t i;
+  ndn_Error error;
+
+  // In case there are no components, set signedPortionEndOffset arbitrarily.
+  *signedPortionEndOffset = encoder->offset;
+  for (i = name->nComponents; i > 0; --i) {
+    if ((error = ndn_prependTlvNameComponent(&name->components[i - 1], encoder)))
+      return error;
+
+    if (i == name->nComponents)
+      // We just prepended the final component.
+      *signedPortionEndOffset = encoder->offset;
+  }
+
+  *signedPortionBeginOffset = encoder->offset;
+
+  return ndn_TlvEncoder_prependTypeAndLength
+    (encoder, ndn_Tlv_Name, encoder->offset - saveOffset);
+}
+
 ndn_Error
 ndn_decodeTlvName
   (struct ndn_Name *name, size_t *signedPortionBeginOffset,
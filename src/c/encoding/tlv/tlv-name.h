@@ -41,6 +41,18 @@ ndn_Error
 ndn_encodeTlvNameComponent
   (const struct ndn_NameComponent *component, struct ndn_TlvEncoder *encoder);
 
+/**
+ * Prepend the encoding of the name component to the encoder as NDN-TLV. This
+ * handles different component types such as ImplicitSha256DigestComponent.
+ * @param component A pointer to the name component to encode.
+ * @param encoder A pointer to the ndn_TlvEncoder struct which receives
+ * the encoding.
+ * @return 0 for success, else an error code.
+ */
+ndn_Error
+ndn_prependTlvNameComponent
+  (const struct ndn_NameComponent *component, struct ndn_TlvEncoder *encoder);
+
 /**
  * Decode the next element as a TLV NameComponent into the ndn_NameComponent
  * struct. This handles different component types such as
@@ -75,6 +87,27 @@ ndn_encodeTlvName
   (const struct ndn_Name *name, size_t *signedPortionBeginOffset,
    size_t *signedPortionEndOffset, struct ndn_TlvEncoder *encoder);
 
+/**
+ * Prepend the encoding of the name to the encoder as NDN-TLV.
+ * @param name A pointer to the name object to encode.
+ * @param signedPortionBeginOffset Return the offset of the beginning of the
+ * signed portion as the number of bytes from the back of the output (like
+ * encoder->offset). The signed portion starts from the first name component
+ * and ends just before the final name component (which is assumed to be a
+ * signature for a signed interest).
+ * If you are not encoding in order to sign, you can ignore this returned value.
+ * @param signedPortionEndOffset Return the offset of the end of the signed
+ * portion as the number of bytes from the back of the output.
+ * If you are not encoding in order to sign, you can ignore this returned value.
+ * @param encoder A pointer to the ndn_TlvEncoder struct which receives
+ * the encoding.
+ * @return 0 for success, else an error code.
+ */
+ndn_Error
+ndn_prependTlvName
+  (const struct ndn_Name *name, size_t *signedPortionBeginOffset,
+   size_t *signedPortionEndOffset, struct ndn_TlvEncoder *encoder);
+
 /**
  * Expect the next element to be a TLV Name and decode into the ndn_Name struct.
  * @param name A pointer to the ndn_Name struct.
@@ -159,6 +159,35 @@ decodeValidityPeriod
   return NDN_ERROR_success;
 }
 
+/**
+ * Do a test decoding of the encoding of a Generic signature to sanity check
+ * that it is a valid NDN-TLV SignatureInfo.
+ * @param encoding The signatureInfoEncoding of the Generic signature.
+ * @return 0 for success, else
+ * NDN_ERROR_The_Generic_signature_encoding_is_not_a_valid_NDN_TLV_SignatureInfo.
+ */
+static ndn_Error
+checkGenericSignatureInfoEncoding(const struct ndn_Blob *encoding)
+{
+  ndn_Error error;
+  size_t endOffset;
+  uint64_t signatureType;
+
+  struct ndn_TlvDecoder decoder;
+  ndn_TlvDecoder_initialize(&decoder, encoding->value, encoding->length);
+  error = ndn_TlvDecoder_readNestedTlvsStart
+    (&decoder, ndn_Tlv_SignatureInfo, &endOffset);
+  if (!error)
+    error = ndn_TlvDecoder_readNonNegativeIntegerTlv
+      (&decoder, ndn_Tlv_SignatureType, &signatureType);
+  if (!error)
+    error = ndn_TlvDecoder_finishNestedTlvs(&decoder, endOffset);
+  if (error)
+    return NDN_ERROR_The_Generic_signature_encoding_is_not_a_valid_NDN_TLV_SignatureInfo;
+
+  return NDN_ERROR_success;
+}
+
 ndn_Error
 ndn_encodeTlvSignatureInfo
   (const struct ndn_Signature *signatureInfo, struct ndn_TlvEncoder *encoder)
@@ -167,21 +196,8 @@ ndn_encodeTlvSignatureInfo
     // Handle a Generic signature separately since it has the entire encoding.
     const struct ndn_Blob *encoding = &signatureInfo->signatureInfoEncoding;
     ndn_Error error;
-    size_t endOffset;
-    uint64_t signatureType;
-
-    // Do a test decoding to sanity check that it is valid TLV.
-    struct ndn_TlvDecoder decoder;
-    ndn_TlvDecoder_initialize(&decoder, encoding->value, encoding->length);
-    error = ndn_TlvDecoder_readNestedTlvsStart
-      (&decoder, ndn_Tlv_SignatureInfo, &endOffset);
-    if (!error)
-      error = ndn_TlvDecoder_readNonNegativeIntegerTlv
-        (&decoder, ndn_Tlv_SignatureType, &signatureType);
-    if (!error)
-      error = ndn_TlvDecoder_finishNestedTlvs(&decoder, endOffset);
-    if (error)
-      return NDN_ERROR_The_Generic_signature_encoding_is_not_a_valid_NDN_TLV_SignatureInfo;
+    if ((error = checkGenericSignatureInfoEncoding(encoding)))
+      return error;
 
     return ndn_TlvEncoder_writeArray(encoder, encoding->value, encoding->length);
   }
@@ -200,6 +216,90 @@ ndn_encodeTlvSignatureInfo
     return NDN_ERROR_encodeSignatureInfo_unrecognized_SignatureType;
 }
 
+/**
+ * Prepend the encoding of a signature's ValidityPeriod.
+ * @param validityPeriod A pointer to the ndn_ValidityPeriod struct.
+ * @param encoder the ndn_TlvEncoder which receives the encoding.
+ * @return 0 for success, else an error code.
+ */
+static ndn_Error
+prependValidityPeriod
+  (const struct ndn_ValidityPeriod *validityPeriod,
+   struct ndn_TlvEncoder *encoder)
+{
+  size_t saveOffset = encoder->offset;
+  ndn_Error error;
+  struct ndn_Blob isoStringBlob;
+  char isoString[23];
+
+  // Encode notAfter first since we are prepending.
+  if ((error = ndn_toIsoString(validityPeriod->notAfter, 0, isoString)))
+    return error;
+  ndn_Blob_initialize
+    (&isoStringBlob, (const uint8_t *)isoString, strlen(isoString));
+  if ((error = ndn_TlvEncoder_prependOptionalBlobTlv
+       (encoder, ndn_Tlv_ValidityPeriod_NotAfter, &isoStringBlob)))
+    return error;
+
+  // Encode notBefore.
+  if ((error = ndn_toIsoString(validityPeriod->notBefore, 0, isoString)))
+    return error;
+  ndn_Blob_initialize
+    (&isoStringBlob, (const uint8_t *)isoString, strlen(isoString));
+  if ((error = ndn_TlvEncoder_prependOptionalBlobTlv
+       (encoder, ndn_Tlv_ValidityPeriod_NotBefore, &isoStringBlob)))
+    return error;
+
+  return ndn_TlvEncoder_prependTypeAndLength
+    (encoder, ndn_Tlv_ValidityPeriod_ValidityPeriod,
+     encoder->offset - saveOffset);
+}
+
+ndn_Error
+ndn_prependTlvSignatureInfo
+  (const struct ndn_Signature *signatureInfo, struct ndn_TlvEncoder *encoder)
+{
+  size_t saveOffset = encoder->offset;
+  ndn_Error error;
+
+  if (signatureInfo->type == ndn_SignatureType_Generic) {
+    // Handle a Generic signature separately since it has the entire encoding.
+    const struct ndn_Blob *encoding = &signatureInfo->signatureInfoEncoding;
+    if ((error = checkGenericSignatureInfoEncoding(encoding)))
+      return error;
+
+    return ndn_TlvEncoder_prependArray(encoder, encoding->value, encoding->length);
+  }
+
+  if (signatureInfo->type == ndn_SignatureType_Sha256WithRsaSignature ||
+      signatureInfo->type == ndn_SignatureType_Sha256WithEcdsaSignature ||
+      signatureInfo->type == ndn_SignatureType_HmacWithSha256Signature) {
+    if (ndn_ValidityPeriod_hasPeriod(&signatureInfo->validityPeriod)) {
+      if ((error = prependValidityPeriod
+           (&signatureInfo->validityPeriod, encoder)))
+        return error;
+    }
+    if ((error = ndn_prependTlvKeyLocator
+         (ndn_Tlv_KeyLocator, &signatureInfo->keyLocator, 0, encoder)))
+      return error;
+    // Use signatureInfo->type as the TLV type, assuming that the
+    // ndn_SignatureType enum has the same values as the TLV signature types.
+    if ((error = ndn_TlvEncoder_prependNonNegativeIntegerTlv
+         (encoder, ndn_Tlv_SignatureType, signatureInfo->type)))
+      return error;
+  }
+  else if (signatureInfo->type == ndn_SignatureType_DigestSha256Signature) {
+    if ((error = ndn_TlvEncoder_prependNonNegativeIntegerTlv
+         (encoder, ndn_Tlv_SignatureType, ndn_Tlv_SignatureType_DigestSha256)))
+      return error;
+  }
+  else
+    return NDN_ERROR_encodeSignatureInfo_unrecognized_SignatureType;
+
+  return ndn_TlvEncoder_prependTypeAndLength
+    (encoder, ndn_Tlv_SignatureInfo, encoder->offset - saveOffset);
+}
+
 ndn_Error
 ndn_decodeTlvSignatureInfo
   (struct ndn_Signature *signatureInfo, struct ndn_TlvDecoder *decoder)
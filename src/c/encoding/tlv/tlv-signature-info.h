@@ -40,6 +40,17 @@ ndn_Error
 ndn_encodeTlvSignatureInfo
   (const struct ndn_Signature *signatureInfo, struct ndn_TlvEncoder *encoder);
 
+/**
+ * Prepend the encoding of signatureInfo as an NDN-TLV SignatureInfo.
+ * @param signatureInfo A pointer to the ndn_Signature struct to encode.
+ * @param encoder A pointer to the ndn_TlvEncoder struct which receives the
+ * encoding.
+ * @return 0 for success, else an error code.
+ */
+ndn_Error
+ndn_prependTlvSignatureInfo
+  (const struct ndn_Signature *signatureInfo, struct ndn_TlvEncoder *encoder);
+
 /**
  * Decode as an NDN-TLV SignatureInfo and set the fields in signatureInfo.
  * @param signatureInfo A pointer to the ndn_Signature struct to receive the
@@ -22,6 +22,11 @@
 #include <ndn-cpp/ndn-cpp-config.h>
 #if NDN_CPP_HAVE_UNISTD_H
 
+#if (NDN_CPP_HAVE_RECVMMSG || NDN_CPP_HAVE_SENDMMSG) && !defined(_GNU_SOURCE)
+// recvmmsg and sendmmsg are GNU extensions.
+#define _GNU_SOURCE
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
@@ -29,6 +34,7 @@
 #include <sys/types.h>
 #include <netinet/in.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <sys/un.h>
 #include <arpa/inet.h>
 #include <poll.h>
@@ -36,6 +42,11 @@
 #include "socket-transport.h"
 #include <errno.h>
 
+// The maximum number of buffers to give to one call to writev, sendmmsg or
+// recvmmsg.
+// IOV_MAX is at least 16 in POSIX, and 1024 on Linux and macOS.
+#define MAX_BATCH_PACKETS 64
+
 #ifndef SUN_LEN
 #define SUN_LEN(su) \
 	(sizeof(*(su)) - sizeof((su)->sun_path) + strlen((su)->sun_path))
@@ -127,29 +138,143 @@ ndn_Error ndn_SocketTransport_send(struct ndn_SocketTransport *self, const uint8
       break;
 
     // Send more.
+    data += nBytes;
     dataLength -= nBytes;
   }
 
   return NDN_ERROR_success;
 }
 
+ndn_Error
+ndn_SocketTransport_sendBatch
+  (struct ndn_SocketTransport *self, const struct ndn_Blob *packets,
+   size_t nPackets)
+{
+  struct iovec iov[MAX_BATCH_PACKETS];
+  // The next packet to send and the number of its bytes which are already sent.
+  size_t iPacket = 0;
+  size_t offset = 0;
+
+  if (self->socketDescriptor < 0)
+    return NDN_ERROR_SocketTransport_socket_is_not_open;
+
+  while (iPacket < nPackets) {
+    int nIov = 0;
+    size_t i;
+    ssize_t nBytes;
+    size_t nBytesLeft;
+
+    for (i = iPacket; i < nPackets && nIov < MAX_BATCH_PACKETS; ++i) {
+      size_t skip = (i == iPacket ? offset : 0);
+      if (packets[i].length <= skip)
+        continue;
+      iov[nIov].iov_base = (void *)(packets[i].value + skip);
+      iov[nIov].iov_len = packets[i].length - skip;
+      ++nIov;
+    }
+    if (nIov == 0)
+      // The rest of the packets are empty.
+      break;
+
+    if ((nBytes = writev(self->socketDescriptor, iov, nIov)) < 0)
+      return NDN_ERROR_SocketTransport_error_in_send;
+
+    // Skip the packets which were completely sent, then send more.
+    nBytesLeft = (size_t)nBytes;
+    while (iPacket < nPackets && nBytesLeft >= packets[iPacket].length - offset) {
+      nBytesLeft -= packets[iPacket].length - offset;
+      ++iPacket;
+      offset = 0;
+    }
+    offset += nBytesLeft;
+  }
+
+  return NDN_ERROR_success;
+}
+
+ndn_Error
+ndn_SocketTransport_sendDatagramBatch
+  (struct ndn_SocketTransport *self, const struct ndn_Blob *packets,
+   size_t nPackets)
+{
+  size_t iPacket = 0;
+
+  if (self->socketDescriptor < 0)
+    return NDN_ERROR_SocketTransport_socket_is_not_open;
+
+#if NDN_CPP_HAVE_SENDMMSG
+  {
+    struct mmsghdr messages[MAX_BATCH_PACKETS];
+    struct iovec iov[MAX_BATCH_PACKETS];
+
+    while (iPacket < nPackets) {
+      unsigned int nMessages = 0;
+      int nSent;
+
+      while (iPacket + nMessages < nPackets && nMessages < MAX_BATCH_PACKETS) {
+        const struct ndn_Blob *packet = &packets[iPacket + nMessages];
+        iov[nMessages].iov_base = (void *)packet->value;
+        iov[nMessages].iov_len = packet->length;
+        ndn_memset
+          ((uint8_t *)&messages[nMessages], 0, sizeof(messages[nMessages]));
+        messages[nMessages].msg_hdr.msg_iov = &iov[nMessages];
+        messages[nMessages].msg_hdr.msg_iovlen = 1;
+        ++nMessages;
+      }
+
+      if ((nSent = sendmmsg
+           (self->socketDescriptor, messages, nMessages, 0)) <= 0)
+        return NDN_ERROR_SocketTransport_error_in_send;
+      iPacket += nSent;
+    }
+  }
+#else
+  for (; iPacket < nPackets; ++iPacket) {
+    ndn_Error error;
+    if ((error = ndn_SocketTransport_send
+         (self, packets[iPacket].value, packets[iPacket].length)))
+      return error;
+  }
+#endif
+
+  return NDN_ERROR_success;
+}
+
 ndn_Error ndn_SocketTransport_receiveIsReady(struct ndn_SocketTransport *self, int *receiveIsReady)
+{
+  return ndn_SocketTransport_waitForReceive(self, 0, -1, receiveIsReady);
+}
+
+ndn_Error
+ndn_SocketTransport_waitForReceive
+  (struct ndn_SocketTransport *self, int timeoutMilliseconds,
+   int wakeupDescriptor, int *receiveIsReady)
 {
   // Default to not ready.
   *receiveIsReady = 0;
 
-  if (self->socketDescriptor < 0)
-    // The socket is not open.  Just silently return.
+  if (self->socketDescriptor < 0 && wakeupDescriptor < 0)
+    // There is nothing to wait on.
     return NDN_ERROR_success;
 
-  struct pollfd pollInfo[1];
+  struct pollfd pollInfo[2];
   pollInfo[0].fd = self->socketDescriptor;
   pollInfo[0].events = POLLIN;
-
-  int pollResult = poll(pollInfo, 1, 0);
-
-  if (pollResult < 0)
+  pollInfo[0].revents = 0;
+  pollInfo[1].fd = wakeupDescriptor;
+  pollInfo[1].events = POLLIN;
+  pollInfo[1].revents = 0;
+
+  // If the socket is not open, poll ignores the negative descriptor and only
+  // waits on the wakeup descriptor.
+  int pollResult = poll(pollInfo, wakeupDescriptor >= 0 ? 2 : 1, timeoutMilliseconds);
+
+  if (pollResult < 0) {
+    if (errno == EINTR)
+      // A signal interrupted the wait. Treat it like a timeout.
+      return NDN_ERROR_success;
     return NDN_ERROR_SocketTransport_error_in_poll;
+  }
   else if (pollResult == 0)
     // Timeout, so no data ready.
     return NDN_ERROR_success;
@@ -203,6 +328,86 @@ ndn_SocketTransport_processEvents
   }
 }
 
+ndn_Error
+ndn_SocketTransport_processDatagramEvents
+  (struct ndn_SocketTransport *self, uint8_t *buffers, size_t bufferLength,
+   size_t nBuffers)
+{
+#if NDN_CPP_HAVE_RECVMMSG
+  struct mmsghdr messages[MAX_BATCH_PACKETS];
+  struct iovec iov[MAX_BATCH_PACKETS];
+  unsigned int nMessages;
+  unsigned int i;
+
+  if (self->socketDescriptor < 0)
+    // The socket is not open.  Just silently return.
+    return NDN_ERROR_success;
+
+  nMessages = (unsigned int)
+    (nBuffers < MAX_BATCH_PACKETS ? nBuffers : MAX_BATCH_PACKETS);
+  if (nMessages == 0)
+    return NDN_ERROR_success;
+
+  // Loop until there are no more datagrams in the receive buffer.
+  while (1) {
+    int nReceived;
+    ndn_Error firstError = NDN_ERROR_success;
+
+    for (i = 0; i < nMessages; ++i) {
+      iov[i].iov_base = buffers + i * bufferLength;
+      iov[i].iov_len = bufferLength;
+      ndn_memset((uint8_t *)&messages[i], 0, sizeof(messages[i]));
+      messages[i].msg_hdr.msg_iov = &iov[i];
+      messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    if ((nReceived = recvmmsg
+         (self->socketDescriptor, messages, nMessages, MSG_DONTWAIT, 0)) < 0) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK)
+        return NDN_ERROR_success;
+      return NDN_ERROR_SocketTransport_error_in_recv;
+    }
+
+    // Each buffer has one datagram, so give it to the ElementReader in place.
+    // The datagrams are independent, so an error in one doesn't drop the rest
+    // of the batch, which was already removed from the receive buffer.
+    for (i = 0; i < (unsigned int)nReceived; ++i) {
+      ndn_Error error;
+      if ((error = ndn_ElementReader_onReceivedDatagram
+           (&self->elementReader, (const uint8_t *)iov[i].iov_base,
+            messages[i].msg_len)) && !firstError)
+        firstError = error;
+    }
+    if (firstError)
+      return firstError;
+
+    if ((unsigned int)nReceived < nMessages)
+      // We got all the datagrams which were ready.
+      return NDN_ERROR_success;
+  }
+#else
+  // Loop until there is no more data in the receive buffer.
+  while(1) {
+    int receiveIsReady;
+    ndn_Error error;
+    size_t nBytes;
+    if ((error = ndn_SocketTransport_receiveIsReady
+         (self, &receiveIsReady)))
+      return error;
+    if (!receiveIsReady)
+      return NDN_ERROR_success;
+
+    if ((error = ndn_SocketTransport_receive
+         (self, buffers, bufferLength, &nBytes)))
+      return error;
+
+    if ((error = ndn_ElementReader_onReceivedDatagram
+         (&self->elementReader, buffers, nBytes)))
+      return error;
+  }
+#endif
+}
+
 ndn_Error ndn_SocketTransport_close(struct ndn_SocketTransport *self)
 {
   if (self->socketDescriptor < 0)
@@ -24,6 +24,7 @@
 #include <ndn-cpp/c/common.h>
 #include <ndn-cpp/c/errors.h>
 #include <ndn-cpp/c/transport/transport-types.h>
+#include <ndn-cpp/c/util/blob-types.h>
 #include "../encoding/element-reader.h"
 
 #ifdef __cplusplus
@@ -80,6 +81,33 @@ ndn_Error ndn_SocketTransport_connect
  */
 ndn_Error ndn_SocketTransport_send(struct ndn_SocketTransport *self, const uint8_t *data, size_t dataLength);
 
+/**
+ * Send the packets to a stream socket in order, gathering them with writev so
+ * that a batch of packets needs only a few system calls.
+ * @param self A pointer to the ndn_SocketTransport struct.
+ * @param packets An array of ndn_Blob with the encoding of each packet.
+ * @param nPackets The number of packets in the array.
+ * @return 0 for success, else an error code.
+ */
+ndn_Error
+ndn_SocketTransport_sendBatch
+  (struct ndn_SocketTransport *self, const struct ndn_Blob *packets,
+   size_t nPackets);
+
+/**
+ * Send the packets to a datagram socket in order, one datagram per packet.
+ * If sendmmsg is available, use it so that a batch of packets needs only a few
+ * system calls. Otherwise, call ndn_SocketTransport_send for each packet.
+ * @param self A pointer to the ndn_SocketTransport struct.
+ * @param packets An array of ndn_Blob with the encoding of each packet.
+ * @param nPackets The number of packets in the array.
+ * @return 0 for success, else an error code.
+ */
+ndn_Error
+ndn_SocketTransport_sendDatagramBatch
+  (struct ndn_SocketTransport *self, const struct ndn_Blob *packets,
+   size_t nPackets);
+
 /**
  * Check if there is data ready on the socket to be received with ndn_SocketTransport_receive.
  * This does not block, and returns immediately.
@@ -89,6 +117,25 @@ ndn_Error ndn_SocketTransport_send(struct ndn_SocketTransport *self, const uint8
  */
 ndn_Error ndn_SocketTransport_receiveIsReady(struct ndn_SocketTransport *self, int *receiveIsReady);
 
+/**
+ * Wait until there is data ready on the socket to be received, or until the
+ * timeout, whichever is first. If the socket is not open, only wait on the
+ * wakeupDescriptor, or return immediately if it is also negative.
+ * @param self A pointer to the ndn_SocketTransport struct.
+ * @param timeoutMilliseconds The maximum time to wait in milliseconds. If this
+ * is 0, don't wait. If this is negative, wait with no timeout.
+ * @param wakeupDescriptor If not negative, also stop waiting when this
+ * descriptor is ready to read, such as an eventfd which another thread writes.
+ * This does not read from the descriptor.
+ * @param receiveIsReady This will be set to 1 if data is ready on the socket,
+ * 0 if not.
+ * @return 0 for success, else an error code.
+ */
+ndn_Error
+ndn_SocketTransport_waitForReceive
+  (struct ndn_SocketTransport *self, int timeoutMilliseconds,
+   int wakeupDescriptor, int *receiveIsReady);
+
 /**
  * Receive data from the socket.  NOTE: This is a blocking call.  You should first call ndn_SocketTransport_receiveIsReady
  * to make sure there is data ready to receive.
@@ -120,6 +167,27 @@ ndn_Error
 ndn_SocketTransport_processEvents
   (struct ndn_SocketTransport *self, uint8_t *buffer, size_t bufferLength);
 
+/**
+ * Process any datagrams to receive. Receive a batch of datagrams with one
+ * system call if recvmmsg is available, one datagram into each buffer, then
+ * give each datagram in place to the ElementReader as a whole. For each
+ * element received, call
+ * (*elementListener->onReceivedElement)(element, elementLength) for the
+ * elementListener in the elementReader given to connect(). This is non-blocking
+ * and will return immediately if there is no data to receive.
+ * @param self A pointer to the ndn_SocketTransport struct.
+ * @param buffers A pointer to nBuffers consecutive buffers, each of size
+ * bufferLength, for receiving datagrams. These are only for temporary use.
+ * @param bufferLength The size of each buffer. A datagram which is larger is
+ * truncated and dropped, so this should be MAX_NDN_PACKET_SIZE.
+ * @param nBuffers The number of buffers.
+ * @return 0 for success, else an error code.
+ */
+ndn_Error
+ndn_SocketTransport_processDatagramEvents
+  (struct ndn_SocketTransport *self, uint8_t *buffers, size_t bufferLength,
+   size_t nBuffers);
+
 /**
  * Close the socket.
  * @param self A pointer to the ndn_SocketTransport struct.
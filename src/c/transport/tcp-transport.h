@@ -90,6 +90,20 @@ static __inline ndn_Error ndn_TcpTransport_send
   return ndn_SocketTransport_send(&self->base, data, dataLength);
 }
 
+/**
+ * Send the packets to the socket in order.
+ * @param self A pointer to the ndn_TcpTransport struct.
+ * @param packets An array of ndn_Blob with the encoding of each packet.
+ * @param nPackets The number of packets in the array.
+ * @return 0 for success, else an error code.
+ */
+static __inline ndn_Error ndn_TcpTransport_sendBatch
+  (struct ndn_TcpTransport *self, const struct ndn_Blob *packets,
+   size_t nPackets)
+{
+  return ndn_SocketTransport_sendBatch(&self->base, packets, nPackets);
+}
+
 /**
  * Process any data to receive.  For each element received, call
  * (*elementListener->onReceivedElement)(element, elementLength) for the
@@ -112,6 +126,27 @@ ndn_TcpTransport_processEvents
   return ndn_SocketTransport_processEvents(&self->base, buffer, bufferLength);
 }
 
+/**
+ * Wait until there is data ready on the socket to be received, or until the
+ * timeout, whichever is first. If the socket is not open, only wait on the
+ * wakeupDescriptor, or return immediately if it is also negative.
+ * @param self A pointer to the ndn_TcpTransport struct.
+ * @param timeoutMilliseconds The maximum time to wait in milliseconds. If this
+ * is 0, don't wait. If this is negative, wait with no timeout.
+ * @param wakeupDescriptor If not negative, also stop waiting when this
+ * descriptor is ready to read, such as an eventfd which another thread writes.
+ * @param receiveIsReady This will be set to 1 if data is ready, 0 if not.
+ * @return 0 for success, else an error code.
+ */
+static __inline ndn_Error
+ndn_TcpTransport_waitForReceive
+  (struct ndn_TcpTransport *self, int timeoutMilliseconds, int wakeupDescriptor,
+   int *receiveIsReady)
+{
+  return ndn_SocketTransport_waitForReceive
+    (&self->base, timeoutMilliseconds, wakeupDescriptor, receiveIsReady);
+}
+
 /**
  * Close the socket.
  * @param self A pointer to the ndn_TcpTransport struct.
@@ -84,7 +84,21 @@ static __inline ndn_Error ndn_UdpTransport_send
 }
 
 /**
- * Process any data to receive.  For each element received, call
+ * Send the packets to the socket in order, one datagram per packet.
+ * @param self A pointer to the ndn_UdpTransport struct.
+ * @param packets An array of ndn_Blob with the encoding of each packet.
+ * @param nPackets The number of packets in the array.
+ * @return 0 for success, else an error code.
+ */
+static __inline ndn_Error ndn_UdpTransport_sendBatch
+  (struct ndn_UdpTransport *self, const struct ndn_Blob *packets,
+   size_t nPackets)
+{
+  return ndn_SocketTransport_sendDatagramBatch(&self->base, packets, nPackets);
+}
+
+/**
+ * Process any datagrams to receive.  For each element received, call
  * (*elementListener->onReceivedElement)(element, elementLength) for the
  * elementListener in the elementReader given to connect(). This is non-blocking
  * and will return immediately if there is no data to receive.
@@ -92,17 +106,58 @@ static __inline ndn_Error ndn_UdpTransport_send
  * @param buffer A pointer to a buffer for receiving data. Note that this is
  * only for temporary use and is not the way that this function supplies data.
  * It supplies the data by calling the onReceivedElement callback.
- * @param bufferLength The size of buffer. The buffer should be as large as
- * resources permit up to MAX_NDN_PACKET_SIZE, but smaller sizes will work
- * however may be less efficient due to multiple calls to socket receive and
- * more processing by the ElementReader.
+ * @param bufferLength The size of buffer. A datagram which is larger is
+ * dropped, so this should be MAX_NDN_PACKET_SIZE.
  * @return 0 for success, else an error code.
  */
 static __inline ndn_Error
 ndn_UdpTransport_processEvents
   (struct ndn_UdpTransport *self, uint8_t *buffer, size_t bufferLength)
 {
-  return ndn_SocketTransport_processEvents(&self->base, buffer, bufferLength);
+  return ndn_SocketTransport_processDatagramEvents
+    (&self->base, buffer, bufferLength, 1);
+}
+
+/**
+ * Process any datagrams to receive like ndn_UdpTransport_processEvents, but
+ * receive up to nBuffers datagrams with each system call if recvmmsg is
+ * available.
+ * @param self A pointer to the ndn_UdpTransport struct.
+ * @param buffers A pointer to nBuffers consecutive buffers, each of size
+ * bufferLength, for receiving datagrams.
+ * @param bufferLength The size of each buffer, which should be
+ * MAX_NDN_PACKET_SIZE.
+ * @param nBuffers The number of buffers.
+ * @return 0 for success, else an error code.
+ */
+static __inline ndn_Error
+ndn_UdpTransport_processEventsWithBuffers
+  (struct ndn_UdpTransport *self, uint8_t *buffers, size_t bufferLength,
+   size_t nBuffers)
+{
+  return ndn_SocketTransport_processDatagramEvents
+    (&self->base, buffers, bufferLength, nBuffers);
+}
+
+/**
+ * Wait until there is data ready on the socket to be received, or until the
+ * timeout, whichever is first. If the socket is not open, only wait on the
+ * wakeupDescriptor, or return immediately if it is also negative.
+ * @param self A pointer to the ndn_UdpTransport struct.
+ * @param timeoutMilliseconds The maximum time to wait in milliseconds. If this
+ * is 0, don't wait. If this is negative, wait with no timeout.
+ * @param wakeupDescriptor If not negative, also stop waiting when this
+ * descriptor is ready to read, such as an eventfd which another thread writes.
+ * @param receiveIsReady This will be set to 1 if data is ready, 0 if not.
+ * @return 0 for success, else an error code.
+ */
+static __inline ndn_Error
+ndn_UdpTransport_waitForReceive
+  (struct ndn_UdpTransport *self, int timeoutMilliseconds, int wakeupDescriptor,
+   int *receiveIsReady)
+{
+  return ndn_SocketTransport_waitForReceive
+    (&self->base, timeoutMilliseconds, wakeupDescriptor, receiveIsReady);
 }
 
 /**
@@ -54,14 +54,9 @@ ndn_Error ndn_DynamicUInt8Array_reallocArrayFromBack
     return error;
 
   // Shift to the back.
-  // TODO: We should use ndn_memmove, but we need to add support in ndn_memory.h.
-  if (initialLength > 0) {
-    uint8_t *to = self->array + self->length;
-    uint8_t *from = self->array + initialLength;
-    do {
-      *(--to) = *(--from);
-    } while (from != self->array);
-  }
+  if (initialLength > 0)
+    ndn_memmove
+      (self->array + (self->length - initialLength), self->array, initialLength);
 
   return NDN_ERROR_success;
 }
@@ -50,6 +50,24 @@ void ndn_memcpy(uint8_t *dest, const uint8_t *src, size_t len)
 int ndn_memcpy_stub_to_avoid_empty_file_warning = 0;
 #endif
 
+#if !NDN_CPP_HAVE_MEMMOVE
+void ndn_memmove(uint8_t *dest, const uint8_t *src, size_t len)
+{
+  size_t i;
+
+  if (dest < src) {
+    for (i = 0; i < len; i++)
+      dest[i] = src[i];
+  }
+  else if (dest > src) {
+    for (i = len; i > 0; i--)
+      dest[i - 1] = src[i - 1];
+  }
+}
+#else
+int ndn_memmove_stub_to_avoid_empty_file_warning = 0;
+#endif
+
 #if !NDN_CPP_HAVE_MEMSET
 void ndn_memset(uint8_t *dest, int val, size_t len)
 {
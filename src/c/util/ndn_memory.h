@@ -69,6 +69,24 @@ static __inline void ndn_memcpy(uint8_t *dest, const uint8_t *src, size_t len) {
 void ndn_memcpy(uint8_t *dest, const uint8_t *src, size_t len);
 #endif
 
+#if NDN_CPP_HAVE_MEMMOVE
+
+#if NDN_CPP_HAVE_MEMORY_H
+#include <memory.h>
+#else
+#include <string.h>
+#endif
+/**
+ * Use the library version of memmove.
+ */
+static __inline void ndn_memmove(uint8_t *dest, const uint8_t *src, size_t len) { memmove(dest, src, len); }
+#else
+/**
+ * Use a local implementation of memmove instead of the library version.
+ */
+void ndn_memmove(uint8_t *dest, const uint8_t *src, size_t len);
+#endif
+
 #if NDN_CPP_HAVE_MEMSET
 
 #if NDN_CPP_HAVE_MEMORY_H
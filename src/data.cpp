@@ -35,10 +35,33 @@ using namespace std;
 
 namespace ndn {
 
+/**
+ * Check if signature is an object of the class for the signature type.
+ * @param signature The Signature object, which may be null.
+ * @param type The signature type from the SignatureLite.
+ * @return True if signature is the class for type, false if not or if
+ * signature is null.
+ */
+static bool
+isSignatureType(const Signature* signature, ndn_SignatureType type)
+{
+  if (type == ndn_SignatureType_Sha256WithRsaSignature)
+    return dynamic_cast<const Sha256WithRsaSignature*>(signature) != 0;
+  else if (type == ndn_SignatureType_Sha256WithEcdsaSignature)
+    return dynamic_cast<const Sha256WithEcdsaSignature*>(signature) != 0;
+  else if (type == ndn_SignatureType_HmacWithSha256Signature)
+    return dynamic_cast<const HmacWithSha256Signature*>(signature) != 0;
+  else if (type == ndn_SignatureType_DigestSha256Signature)
+    return dynamic_cast<const DigestSha256Signature*>(signature) != 0;
+  else if (type == ndn_SignatureType_Generic)
+    return dynamic_cast<const GenericSignature*>(signature) != 0;
+  else
+    return false;
+}
+
 Data::Data()
 : signature_(new Sha256WithRsaSignature()),
   changeCount_(0),
-  defaultFullName_(new Name()),
   getDefaultWireEncodingChangeCount_(0)
 {
 }
@@ -47,7 +70,6 @@ Data::Data(const Name& name)
 : name_(name),
   signature_(new Sha256WithRsaSignature()),
   changeCount_(0),
-  defaultFullName_(new Name()),
   getDefaultWireEncodingChangeCount_(0)
 {
 }
@@ -56,9 +78,10 @@ Data::Data(const Data& data)
 : name_(data.name_),
   metaInfo_(data.metaInfo_),
   content_(data.content_),
-  defaultFullName_(new Name(*data.defaultFullName_)),
   changeCount_(0)
 {
+  if (data.defaultFullName_)
+    defaultFullName_.reset(new Name(*data.defaultFullName_));
   if (data.signature_.get()) {
     signature_.set(data.signature_.get()->clone());
     ++changeCount_;
@@ -81,6 +104,7 @@ Data& Data::operator=(const Data& data)
   setName(data.name_.get());
   setMetaInfo(data.metaInfo_.get());
   setContent(data.content_);
+  defaultFullName_.reset();
   setDefaultWireEncoding
     (data.defaultWireEncoding_, data.defaultWireEncodingFormat_);
 
@@ -101,7 +125,7 @@ ptr_lib::shared_ptr<Name>
 Data::getFullName(WireFormat& wireFormat) const
 {
   // The default full name depends on the default wire encoding.
-  if (!getDefaultWireEncoding().isNull() && defaultFullName_->size() > 0 &&
+  if (!getDefaultWireEncoding().isNull() && defaultFullName_ &&
       getDefaultWireEncodingFormat() == &wireFormat)
     // We already have a full name. A non-null default wire encoding means
     // that the Data packet fields have not changed.
@@ -134,7 +158,11 @@ Data::get(DataLite& dataLite) const
 void
 Data::set(const DataLite& dataLite)
 {
-  if (dataLite.getSignature().getType() == ndn_SignatureType_Sha256WithRsaSignature)
+  if (isSignatureType(signature_.get(), dataLite.getSignature().getType()))
+    // Reuse the existing Signature object, for example when a Node decodes
+    // into the Data object from the previous received packet.
+    ;
+  else if (dataLite.getSignature().getType() == ndn_SignatureType_Sha256WithRsaSignature)
     signature_.set(ptr_lib::shared_ptr<Signature>(new Sha256WithRsaSignature()));
   else if (dataLite.getSignature().getType() == ndn_SignatureType_Sha256WithEcdsaSignature)
     signature_.set(ptr_lib::shared_ptr<Signature>(new Sha256WithEcdsaSignature()));
@@ -185,6 +213,9 @@ Data::wireEncode(WireFormat& wireFormat) const
 void
 Data::wireDecode(const Blob& input, WireFormat& wireFormat)
 {
+  // The full name of the previous packet (if any) is no longer valid.
+  defaultFullName_.reset();
+
   size_t signedPortionBeginOffset, signedPortionEndOffset;
   wireFormat.decodeData(*this, input.buf(), input.size(), &signedPortionBeginOffset, &signedPortionEndOffset);
 
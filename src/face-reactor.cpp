@@ -0,0 +1,433 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2017 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+#include <math.h>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <ndn-cpp/ndn-cpp-config.h>
+#if NDN_CPP_HAVE_UNISTD_H
+#include <errno.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#if NDN_CPP_HAVE_EPOLL_CREATE1
+#include <sys/epoll.h>
+#endif
+#endif
+#include <ndn-cpp/util/logging.hpp>
+#include "c/util/time.h"
+#include "impl/wakeup-event.hpp"
+#include "node.hpp"
+#include <ndn-cpp/face-reactor.hpp>
+
+INIT_LOGGER("ndn.FaceReactor");
+
+using namespace std;
+using namespace ndn::func_lib;
+
+namespace ndn {
+
+#if NDN_CPP_HAVE_UNISTD_H
+
+// The maximum number of ready sockets to get from one wait.
+static const int MAX_READY_EVENTS = 64;
+
+FaceReactor::FaceReactor()
+: epollDescriptor_(-1), wakeupEvent_(new WakeupEvent())
+{
+#if NDN_CPP_HAVE_EPOLL_CREATE1
+  epollDescriptor_ = epoll_create1(EPOLL_CLOEXEC);
+  if (epollDescriptor_ < 0)
+    throw runtime_error("FaceReactor: Error in epoll_create1");
+
+  // A null data.ptr marks the wakeup event, which is not a face.
+  struct epoll_event event;
+  event.events = EPOLLIN;
+  event.data.ptr = 0;
+  if (epoll_ctl(epollDescriptor_, EPOLL_CTL_ADD, wakeupEvent_->getDescriptor(),
+                &event) < 0) {
+    ::close(epollDescriptor_);
+    throw runtime_error("FaceReactor: Error in epoll_ctl");
+  }
+#endif
+}
+
+FaceReactor::~FaceReactor()
+{
+  for (map<Face*, ptr_lib::shared_ptr<FaceEntry> >::iterator i = faces_.begin();
+       i != faces_.end(); ++i) {
+    i->first->node_->getDelayedCallTable().setOnNewFirstCall
+      (DelayedCallTable::OnNewFirstCall());
+    i->first->node_->setOnPostedCall(Node::OnPostedCall());
+  }
+
+  if (epollDescriptor_ >= 0)
+    ::close(epollDescriptor_);
+}
+
+void
+FaceReactor::addFace(Face& face)
+{
+  if (faces_.find(&face) != faces_.end())
+    return;
+  if (face.node_->getTransport()->isAsync())
+    throw runtime_error
+      ("FaceReactor::addFace: The face transport must not be async");
+
+  ptr_lib::shared_ptr<FaceEntry> entry(new FaceEntry(face));
+  faces_[&face] = entry;
+
+  watchSocket(*entry);
+  if (entry->socketDescriptor_ < 0)
+    unconnectedFaces_.push_back(&face);
+
+  DelayedCallTable& delayedCallTable = face.node_->getDelayedCallTable();
+  delayedCallTable.setOnNewFirstCall
+    (bind(&FaceReactor::onNewFirstCall, this, &face, _1));
+  MillisecondsSince1970 nextCallTime = delayedCallTable.getNextCallTime();
+  if (nextCallTime >= 0)
+    scheduleTimer(*entry, nextCallTime);
+
+  // This also reports calls which were posted before the face was added.
+  face.node_->setOnPostedCall(bind(&FaceReactor::onPostedCall, this, &face));
+}
+
+void
+FaceReactor::removeFace(Face& face)
+{
+  map<Face*, ptr_lib::shared_ptr<FaceEntry> >::iterator found =
+    faces_.find(&face);
+  if (found == faces_.end())
+    return;
+
+  unwatchSocket(*found->second);
+  face.node_->getDelayedCallTable().setOnNewFirstCall
+    (DelayedCallTable::OnNewFirstCall());
+  face.node_->setOnPostedCall(Node::OnPostedCall());
+  vector<Face*>::iterator unconnected = find
+    (unconnectedFaces_.begin(), unconnectedFaces_.end(), &face);
+  if (unconnected != unconnectedFaces_.end())
+    unconnectedFaces_.erase(unconnected);
+  // Any timer for the face in timerHeap_ and any entry in postedFaces_ is
+  // skipped because the face is not in faces_.
+  faces_.erase(found);
+}
+
+void
+FaceReactor::processEvents(Milliseconds maxWaitMilliseconds)
+{
+  // Callbacks may have connected a face, such as with expressInterest.
+  for (size_t i = 0; i < unconnectedFaces_.size();) {
+    FaceEntry& entry = *faces_[unconnectedFaces_[i]];
+    watchSocket(entry);
+    if (entry.socketDescriptor_ >= 0)
+      unconnectedFaces_.erase(unconnectedFaces_.begin() + i);
+    else
+      ++i;
+  }
+
+  Milliseconds waitMilliseconds = maxWaitMilliseconds;
+  if (timerHeap_.size() > 0) {
+    Milliseconds untilNextCall =
+      timerHeap_.front().first - ndn_getNowMilliseconds();
+    if (untilNextCall < waitMilliseconds)
+      waitMilliseconds = untilNextCall;
+  }
+  {
+#if NDN_CPP_HAVE_STD_THREAD
+    lock_guard<mutex> lock(postedFacesMutex_);
+#endif
+    if (postedFaces_.size() > 0)
+      // Don't wait so that we call the posted calls now.
+      waitMilliseconds = 0;
+  }
+  // Round up so that we don't wake up just before the next call is due.
+  int timeoutMilliseconds =
+    waitMilliseconds > 0 ? (int)ceil(waitMilliseconds) : 0;
+
+#if NDN_CPP_HAVE_EPOLL_CREATE1
+  struct epoll_event events[MAX_READY_EVENTS];
+  int nEvents = epoll_wait
+    (epollDescriptor_, events, MAX_READY_EVENTS, timeoutMilliseconds);
+  if (nEvents < 0) {
+    if (errno != EINTR)
+      throw runtime_error("FaceReactor: Error in epoll_wait");
+    nEvents = 0;
+  }
+
+  for (int i = 0; i < nEvents; ++i) {
+    if (!events[i].data.ptr)
+      // The wakeup event. processPostedCalls clears it.
+      continue;
+
+    processReadyFace
+      ((Face*)events[i].data.ptr, (events[i].events & EPOLLIN) != 0,
+       (events[i].events & (EPOLLHUP | EPOLLRDHUP)) != 0,
+       (events[i].events & EPOLLERR) != 0);
+  }
+#else
+  // Without epoll, poll the wakeup event and the socket of each connected face.
+  vector<struct pollfd> pollInfo;
+  vector<Face*> pollFaces;
+  struct pollfd wakeupInfo;
+  wakeupInfo.fd = wakeupEvent_->getDescriptor();
+  wakeupInfo.events = POLLIN;
+  wakeupInfo.revents = 0;
+  pollInfo.push_back(wakeupInfo);
+  // A null face marks the wakeup event.
+  pollFaces.push_back(0);
+  for (map<Face*, ptr_lib::shared_ptr<FaceEntry> >::iterator i = faces_.begin();
+       i != faces_.end(); ++i) {
+    if (i->second->socketDescriptor_ < 0)
+      continue;
+
+    struct pollfd info;
+    info.fd = i->second->socketDescriptor_;
+    info.events = POLLIN;
+    info.revents = 0;
+    pollInfo.push_back(info);
+    pollFaces.push_back(i->first);
+  }
+
+  int nEvents = poll(&pollInfo[0], pollInfo.size(), timeoutMilliseconds);
+  if (nEvents < 0) {
+    if (errno != EINTR)
+      throw runtime_error("FaceReactor: Error in poll");
+    nEvents = 0;
+  }
+
+  for (size_t i = 0; i < pollInfo.size() && nEvents > 0; ++i) {
+    if (pollInfo[i].revents == 0)
+      continue;
+    --nEvents;
+    if (!pollFaces[i])
+      // The wakeup event. processPostedCalls clears it.
+      continue;
+
+    processReadyFace
+      (pollFaces[i], (pollInfo[i].revents & POLLIN) != 0,
+       (pollInfo[i].revents & POLLHUP) != 0,
+       (pollInfo[i].revents & POLLERR) != 0);
+  }
+#endif
+
+  processTimers();
+  processPostedCalls();
+}
+
+void
+FaceReactor::watchSocket(FaceEntry& entry)
+{
+  int socketDescriptor = entry.face_->node_->getTransport()->getSocketDescriptor();
+  if (socketDescriptor == entry.socketDescriptor_)
+    return;
+  unwatchSocket(entry);
+  if (socketDescriptor < 0)
+    return;
+
+#if NDN_CPP_HAVE_EPOLL_CREATE1
+  struct epoll_event event;
+  event.events = EPOLLIN | EPOLLRDHUP;
+  event.data.ptr = entry.face_;
+  if (epoll_ctl(epollDescriptor_, EPOLL_CTL_ADD, socketDescriptor, &event) < 0)
+    throw runtime_error("FaceReactor: Error in epoll_ctl");
+#endif
+  entry.socketDescriptor_ = socketDescriptor;
+}
+
+void
+FaceReactor::unwatchSocket(FaceEntry& entry)
+{
+  if (entry.socketDescriptor_ < 0)
+    return;
+
+#if NDN_CPP_HAVE_EPOLL_CREATE1
+  // Ignore the error if the socket was already closed, which removes it from
+  // the epoll set.
+  struct epoll_event event;
+  epoll_ctl(epollDescriptor_, EPOLL_CTL_DEL, entry.socketDescriptor_, &event);
+#endif
+  entry.socketDescriptor_ = -1;
+}
+
+void
+FaceReactor::processReadyFace
+  (Face* face, bool hasData, bool isClosed, bool hasError)
+{
+  map<Face*, ptr_lib::shared_ptr<FaceEntry> >::iterator found =
+    faces_.find(face);
+  if (found == faces_.end())
+    // A callback for another face removed this face.
+    return;
+
+  if (hasError) {
+    // Get the pending error to clear it, such as an ICMP error on a UDP
+    // socket, so that the socket doesn't stay ready.
+    int socketError;
+    socklen_t socketErrorLength = sizeof(socketError);
+    getsockopt(found->second->socketDescriptor_, SOL_SOCKET, SO_ERROR,
+               &socketError, &socketErrorLength);
+    _LOG_DEBUG("FaceReactor: Socket error " << socketError);
+  }
+
+  if (isClosed) {
+    // Stop waiting on the socket, which would stay ready. processEvents still
+    // receives the remaining data. The face is unconnected so that
+    // processEvents watches the socket again if the transport reconnects.
+    _LOG_DEBUG("FaceReactor: The connection of a face was closed");
+    unwatchSocket(*found->second);
+    unconnectedFaces_.push_back(face);
+  }
+
+  if (hasData || isClosed)
+    face->node_->getTransport()->processEvents();
+}
+
+void
+FaceReactor::processTimers()
+{
+  MillisecondsSince1970 now = ndn_getNowMilliseconds();
+  while (timerHeap_.size() > 0 && timerHeap_.front().first <= now) {
+    Timer timer = timerHeap_.front();
+    pop_heap(timerHeap_.begin(), timerHeap_.end(), greater<Timer>());
+    timerHeap_.pop_back();
+
+    map<Face*, ptr_lib::shared_ptr<FaceEntry> >::iterator found =
+      faces_.find(timer.second);
+    if (found == faces_.end() || found->second->callTime_ != timer.first)
+      // The timer is stale.
+      continue;
+
+    ptr_lib::shared_ptr<FaceEntry> entry = found->second;
+    entry->callTime_ = -1;
+    DelayedCallTable& delayedCallTable =
+      entry->face_->node_->getDelayedCallTable();
+    try {
+      delayedCallTable.callTimedOut();
+    } catch (...) {
+      if (faces_.find(timer.second) != faces_.end()) {
+        MillisecondsSince1970 nextCallTime = delayedCallTable.getNextCallTime();
+        if (nextCallTime >= 0)
+          scheduleTimer(*entry, nextCallTime);
+      }
+      throw;
+    }
+
+    // A callback may have removed the face.
+    if (faces_.find(timer.second) != faces_.end()) {
+      MillisecondsSince1970 nextCallTime = delayedCallTable.getNextCallTime();
+      if (nextCallTime >= 0)
+        scheduleTimer(*entry, nextCallTime);
+    }
+  }
+}
+
+void
+FaceReactor::onNewFirstCall(Face* face, MillisecondsSince1970 callTime)
+{
+  map<Face*, ptr_lib::shared_ptr<FaceEntry> >::iterator found =
+    faces_.find(face);
+  if (found != faces_.end())
+    scheduleTimer(*found->second, callTime);
+}
+
+void
+FaceReactor::onPostedCall(Face* face)
+{
+#if NDN_CPP_HAVE_STD_THREAD
+  lock_guard<mutex> lock(postedFacesMutex_);
+#endif
+  if (postedFaces_.size() == 0)
+    // End the wait in processEvents.
+    wakeupEvent_->signal();
+  postedFaces_.push_back(face);
+}
+
+void
+FaceReactor::processPostedCalls()
+{
+  vector<Face*> postedFaces;
+  {
+#if NDN_CPP_HAVE_STD_THREAD
+    lock_guard<mutex> lock(postedFacesMutex_);
+#endif
+    postedFaces.swap(postedFaces_);
+    wakeupEvent_->clear();
+  }
+
+  for (size_t i = 0; i < postedFaces.size(); ++i) {
+    // A callback may have removed the face.
+    if (faces_.find(postedFaces[i]) == faces_.end())
+      continue;
+
+    try {
+      postedFaces[i]->node_->processPostedCalls();
+    } catch (...) {
+      // Check the remaining faces on the next call.
+#if NDN_CPP_HAVE_STD_THREAD
+      lock_guard<mutex> lock(postedFacesMutex_);
+#endif
+      postedFaces_.insert
+        (postedFaces_.end(), postedFaces.begin() + i, postedFaces.end());
+      throw;
+    }
+  }
+}
+
+void
+FaceReactor::scheduleTimer(FaceEntry& entry, MillisecondsSince1970 callTime)
+{
+  if (entry.callTime_ >= 0 && entry.callTime_ <= callTime)
+    // The existing timer is soon enough.
+    return;
+
+  // Any later timer for the entry becomes stale.
+  entry.callTime_ = callTime;
+  timerHeap_.push_back(Timer(callTime, entry.face_));
+  push_heap(timerHeap_.begin(), timerHeap_.end(), greater<Timer>());
+}
+
+#else // NDN_CPP_HAVE_UNISTD_H
+
+// Without Unix sockets there are no socket transports, so the constructor
+// throws so that the other methods are never called.
+
+FaceReactor::FaceReactor()
+: epollDescriptor_(-1)
+{
+  throw runtime_error("FaceReactor is not supported on this platform");
+}
+
+FaceReactor::~FaceReactor() {}
+
+void
+FaceReactor::addFace(Face& face) {}
+
+void
+FaceReactor::removeFace(Face& face) {}
+
+void
+FaceReactor::processEvents(Milliseconds maxWaitMilliseconds) {}
+
+#endif // NDN_CPP_HAVE_UNISTD_H
+
+}
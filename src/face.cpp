@@ -218,6 +218,12 @@ Face::send(const uint8_t *encoding, size_t encodingLength)
   node_->send(encoding, encodingLength);
 }
 
+void
+Face::flush()
+{
+  node_->flush();
+}
+
 void
 Face::processEvents()
 {
@@ -225,22 +231,145 @@ Face::processEvents()
   node_->processEvents();
 }
 
+void
+Face::processEvents(Milliseconds maxWaitMilliseconds)
+{
+  node_->processEvents(maxWaitMilliseconds);
+}
+
 bool
 Face::isLocal()
 {
   return node_->isLocal();
 }
 
+uint64_t
+Face::getNReceivedPackets() const
+{
+  return node_->getNReceivedPackets();
+}
+
+uint64_t
+Face::getNReceivedPacketAllocations() const
+{
+  return node_->getNReceivedPacketAllocations();
+}
+
 void
 Face::shutdown()
 {
   node_->shutdown();
 }
 
+/**
+ * A CancellableCallback is the Face::CancellableCall from the default
+ * Face::callLaterCancellable. cancel() releases the callback. If the default
+ * Face::callLater added the call to the DelayedCallTable of Node, cancel() also
+ * removes the table entry.
+ */
+class CancellableCallback : public Face::CancellableCall {
+public:
+  CancellableCallback(const Face::Callback& callback)
+  : callback_(callback), delayedCallTable_(0)
+  {
+  }
+
+  /**
+   * Call the callback, unless cancel() was called.
+   */
+  void
+  call()
+  {
+    // The callback may call cancel(), so don't release it while it runs.
+    Face::Callback callback;
+    callback.swap(callback_);
+    if (callback)
+      callback();
+  }
+
+  virtual void
+  cancel()
+  {
+    callback_ = Face::Callback();
+    if (delayedCallTable_)
+      delayedCallTable_->cancel(delayedCall_.lock());
+  }
+
+  /**
+   * Set the DelayedCallTable entry which cancel() removes.
+   * @param delayedCallTable The DelayedCallTable which has the entry.
+   * @param delayedCall The entry from delayedCallTable.callLater.
+   */
+  void
+  setDelayedCall
+    (DelayedCallTable& delayedCallTable,
+     const ptr_lib::shared_ptr<DelayedCallTable::Entry>& delayedCall)
+  {
+    delayedCallTable_ = &delayedCallTable;
+    delayedCall_ = delayedCall;
+  }
+
+private:
+  Face::Callback callback_;
+  DelayedCallTable* delayedCallTable_;
+  ptr_lib::weak_ptr<DelayedCallTable::Entry> delayedCall_;
+};
+
+/**
+ * CallCancellableCallback is the function object which the default
+ * Face::callLaterCancellable passes to callLater. It keeps the
+ * CancellableCallback alive until the call is made. The default Face::callLater
+ * checks for this type so that it can give the DelayedCallTable entry to the
+ * CancellableCallback.
+ */
+class CallCancellableCallback {
+public:
+  CallCancellableCallback
+    (const ptr_lib::shared_ptr<CancellableCallback>& cancellableCallback)
+  : cancellableCallback_(cancellableCallback)
+  {
+  }
+
+  void
+  operator()() const { cancellableCallback_->call(); }
+
+  ptr_lib::shared_ptr<CancellableCallback> cancellableCallback_;
+};
+
 void
 Face::callLater(Milliseconds delayMilliseconds, const Callback& callback)
 {
-  node_->callLater(delayMilliseconds, callback);
+  const CallCancellableCallback* call =
+    callback.target<CallCancellableCallback>();
+  if (call)
+    // This is from callLaterCancellable, so save the entry so that cancel()
+    // removes it from the table.
+    call->cancellableCallback_->setDelayedCall
+      (node_->getDelayedCallTable(),
+       node_->getDelayedCallTable().callLater(delayMilliseconds, callback));
+  else
+    node_->callLater(delayMilliseconds, callback);
+}
+
+Face::CancellableCall::~CancellableCall()
+{
+}
+
+ptr_lib::shared_ptr<Face::CancellableCall>
+Face::callLaterCancellable
+  (Milliseconds delayMilliseconds, const Callback& callback)
+{
+  ptr_lib::shared_ptr<CancellableCallback> cancellableCallback
+    (new CancellableCallback(callback));
+  // Use the virtual callLater in case a subclass overrides it.
+  callLater(delayMilliseconds, CallCancellableCallback(cancellableCallback));
+  return cancellableCallback;
+}
+
+void
+Face::post(const Callback& callback)
+{
+  node_->post(callback);
 }
 
 }
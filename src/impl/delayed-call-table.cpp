@@ -27,33 +27,91 @@ using namespace std;
 
 namespace ndn {
 
-void
+ptr_lib::shared_ptr<DelayedCallTable::Entry>
 DelayedCallTable::callLater
   (Milliseconds delayMilliseconds, const Face::Callback& callback)
 {
-  ptr_lib::shared_ptr<Entry> entry(new Entry(delayMilliseconds, callback));
-  // Insert into table_, sorted on getCallTime().
-  table_.insert
-    (lower_bound(table_.begin(), table_.end(), entry, entryCompare_), entry);
+  ptr_lib::shared_ptr<Entry> entry
+    (new Entry(delayMilliseconds, callback, ++lastSequenceNumber_));
+  table_.push_back(entry);
+  push_heap(table_.begin(), table_.end(), entryCompare_);
+  if (onNewFirstCall_ && table_.front() == entry)
+    onNewFirstCall_(entry->callTime_);
+  return entry;
+}
+
+void
+DelayedCallTable::cancel(const ptr_lib::shared_ptr<Entry>& entry)
+{
+  if (!entry || !entry->isInTable_ || entry->isCancelled_)
+    return;
+
+  entry->isCancelled_ = true;
+  // Release the callback now. The entry stays in the heap until it reaches
+  // the front or removeCancelled removes it.
+  entry->callback_ = Face::Callback();
+  ++nCancelled_;
+
+  // Don't let cancelled entries take up most of the table.
+  if (nCancelled_ > 64 && nCancelled_ > table_.size() / 2)
+    removeCancelled();
 }
 
 void
 DelayedCallTable::callTimedOut()
 {
   MillisecondsSince1970 now = ndn_getNowMilliseconds();
-  // table_ is sorted on _callTime, so we only need to process the timed-out
-  // entries at the front, then quit.
+  // table_ is a heap on the call time, so we only need to process the
+  // timed-out entries at the front, then quit.
   while (table_.size() > 0 && table_.front()->getCallTime() <= now) {
     ptr_lib::shared_ptr<Entry> entry = table_.front();
-    table_.erase(table_.begin());
-    entry->callCallback();
+    pop_heap(table_.begin(), table_.end(), entryCompare_);
+    table_.pop_back();
+    entry->isInTable_ = false;
+
+    if (entry->isCancelled_)
+      --nCancelled_;
+    else
+      entry->callCallback();
   }
 }
 
+MillisecondsSince1970
+DelayedCallTable::getNextCallTime()
+{
+  while (table_.size() > 0 && table_.front()->isCancelled_) {
+    pop_heap(table_.begin(), table_.end(), entryCompare_);
+    table_.back()->isInTable_ = false;
+    table_.pop_back();
+    --nCancelled_;
+  }
+
+  if (table_.size() == 0)
+    return -1;
+  return table_.front()->getCallTime();
+}
+
+void
+DelayedCallTable::removeCancelled()
+{
+  size_t nKept = 0;
+  for (size_t i = 0; i < table_.size(); ++i) {
+    if (table_[i]->isCancelled_)
+      table_[i]->isInTable_ = false;
+    else
+      table_[nKept++] = table_[i];
+  }
+  table_.resize(nKept);
+  make_heap(table_.begin(), table_.end(), entryCompare_);
+  nCancelled_ = 0;
+}
+
 DelayedCallTable::Entry::Entry
-  (Milliseconds delayMilliseconds, const Face::Callback& callback)
+  (Milliseconds delayMilliseconds, const Face::Callback& callback,
+   uint64_t sequenceNumber)
   : callback_(callback),
-    callTime_(ndn_getNowMilliseconds() + delayMilliseconds)
+    callTime_(ndn_getNowMilliseconds() + delayMilliseconds),
+    sequenceNumber_(sequenceNumber), isInTable_(true), isCancelled_(false)
 {
 }
 
@@ -22,40 +22,32 @@
 #ifndef NDN_DELAYED_CALL_TABLE_HPP
 #define NDN_DELAYED_CALL_TABLE_HPP
 
-#include <deque>
+#include <vector>
 #include <ndn-cpp/face.hpp>
 
 namespace ndn {
 
+/**
+ * A DelayedCallTable is an internal class to hold the callbacks for callLater
+ * in a binary heap ordered on the call time. A call can be cancelled with the
+ * Entry returned by callLater.
+ */
 class DelayedCallTable {
 public:
-  /**
-   * Call callback() after the given delay. This adds to the delayed call
-   * table which is used by callTimedOut().
-   * @param delayMilliseconds The delay in milliseconds.
-   * @param callback This calls callback() after the delay.
-   */
-  void
-  callLater(Milliseconds delayMilliseconds, const Face::Callback& callback);
-
-  /**
-   * Call and remove timed-out callback entries. Since callLater does a sorted
-   * insert into the delayed call table, the check for timed-out entries is
-   * quick and does not require searching the entire table.
-   */
-  void
-  callTimedOut();
-
-private:
   class Entry {
   public:
     /**
      * Create a new DelayedCallTable::Entry and set the call time based on the
-     * current time and the delayMilliseconds.
+     * current time and the delayMilliseconds. Note: You should not call this
+     * directly but call DelayedCallTable::callLater.
      * @param delayMilliseconds The delay in milliseconds.
      * @param callback This calls callback() after the delay.
+     * @param sequenceNumber The sequence number used to call entries with the
+     * same call time in the order they were added.
      */
-    Entry(Milliseconds delayMilliseconds, const Face::Callback& callback);
+    Entry
+      (Milliseconds delayMilliseconds, const Face::Callback& callback,
+       uint64_t sequenceNumber);
 
     /**
      * Get the time at which the callback should be called.
@@ -64,6 +56,13 @@ private:
     MillisecondsSince1970
     getCallTime() const { return callTime_; }
 
+    /**
+     * Check if DelayedCallTable::cancel was called for this entry.
+     * @return True if this entry is cancelled.
+     */
+    bool
+    getIsCancelled() const { return isCancelled_; }
+
     /**
      * Call the callback given to the constructor. This does not catch
      * exceptions.
@@ -72,27 +71,112 @@ private:
     callCallback() const { callback_(); }
 
     /**
-     * Compare shared_ptrs to Entry based only on callTime_.
+     * Compare shared_ptrs to Entry based on callTime_ (then the sequence
+     * number) so that the entry to call first is at the top of a std heap.
      */
     class Compare {
     public:
       bool
       operator()
-        (const ptr_lib::shared_ptr<const Entry>& x,
-         const ptr_lib::shared_ptr<const Entry>& y) const
+        (const ptr_lib::shared_ptr<Entry>& x,
+         const ptr_lib::shared_ptr<Entry>& y) const
       {
-        return x->callTime_ < y->callTime_;
+        if (x->callTime_ != y->callTime_)
+          return x->callTime_ > y->callTime_;
+        return x->sequenceNumber_ > y->sequenceNumber_;
       }
     };
 
   private:
-    const Face::Callback callback_;
+    friend class DelayedCallTable;
+
+    Face::Callback callback_;
     MillisecondsSince1970 callTime_;
+    uint64_t sequenceNumber_;
+    bool isInTable_;
+    bool isCancelled_;
   };
 
-  // Use a deque so we can efficiently remove from the front.
-  std::deque<ptr_lib::shared_ptr<Entry> > table_;
+  /**
+   * OnNewFirstCall(callTime) is called when callLater adds a call which is
+   * now the next call in the table.
+   */
+  typedef func_lib::function<void(MillisecondsSince1970 callTime)>
+    OnNewFirstCall;
+
+  DelayedCallTable()
+  : lastSequenceNumber_(0), nCancelled_(0)
+  {
+  }
+
+  /**
+   * Call callback() after the given delay. This adds to the delayed call
+   * table which is used by callTimedOut().
+   * @param delayMilliseconds The delay in milliseconds.
+   * @param callback This calls callback() after the delay.
+   * @return The new Entry which can be passed to cancel().
+   */
+  ptr_lib::shared_ptr<Entry>
+  callLater(Milliseconds delayMilliseconds, const Face::Callback& callback);
+
+  /**
+   * Cancel the call so that callTimedOut() does not call it, and release the
+   * callback. If the entry was already called or cancelled, or is null, do
+   * nothing.
+   * @param entry The Entry returned by callLater.
+   */
+  void
+  cancel(const ptr_lib::shared_ptr<Entry>& entry);
+
+  /**
+   * Call and remove timed-out callback entries. Since the table is a heap
+   * ordered on the call time, the check for timed-out entries is quick and
+   * does not require searching the entire table.
+   */
+  void
+  callTimedOut();
+
+  /**
+   * Get the call time of the next call which is not cancelled. This removes
+   * cancelled entries from the front of the table.
+   * @return The call time in milliseconds, similar to ndn_getNowMilliseconds,
+   * or -1 if the table has no calls.
+   */
+  MillisecondsSince1970
+  getNextCallTime();
+
+  /**
+   * Get the number of calls in the table which are not cancelled.
+   * @return The number of calls.
+   */
+  size_t
+  size() const { return table_.size() - nCancelled_; }
+
+  /**
+   * Set the callback for when callLater adds a call which is now the next
+   * call in the table. This lets an event loop such as FaceReactor wait on
+   * the call times of several tables.
+   * @param onNewFirstCall The callback, or an empty OnNewFirstCall() for none.
+   */
+  void
+  setOnNewFirstCall(const OnNewFirstCall& onNewFirstCall)
+  {
+    onNewFirstCall_ = onNewFirstCall;
+  }
+
+private:
+  /**
+   * Remove the cancelled entries from table_ and restore the heap.
+   */
+  void
+  removeCancelled();
+
+  // A heap ordered by entryCompare_, so the next call is at front().
+  std::vector<ptr_lib::shared_ptr<Entry> > table_;
   Entry::Compare entryCompare_;
+  uint64_t lastSequenceNumber_;
+  size_t nCancelled_;
+  OnNewFirstCall onNewFirstCall_;
 };
 
 }
@@ -19,6 +19,7 @@
  * A copy of the GNU Lesser General Public License is in the file COPYING.
  */
 
+#include <algorithm>
 #include <ndn-cpp/util/logging.hpp>
 #include "interest-filter-table.hpp"
 
@@ -28,33 +29,68 @@ using namespace std;
 
 namespace ndn {
 
+void
+InterestFilterTable::setInterestFilter
+  (uint64_t interestFilterId,
+   const ptr_lib::shared_ptr<const InterestFilter>& filterCopy,
+   const OnInterestCallback& onInterest, Face* face)
+{
+  ptr_lib::shared_ptr<Entry> entry = ptr_lib::make_shared<Entry>
+    (interestFilterId, filterCopy, onInterest, face);
+  entriesById_[interestFilterId] = entry;
+  entriesByPrefix_.add
+    (filterCopy->getPrefix(), filterCopy->getPrefix().size(), entry);
+}
+
+/**
+ * Compare shared_ptrs to InterestFilterTable::Entry based on the
+ * interestFilterId, which increases in the order that filters are added.
+ */
+static bool
+isAddedBefore
+  (const ptr_lib::shared_ptr<InterestFilterTable::Entry>& x,
+   const ptr_lib::shared_ptr<InterestFilterTable::Entry>& y)
+{
+  return x->getInterestFilterId() < y->getInterestFilterId();
+}
+
 void
 InterestFilterTable::getMatchedFilters
   (const Interest& interest,
     std::vector<ptr_lib::shared_ptr<Entry> > &matchedFilters)
 {
-  for (size_t i = 0; i < table_.size(); ++i) {
-    ptr_lib::shared_ptr<Entry> &entry = table_[i];
-    if (entry->getFilter()->doesMatch(interest.getName()))
+  // Get the entries whose filter prefix matches the interest name.
+  vector<ptr_lib::shared_ptr<Entry> > candidates;
+  entriesByPrefix_.getPrefixValues(interest.getName(), candidates);
+
+  size_t nMatchedBefore = matchedFilters.size();
+  for (size_t i = 0; i < candidates.size(); ++i) {
+    ptr_lib::shared_ptr<Entry> &entry = candidates[i];
+    // The prefix already matches, so we only need doesMatch for the regex.
+    if (!entry->getFilter()->hasRegexFilter() ||
+        entry->getFilter()->doesMatch(interest.getName()))
       matchedFilters.push_back(entry);
   }
+
+  // The prefix tree returns shorter prefixes first, so restore the order in
+  // which the filters were added.
+  sort(matchedFilters.begin() + nMatchedBefore, matchedFilters.end(),
+       isAddedBefore);
 }
 
 void
 InterestFilterTable::unsetInterestFilter(uint64_t interestFilterId)
 {
-  int count = 0;
-  // Go backwards through the list so we can erase entries.
-  // Remove all entries even though interestFilterId should be unique.
-  for (int i = (int)table_.size() - 1; i >= 0; --i) {
-    if (table_[i]->getInterestFilterId() == interestFilterId) {
-      ++count;
-      table_.erase(table_.begin() + i);
-    }
+  map<uint64_t, ptr_lib::shared_ptr<Entry> >::iterator found =
+    entriesById_.find(interestFilterId);
+  if (found == entriesById_.end()) {
+    _LOG_DEBUG("unsetInterestFilter: Didn't find interestFilterId " << interestFilterId);
+    return;
   }
 
-  if (count == 0)
-    _LOG_DEBUG("unsetInterestFilter: Didn't find interestFilterId " << interestFilterId);
+  const Name& prefix = found->second->getFilter()->getPrefix();
+  entriesByPrefix_.remove(prefix, prefix.size(), found->second);
+  entriesById_.erase(found);
 }
 
 }
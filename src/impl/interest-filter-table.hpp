@@ -22,13 +22,17 @@
 #ifndef NDN_INTEREST_FILTER_TABLE_HPP
 #define NDN_INTEREST_FILTER_TABLE_HPP
 
+#include <map>
 #include <ndn-cpp/face.hpp>
+#include "name-prefix-tree.hpp"
 
 namespace ndn {
 
 /**
  * An InterestFilterTable is an internal class to hold a list of entries with
- * an interest Filter and its OnInterestCallback.
+ * an interest Filter and its OnInterestCallback. The entries are indexed by
+ * interestFilterId and by the filter prefix so that an incoming interest is
+ * only checked against the filters whose prefix matches the interest name.
  */
 class InterestFilterTable {
 public:
@@ -113,19 +117,15 @@ public:
   setInterestFilter
     (uint64_t interestFilterId,
      const ptr_lib::shared_ptr<const InterestFilter>& filterCopy,
-     const OnInterestCallback& onInterest, Face* face)
-  {
-    table_.push_back(ptr_lib::make_shared<Entry>
-      (interestFilterId, filterCopy, onInterest, face));
-  }
+     const OnInterestCallback& onInterest, Face* face);
 
   /**
    * Find all entries from the interest filter table where the interest conforms
    * to the entry's filter, and add to the matchedFilters list.
    * @param interest The interest which may match the filter in multiple entries.
    * @param matchedFilters Add each matching InterestFilterTable.Entry from the
-   * interest filter table.  The caller should pass in a reference to an empty
-   * vector.
+   * interest filter table, in the order that the filters were added. The
+   * caller should pass in a reference to an empty vector.
    */
   void
   getMatchedFilters
@@ -143,7 +143,8 @@ public:
   unsetInterestFilter(uint64_t interestFilterId);
 
 private:
-  std::vector<ptr_lib::shared_ptr<Entry> > table_;
+  std::map<uint64_t, ptr_lib::shared_ptr<Entry> > entriesById_;
+  NamePrefixTree<ptr_lib::shared_ptr<Entry> > entriesByPrefix_;
 };
 
 }
@@ -0,0 +1,188 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2017 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+#ifndef NDN_NAME_PREFIX_TREE_HPP
+#define NDN_NAME_PREFIX_TREE_HPP
+
+#include <algorithm>
+#include <map>
+#include <vector>
+#include <ndn-cpp/name.hpp>
+
+namespace ndn {
+
+/**
+ * A NamePrefixTree is an internal class which indexes values by name, using
+ * one tree node per name component. To find the values for every prefix of a
+ * name, walk down the tree along the components of the name, so that the cost
+ * depends on the length of the name and not on the number of values in the
+ * tree. The children of each node are ordered by Name::Component::compare.
+ * @param T The value type, which must have operator== (typically a shared_ptr
+ * to an internal table entry).
+ */
+template<class T> class NamePrefixTree {
+public:
+  NamePrefixTree()
+  : size_(0)
+  {
+  }
+
+  /**
+   * Add the value to the tree node for the first nComponents of the name.
+   * This does not check if the value is already in the node.
+   * @param name The name for the value.
+   * @param nComponents The number of components of the name to use.
+   * @param value The value to add.
+   */
+  void
+  add(const Name& name, size_t nComponents, const T& value)
+  {
+    Node* node = &root_;
+    for (size_t i = 0; i < nComponents; ++i) {
+      ptr_lib::shared_ptr<Node>& child = node->children_[name.get(i)];
+      if (!child)
+        child.reset(new Node());
+      node = child.get();
+    }
+
+    node->values_.push_back(value);
+    ++size_;
+  }
+
+  /**
+   * Remove the first value equal to the given value from the tree node for the
+   * first nComponents of the name, and remove tree nodes which are left empty.
+   * @param name The name which was given to add().
+   * @param nComponents The number of components which was given to add().
+   * @param value The value to remove.
+   * @return True if the value was removed, false if it was not found.
+   */
+  bool
+  remove(const Name& name, size_t nComponents, const T& value)
+  {
+    // Save the path so that we can remove empty nodes on the way back up.
+    std::vector<Node*> path;
+    path.reserve(nComponents + 1);
+    Node* node = &root_;
+    path.push_back(node);
+    for (size_t i = 0; i < nComponents; ++i) {
+      typename ChildMap::iterator child = node->children_.find(name.get(i));
+      if (child == node->children_.end())
+        return false;
+      node = child->second.get();
+      path.push_back(node);
+    }
+
+    typename std::vector<T>::iterator found = std::find
+      (node->values_.begin(), node->values_.end(), value);
+    if (found == node->values_.end())
+      return false;
+    node->values_.erase(found);
+    --size_;
+
+    for (size_t i = nComponents; i > 0; --i) {
+      Node* child = path[i];
+      if (child->values_.size() > 0 || child->children_.size() > 0)
+        break;
+      path[i - 1]->children_.erase(name.get(i - 1));
+    }
+
+    return true;
+  }
+
+  /**
+   * Append to values all the values whose name is a prefix of the given name
+   * (including the name itself). Values for shorter prefixes come first.
+   * @param name The name to search for.
+   * @param values Append the matching values to this vector.
+   */
+  void
+  getPrefixValues(const Name& name, std::vector<T>& values) const
+  {
+    const Node* node = &root_;
+    for (size_t i = 0; true; ++i) {
+      values.insert(values.end(), node->values_.begin(), node->values_.end());
+      if (i >= name.size())
+        break;
+
+      typename ChildMap::const_iterator child = node->children_.find(name.get(i));
+      if (child == node->children_.end())
+        break;
+      node = child->second.get();
+    }
+  }
+
+  /**
+   * Append to values all the values whose name has the given prefix (including
+   * the prefix itself).
+   * @param prefix The prefix to search for.
+   * @param values Append the matching values to this vector.
+   */
+  void
+  getValuesWithPrefix(const Name& prefix, std::vector<T>& values) const
+  {
+    const Node* node = &root_;
+    for (size_t i = 0; i < prefix.size(); ++i) {
+      typename ChildMap::const_iterator child = node->children_.find(prefix.get(i));
+      if (child == node->children_.end())
+        return;
+      node = child->second.get();
+    }
+
+    appendSubtreeValues(*node, values);
+  }
+
+  /**
+   * Get the number of values in the tree.
+   * @return The number of values.
+   */
+  size_t
+  size() const { return size_; }
+
+private:
+  class Node;
+  typedef std::map<Name::Component, ptr_lib::shared_ptr<Node> > ChildMap;
+
+  class Node {
+  public:
+    ChildMap children_;
+    std::vector<T> values_;
+  };
+
+  /**
+   * Append to values the values of the node and of all its descendants.
+   */
+  static void
+  appendSubtreeValues(const Node& node, std::vector<T>& values)
+  {
+    values.insert(values.end(), node.values_.begin(), node.values_.end());
+    for (typename ChildMap::const_iterator child = node.children_.begin();
+         child != node.children_.end(); ++child)
+      appendSubtreeValues(*child->second, values);
+  }
+
+  Node root_;
+  size_t size_;
+};
+
+}
+
+#endif
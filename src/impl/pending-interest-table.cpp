@@ -44,24 +44,34 @@ PendingInterestTable::Entry::callTimeout()
   }
 }
 
+/**
+ * Compare shared_ptrs to PendingInterestTable::Entry based on the
+ * pendingInterestId, which increases in the order that interests are expressed.
+ */
+static bool
+isExpressedAfter
+  (const ptr_lib::shared_ptr<PendingInterestTable::Entry>& x,
+   const ptr_lib::shared_ptr<PendingInterestTable::Entry>& y)
+{
+  return x->getPendingInterestId() > y->getPendingInterestId();
+}
+
 ptr_lib::shared_ptr<PendingInterestTable::Entry>
 PendingInterestTable::add
   (uint64_t pendingInterestId,
    const ptr_lib::shared_ptr<const Interest>& interestCopy, const OnData& onData,
    const OnTimeout& onTimeout, const OnNetworkNack& onNetworkNack)
 {
-  vector<uint64_t>::iterator removeRequestIterator =
-    ::find(removeRequests_.begin(), removeRequests_.end(), pendingInterestId);
-  if (removeRequestIterator != removeRequests_.end()) {
+  if (removeRequests_.erase(pendingInterestId) > 0)
     // removePendingInterest was called with the pendingInterestId returned by
     //   expressInterest before we got here, so don't add a PIT entry.
-    removeRequests_.erase(removeRequestIterator);
     return ptr_lib::shared_ptr<Entry>();
-  }
 
   ptr_lib::shared_ptr<Entry> entry(new Entry
     (pendingInterestId, interestCopy, onData, onTimeout, onNetworkNack));
-  table_.push_back(entry);
+  entriesById_[pendingInterestId] = entry;
+  entriesByName_.add
+    (interestCopy->getName(), getIndexLength(interestCopy->getName()), entry);
   return entry;
 }
 
@@ -69,15 +79,20 @@ void
 PendingInterestTable::extractEntriesForExpressedInterest
   (const Data& data, vector<ptr_lib::shared_ptr<Entry> > &entries)
 {
-  // Go backwards through the list so we can erase entries.
-  for (int i = (int)table_.size() - 1; i >= 0; --i) {
-    ptr_lib::shared_ptr<Entry>& pendingInterest = table_[i];
+  // Only an interest whose name is a prefix of the data name can match, so
+  // only check the entries along the data name in the name index.
+  vector<ptr_lib::shared_ptr<Entry> > candidates;
+  entriesByName_.getPrefixValues(data.getName(), candidates);
+  // The prefix tree returns shorter prefixes first, so check the entries with
+  // the most recently expressed interest first.
+  sort(candidates.begin(), candidates.end(), isExpressedAfter);
+
+  for (size_t i = 0; i < candidates.size(); ++i) {
+    ptr_lib::shared_ptr<Entry>& pendingInterest = candidates[i];
     if (pendingInterest->getInterest()->matchesData(data)) {
       entries.push_back(pendingInterest);
-      // We let the callback from callLater call _processInterestTimeout, but
-      // for efficiency, mark this as removed so that it returns right away.
-      pendingInterest->setIsRemoved();
-      table_.erase(table_.begin() + i);
+      // This also cancels the timeout call.
+      erase(pendingInterest);
     }
   }
 }
@@ -88,9 +103,14 @@ PendingInterestTable::extractEntriesForNackInterest
 {
   SignedBlob encoding = interest.wireEncode();
 
-  // Go backwards through the list so we can erase entries.
-  for (int i = (int)table_.size() - 1; i >= 0; --i) {
-    ptr_lib::shared_ptr<Entry>& pendingInterest = table_[i];
+  // An entry with the same encoding has the same name, so only check the
+  // entries along the interest name in the name index.
+  vector<ptr_lib::shared_ptr<Entry> > candidates;
+  entriesByName_.getPrefixValues(interest.getName(), candidates);
+  sort(candidates.begin(), candidates.end(), isExpressedAfter);
+
+  for (size_t i = 0; i < candidates.size(); ++i) {
+    ptr_lib::shared_ptr<Entry>& pendingInterest = candidates[i];
     if (!pendingInterest->getOnNetworkNack())
       continue;
 
@@ -98,42 +118,32 @@ PendingInterestTable::extractEntriesForNackInterest
     // it was the default wire encoding).
     if (pendingInterest->getInterest()->wireEncode().equals(encoding)) {
       entries.push_back(pendingInterest);
-      // We let the callback from callLater call _processInterestTimeout, but
-      // for efficiency, mark this as removed so that it returns right away.
-      pendingInterest->setIsRemoved();
-      table_.erase(table_.begin() + i);
+      // This also cancels the timeout call.
+      erase(pendingInterest);
     }
   }
 }
 
-void
+ptr_lib::shared_ptr<PendingInterestTable::Entry>
 PendingInterestTable::removePendingInterest(uint64_t pendingInterestId)
 {
-  int count = 0;
-  // Go backwards through the list so we can erase entries.
-  // Remove all entries even though pendingInterestId should be unique.
-  for (int i = (int)table_.size() - 1; i >= 0; --i) {
-    if (table_[i]->getPendingInterestId() == pendingInterestId) {
-      ++count;
-      // For efficiency, mark this as removed so that processInterestTimeout
-      // doesn't look for it.
-      table_[i]->setIsRemoved();
-      table_.erase(table_.begin() + i);
-    }
+  map<uint64_t, ptr_lib::shared_ptr<Entry> >::iterator found =
+    entriesById_.find(pendingInterestId);
+  if (found != entriesById_.end()) {
+    // Mark this as removed and cancel the timeout call.
+    // Copy the shared_ptr since erase removes it from entriesById_.
+    ptr_lib::shared_ptr<Entry> entry = found->second;
+    erase(entry);
+    return entry;
   }
 
-  if (count == 0)
-    _LOG_DEBUG("removePendingInterest: Didn't find pendingInterestId " << pendingInterestId);
-
-  if (count == 0) {
-    // The pendingInterestId was not found. Perhaps this has been called before
-    //   the callback in expressInterest can add to the PIT. Add this
-    //   removal request which will be checked before adding to the PIT.
-    if (::find(removeRequests_.begin(), removeRequests_.end(), pendingInterestId)
-        == removeRequests_.end())
-      // Not already requested, so add the request.
-      removeRequests_.push_back(pendingInterestId);
-  }
+  _LOG_DEBUG("removePendingInterest: Didn't find pendingInterestId " << pendingInterestId);
+
+  // The pendingInterestId was not found. Perhaps this has been called before
+  //   the callback in expressInterest can add to the PIT. Add this
+  //   removal request which will be checked before adding to the PIT.
+  removeRequests_.insert(pendingInterestId);
+  return ptr_lib::shared_ptr<Entry>();
 }
 
 bool
@@ -146,16 +156,35 @@ PendingInterestTable::removeEntry
     // Do nothing.
     return false;
 
-  // Search by pointer equality.
-  for (size_t i = 0; i < table_.size(); ++i) {
-    if (table_[i].get() == pendingInterest.get()) {
-      table_[i]->setIsRemoved();
-      table_.erase(table_.begin() + i);
-      return true;
-    }
-  }
+  map<uint64_t, ptr_lib::shared_ptr<Entry> >::iterator found =
+    entriesById_.find(pendingInterest->getPendingInterestId());
+  // Check pointer equality in case this is an entry from another table.
+  if (found == entriesById_.end() || found->second.get() != pendingInterest.get())
+    return false;
+
+  erase(pendingInterest);
+  return true;
+}
 
-  return false;
+void
+PendingInterestTable::erase(const ptr_lib::shared_ptr<Entry>& entry)
+{
+  entry->setIsRemoved();
+  entriesById_.erase(entry->getPendingInterestId());
+  const Name& name = entry->getInterest()->getName();
+  entriesByName_.remove(name, getIndexLength(name), entry);
+  // Release the timeout callback now instead of when the timeout expires.
+  entry->cancelTimeoutCall();
+}
+
+size_t
+PendingInterestTable::getIndexLength(const Name& interestName)
+{
+  if (interestName.size() > 0 &&
+      interestName.get(-1).isImplicitSha256Digest())
+    return interestName.size() - 1;
+  else
+    return interestName.size();
 }
 
 }
@@ -22,13 +22,18 @@
 #ifndef NDN_PENDING_INTEREST_TABLE_HPP
 #define NDN_PENDING_INTEREST_TABLE_HPP
 
+#include <map>
+#include <set>
 #include <ndn-cpp/face.hpp>
+#include "name-prefix-tree.hpp"
 
 namespace ndn {
 
 /**
  * A PendingInterestTable is an internal class to hold a list of pending
- * interests with their callbacks.
+ * interests with their callbacks. The entries are indexed by pendingInterestId
+ * and by interest name so that finding the entries for an incoming Data packet
+ * or removing an entry does not need to search the entire table.
  */
 class PendingInterestTable {
 public:
@@ -100,12 +105,40 @@ public:
     void
     callTimeout();
 
+    /**
+     * Set the call for the interest timeout so that it can be cancelled when
+     * this entry is removed. This keeps a weak_ptr since the scheduled call
+     * keeps the CancellableCall alive and its callback refers to this entry.
+     * @param timeoutCall The CancellableCall returned by
+     * Face::callLaterCancellable.
+     */
+    void
+    setTimeoutCall(const ptr_lib::shared_ptr<Face::CancellableCall>& timeoutCall)
+    {
+      timeoutCall_ = timeoutCall;
+    }
+
+    /**
+     * Cancel the call given to setTimeoutCall (if any) and release it. If the
+     * timeout was already called, this does nothing.
+     */
+    void
+    cancelTimeoutCall()
+    {
+      ptr_lib::shared_ptr<Face::CancellableCall> timeoutCall =
+        timeoutCall_.lock();
+      if (timeoutCall)
+        timeoutCall->cancel();
+      timeoutCall_.reset();
+    }
+
   private:
     ptr_lib::shared_ptr<const Interest> interest_;
     uint64_t pendingInterestId_;  /**< A unique identifier for this entry so it can be deleted */
     const OnData onData_;
     const OnTimeout onTimeout_;
     const OnNetworkNack onNetworkNack_;
+    ptr_lib::weak_ptr<Face::CancellableCall> timeoutCall_;
     bool isRemoved_;
   };
 
@@ -137,7 +170,8 @@ public:
    * entry's isRemoved flag, and add to the entries list.
    * @param data The incoming Data packet to find the interest for.
    * @param entries Add matching PendingInterestTable::Entry from the pending
-   * interest table.  The caller should pass in a reference to an empty vector.
+   * interest table, the most recently expressed interest first.  The caller
+   * should pass in a reference to an empty vector.
    */
   void
   extractEntriesForExpressedInterest
@@ -154,7 +188,8 @@ public:
    * nonce, link object and selectors).
    * @param interest The Interest to search for (typically from a Nack packet).
    * @param entries Add matching PendingInterestTable::Entry from the pending
-   * interest table.  The caller should pass in a reference to an empty vector.
+   * interest table, the most recently expressed interest first.  The caller
+   * should pass in a reference to an empty vector.
    */
   void
   extractEntriesForNackInterest
@@ -167,8 +202,10 @@ public:
    * the same interest name. If there is no entry with the pendingInterestId, do
    * nothing.
    * @param pendingInterestId The ID returned from expressInterest.
+   * @return The removed entry, or null if there is no entry with the
+   * pendingInterestId.
    */
-  void
+  ptr_lib::shared_ptr<Entry>
   removePendingInterest(uint64_t pendingInterestId);
 
   /**
@@ -180,9 +217,36 @@ public:
   bool
   removeEntry(const ptr_lib::shared_ptr<Entry>& pendingInterest);
 
+  /**
+   * Get the number of entries in the pending interest table.
+   * @return The number of entries.
+   */
+  size_t
+  size() const { return entriesById_.size(); }
+
 private:
-  std::vector<ptr_lib::shared_ptr<Entry> > table_;
-  std::vector<uint64_t> removeRequests_;
+  /**
+   * Remove the entry from entriesById_ and entriesByName_, set its isRemoved
+   * flag and cancel its timeout call.
+   * @param entry The entry to remove, which must be in the table.
+   */
+  void
+  erase(const ptr_lib::shared_ptr<Entry>& entry);
+
+  /**
+   * Get the number of components of the interest name to use for the
+   * entriesByName_ index. If the last component is an implicit SHA-256 digest,
+   * omit it because it is only matched by the Data full name which is not part
+   * of the Data name.
+   * @param interestName The interest name.
+   * @return The number of components.
+   */
+  static size_t
+  getIndexLength(const Name& interestName);
+
+  std::map<uint64_t, ptr_lib::shared_ptr<Entry> > entriesById_;
+  NamePrefixTree<ptr_lib::shared_ptr<Entry> > entriesByName_;
+  std::set<uint64_t> removeRequests_;
 };
 
 }
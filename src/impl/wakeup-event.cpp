@@ -0,0 +1,115 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2017 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+#include <stdexcept>
+#include <stdint.h>
+#include <ndn-cpp/ndn-cpp-config.h>
+#if NDN_CPP_HAVE_UNISTD_H
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#if NDN_CPP_HAVE_EVENTFD
+#include <sys/eventfd.h>
+#endif
+#endif
+#include "wakeup-event.hpp"
+
+using namespace std;
+
+namespace ndn {
+
+#if NDN_CPP_HAVE_UNISTD_H
+
+WakeupEvent::WakeupEvent()
+: readDescriptor_(-1), writeDescriptor_(-1)
+{
+#if NDN_CPP_HAVE_EVENTFD
+  readDescriptor_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (readDescriptor_ < 0)
+    throw runtime_error("WakeupEvent: Error in eventfd");
+  writeDescriptor_ = readDescriptor_;
+#else
+  int descriptors[2];
+  if (pipe(descriptors) < 0)
+    throw runtime_error("WakeupEvent: Error in pipe");
+  readDescriptor_ = descriptors[0];
+  writeDescriptor_ = descriptors[1];
+  // Don't block in clear() when the pipe is empty, or in signal() when it is
+  // full, since then it is already ready to read.
+  for (int i = 0; i < 2; ++i) {
+    fcntl(descriptors[i], F_SETFL, fcntl(descriptors[i], F_GETFL) | O_NONBLOCK);
+    fcntl(descriptors[i], F_SETFD, FD_CLOEXEC);
+  }
+#endif
+}
+
+WakeupEvent::~WakeupEvent()
+{
+  ::close(readDescriptor_);
+  if (writeDescriptor_ != readDescriptor_)
+    ::close(writeDescriptor_);
+}
+
+void
+WakeupEvent::signal()
+{
+#if NDN_CPP_HAVE_EVENTFD
+  uint64_t value = 1;
+#else
+  uint8_t value = 1;
+#endif
+  // Ignore EAGAIN, which means that the descriptor is already ready to read.
+  while (write(writeDescriptor_, &value, sizeof(value)) < 0 && errno == EINTR)
+    ;
+}
+
+void
+WakeupEvent::clear()
+{
+  // eventfd is cleared with one read. Read the pipe until it is empty.
+  uint8_t buffer[64];
+  while (true) {
+    ssize_t nBytes = read(readDescriptor_, buffer, sizeof(buffer));
+    if (nBytes < 0 && errno == EINTR)
+      continue;
+    if (nBytes < (ssize_t)sizeof(buffer))
+      break;
+  }
+}
+
+#else // NDN_CPP_HAVE_UNISTD_H
+
+WakeupEvent::WakeupEvent()
+: readDescriptor_(-1), writeDescriptor_(-1)
+{
+}
+
+WakeupEvent::~WakeupEvent() {}
+
+void
+WakeupEvent::signal() {}
+
+void
+WakeupEvent::clear() {}
+
+#endif // NDN_CPP_HAVE_UNISTD_H
+
+}
@@ -0,0 +1,82 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2017 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+#ifndef NDN_WAKEUP_EVENT_HPP
+#define NDN_WAKEUP_EVENT_HPP
+
+namespace ndn {
+
+/**
+ * A WakeupEvent is an internal class to hold a descriptor which becomes ready
+ * to read when another thread calls signal(). A thread which waits with poll or
+ * epoll on its sockets can also wait on this descriptor so that, for example,
+ * Face.post ends the wait. This uses eventfd where it is available, otherwise a
+ * pipe. Without Unix support, getDescriptor() returns -1.
+ */
+class WakeupEvent {
+public:
+  /**
+   * Create a new WakeupEvent which is not signaled.
+   * @throws std::runtime_error if the system can't create the descriptor.
+   */
+  WakeupEvent();
+
+  ~WakeupEvent();
+
+  /**
+   * Get the descriptor to wait on for reading.
+   * @return The descriptor, or -1 if not supported.
+   */
+  int
+  getDescriptor() const { return readDescriptor_; }
+
+  /**
+   * Make the descriptor ready to read until the next call to clear(). This may
+   * be called from any thread.
+   */
+  void
+  signal();
+
+  /**
+   * Read from the descriptor so that it is no longer ready.
+   */
+  void
+  clear();
+
+private:
+  /**
+   * Don't allow the copy constructor.
+   */
+  WakeupEvent(const WakeupEvent& other);
+
+  /**
+   * Don't allow the assignment operator.
+   */
+  WakeupEvent& operator=(const WakeupEvent& other);
+
+  int readDescriptor_;
+  // For eventfd, this is the same as readDescriptor_.
+  int writeDescriptor_;
+};
+
+}
+
+#endif
@@ -291,6 +291,24 @@ Name::Component::getSuccessor() const
   return Component(Blob(result, false));
 }
 
+// The parameters of the 64-bit FNV-1a hash.
+static const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+static const uint64_t FNV_PRIME = 1099511628211ULL;
+
+size_t
+Name::Component::hash() const
+{
+  // The type is not hashed because Name::equals only compares the values.
+  uint64_t result = FNV_OFFSET_BASIS;
+  const uint8_t* value = value_.buf();
+  for (size_t i = 0; i < value_.size(); ++i) {
+    result ^= value[i];
+    result *= FNV_PRIME;
+  }
+
+  return (size_t)result;
+}
+
 void
 Name::set(const char *uri_cstr)
 {
@@ -372,12 +390,45 @@ Name::get(NameLite& nameLite) const
   }
 }
 
+/**
+ * Check if the component has the same type and value as componentLite.
+ */
+static bool
+isSameComponent
+  (const Name::Component& component,
+   const NameLite::Component& componentLite)
+{
+  const Blob& value = component.getValue();
+  const BlobLite& valueLite = componentLite.getValue();
+  return component.isImplicitSha256Digest() ==
+           componentLite.isImplicitSha256Digest() &&
+         value.size() == valueLite.size() &&
+         (value.size() == 0 ||
+          ndn_memcmp(value.buf(), valueLite.buf(), value.size()) == 0);
+}
+
 void
 Name::set(const NameLite& nameLite)
 {
-  clear();
-  for (size_t i = 0; i < nameLite.size(); ++i)
-    append(Component(nameLite.get(i)));
+  // When a reused Interest or Data decodes the next packet, most of the
+  // components are usually the same as before. Since a component value is
+  // immutable, keep the existing components which are the same so that only
+  // the changed components allocate a new value.
+  size_t nComponents = nameLite.size();
+  if (components_.size() > nComponents)
+    components_.erase(components_.begin() + nComponents, components_.end());
+  else
+    components_.reserve(nComponents);
+
+  for (size_t i = 0; i < nComponents; ++i) {
+    const NameLite::Component& componentLite = nameLite.get(i);
+    if (i >= components_.size())
+      components_.push_back(Component(componentLite));
+    else if (!isSameComponent(components_[i], componentLite))
+      components_[i] = Component(componentLite);
+  }
+
+  ++changeCount_;
 }
 
 Name&
@@ -387,6 +438,7 @@ Name::append(const Name& name)
     // Copying from this name, so need to make a copy first.
     return append(Name(name));
 
+  components_.reserve(components_.size() + name.components_.size());
   for (size_t i = 0; i < name.components_.size(); ++i)
     append(name.components_[i]);
 
@@ -419,6 +471,8 @@ Name::getSubName(int iStartComponent, size_t nComponents) const
   Name result;
 
   size_t iEnd = min(iStartComponent + nComponents, components_.size());
+  if (iEnd > (size_t)iStartComponent)
+    result.components_.reserve(iEnd - iStartComponent);
   for (size_t i = iStartComponent; i < iEnd; ++i)
     result.components_.push_back(components_[i]);
 
@@ -440,6 +494,24 @@ Name::equals(const Name& name) const
   return true;
 }
 
+size_t
+Name::hash() const
+{
+  if (haveHashCode_ && hashCodeChangeCount_ == changeCount_)
+    return hashCode_;
+
+  uint64_t result = FNV_OFFSET_BASIS;
+  for (size_t i = 0; i < components_.size(); ++i) {
+    result ^= (uint64_t)components_[i].hash();
+    result *= FNV_PRIME;
+  }
+
+  hashCode_ = (size_t)result;
+  hashCodeChangeCount_ = changeCount_;
+  haveHashCode_ = true;
+  return hashCode_;
+}
+
 Name
 Name::getSuccessor() const
 {
@@ -19,6 +19,7 @@
  * A copy of the GNU Lesser General Public License is in the file COPYING.
  */
 
+#include <math.h>
 #include <stdexcept>
 #include <ndn-cpp/encoding/tlv-wire-format.hpp>
 #include <ndn-cpp/control-response.hpp>
@@ -29,6 +30,7 @@
 #include "encoding/tlv-decoder.hpp"
 #include <ndn-cpp/util/logging.hpp>
 #include "lp/lp-packet.hpp"
+#include "impl/wakeup-event.hpp"
 #include "node.hpp"
 
 INIT_LOGGER("ndn.Node");
@@ -43,7 +45,8 @@ Node::Node(const ptr_lib::shared_ptr<Transport>& transport, const ptr_lib::share
   timeoutPrefix_(Name("/local/timeout")),
   lastEntryId_(0), connectStatus_(ConnectStatus_UNCONNECTED),
   registeredPrefixTable_(interestFilterTable_),
-  nonceTemplate_((const uint8_t*)"\0\0\0\0", 4)
+  nonceTemplate_((const uint8_t*)"\0\0\0\0", 4),
+  nReceivedPackets_(0), nReceivedPacketAllocations_(0)
 {
 }
 
@@ -295,6 +298,99 @@ Node::processEvents()
   // If Face::callLater is overridden to use a different mechanism, then
   // processEvents is not needed to check for delayed calls.
   delayedCallTable_.callTimedOut();
+
+  processPostedCalls();
+}
+
+void
+Node::processEvents(Milliseconds maxWaitMilliseconds)
+{
+  Milliseconds waitMilliseconds = maxWaitMilliseconds;
+  MillisecondsSince1970 nextCallTime = delayedCallTable_.getNextCallTime();
+  if (nextCallTime >= 0) {
+    Milliseconds untilNextCall = nextCallTime - ndn_getNowMilliseconds();
+    if (untilNextCall < waitMilliseconds)
+      waitMilliseconds = untilNextCall;
+  }
+
+  if (waitMilliseconds > 0) {
+    bool havePostedCalls;
+    int wakeupDescriptor;
+    {
+#if NDN_CPP_HAVE_STD_THREAD
+      lock_guard<mutex> lock(postedCallsMutex_);
+#endif
+      havePostedCalls = (postedCalls_.size() > 0);
+      if (!wakeupEvent_)
+        wakeupEvent_.reset(new WakeupEvent());
+      wakeupDescriptor = wakeupEvent_->getDescriptor();
+    }
+
+    if (!havePostedCalls)
+      // Round up so that we don't wake up just before the next call is due.
+      // A call to post while waiting signals the wakeup descriptor. It stays
+      // readable until processPostedCalls clears it, so a post after the check
+      // above also ends the wait.
+      transport_->waitForReceive(ceil(waitMilliseconds), wakeupDescriptor);
+  }
+
+  processEvents();
+}
+
+void
+Node::post(const Face::Callback& callback)
+{
+#if NDN_CPP_HAVE_STD_THREAD
+  lock_guard<mutex> lock(postedCallsMutex_);
+#endif
+  postedCalls_.push_back(callback);
+  if (wakeupEvent_)
+    wakeupEvent_->signal();
+  if (onPostedCall_)
+    onPostedCall_();
+}
+
+void
+Node::processPostedCalls()
+{
+  vector<Face::Callback> calls;
+  {
+#if NDN_CPP_HAVE_STD_THREAD
+    lock_guard<mutex> lock(postedCallsMutex_);
+#endif
+    if (postedCalls_.size() == 0)
+      return;
+    // Call outside the lock so that a callback can call post.
+    calls.swap(postedCalls_);
+    if (wakeupEvent_)
+      wakeupEvent_->clear();
+  }
+
+  for (size_t i = 0; i < calls.size(); ++i) {
+    try {
+      calls[i]();
+    } catch (...) {
+      // Keep the remaining calls for the next time.
+#if NDN_CPP_HAVE_STD_THREAD
+      lock_guard<mutex> lock(postedCallsMutex_);
+#endif
+      postedCalls_.insert
+        (postedCalls_.begin(), calls.begin() + i + 1, calls.end());
+      throw;
+    }
+  }
+}
+
+void
+Node::setOnPostedCall(const OnPostedCall& onPostedCall)
+{
+#if NDN_CPP_HAVE_STD_THREAD
+  lock_guard<mutex> lock(postedCallsMutex_);
+#endif
+  onPostedCall_ = onPostedCall;
+  if (onPostedCall_ && postedCalls_.size() > 0)
+    // Report the calls which were posted before it was set.
+    onPostedCall_();
 }
 
 void
@@ -329,18 +425,30 @@ Node::onReceivedElement(const uint8_t *element, size_t elementLength)
   if (element[0] == ndn_Tlv_Interest || element[0] == ndn_Tlv_Data) {
     TlvDecoder decoder(element, elementLength);
     if (decoder.peekType(ndn_Tlv_Interest, elementLength)) {
-      interest.reset(new Interest());
+      // If only receivedInterest_ holds the previous Interest then nobody else
+      // can see it, so decode into it to reuse its memory. Otherwise an
+      // application callback kept it (or we are called re-entrantly), so
+      // allocate a new one.
+      if (!receivedInterest_ || receivedInterest_.use_count() > 1) {
+        receivedInterest_.reset(new Interest());
+        ++nReceivedPacketAllocations_;
+      }
+      interest = receivedInterest_;
       interest->wireDecode(element, elementLength, *TlvWireFormat::get());
-
-      if (lpPacket)
-        interest->setLpPacket(lpPacket);
+      // Always set the LpPacket to clear the one from a reused Interest.
+      interest->setLpPacket(lpPacket);
+      ++nReceivedPackets_;
     }
     else if (decoder.peekType(ndn_Tlv_Data, elementLength)) {
-      data.reset(new Data());
+      // See above for reusing receivedData_.
+      if (!receivedData_ || receivedData_.use_count() > 1) {
+        receivedData_.reset(new Data());
+        ++nReceivedPacketAllocations_;
+      }
+      data = receivedData_;
       data->wireDecode(element, elementLength, *TlvWireFormat::get());
-
-      if (lpPacket)
-        data->setLpPacket(lpPacket);
+      data->setLpPacket(lpPacket);
+      ++nReceivedPackets_;
     }
   }
 
@@ -431,9 +539,11 @@ Node::expressInterestHelper
       // Use a default timeout delay.
       delayMilliseconds = 4000.0;
 
-    face->callLater
+    // Save the call in the entry so that the PendingInterestTable cancels the
+    // timeout when the entry is removed.
+    pendingInterest->setTimeoutCall(face->callLaterCancellable
       (delayMilliseconds,
-       bind(&Node::processInterestTimeout, this, pendingInterest));
+       bind(&Node::processInterestTimeout, this, pendingInterest)));
   }
 
   // Special case: For timeoutPrefix_ we don't actually send the interest.
@@ -27,6 +27,9 @@
 #ifdef NDN_CPP_HAVE_BOOST_ASIO
 #include <boost/atomic.hpp>
 #endif
+#if NDN_CPP_HAVE_STD_THREAD
+#include <mutex>
+#endif
 #include <ndn-cpp/common.hpp>
 #include <ndn-cpp/interest.hpp>
 #include <ndn-cpp/data.hpp>
@@ -45,6 +48,7 @@ struct ndn_Interest;
 namespace ndn {
 
 class KeyChain;
+class WakeupEvent;
 
 class Node : public ElementListener {
 public:
@@ -243,6 +247,12 @@ public:
   void
   send(const uint8_t *encoding, size_t encodingLength);
 
+  /**
+   * Send any packets which the Transport has queued.
+   */
+  void
+  flush() { transport_->flush(); }
+
   /**
    * Process any packets to receive and call callbacks such as onData,
    * onInterest or onTimeout. This returns immediately if there is no data to
@@ -258,12 +268,31 @@ public:
   void
   processEvents();
 
+  /**
+   * Wait until there is data to receive or until the next call from callLater
+   * is due, but no longer than maxWaitMilliseconds, then call processEvents().
+   * @param maxWaitMilliseconds The maximum time to wait in milliseconds.
+   * @throws This may throw an exception for reading data or in the callback
+   * for processing the data.
+   */
+  void
+  processEvents(Milliseconds maxWaitMilliseconds);
+
   const ptr_lib::shared_ptr<Transport>&
   getTransport() { return transport_; }
 
   const ptr_lib::shared_ptr<const Transport::ConnectionInfo>&
   getConnectionInfo() { return connectionInfo_; }
 
+  /**
+   * Get the table of calls from callLater which processEvents() checks. An
+   * event loop such as FaceReactor which does not call processEvents() uses
+   * this to call the timed-out calls.
+   * @return The DelayedCallTable.
+   */
+  DelayedCallTable&
+  getDelayedCallTable() { return delayedCallTable_; }
+
   void
   onReceivedElement(const uint8_t *element, size_t elementLength);
 
@@ -275,6 +304,22 @@ public:
   bool
   isLocal() { return transport_->isLocal(*connectionInfo_); }
 
+  /**
+   * Get the number of Interest and Data packets which onReceivedElement has
+   * decoded.
+   * @return The number of received packets.
+   */
+  uint64_t
+  getNReceivedPackets() const { return nReceivedPackets_; }
+
+  /**
+   * Get the number of times that onReceivedElement had to allocate a new
+   * Interest or Data object because the application kept the previous one.
+   * @return The number of Interest and Data objects allocated.
+   */
+  uint64_t
+  getNReceivedPacketAllocations() const { return nReceivedPacketAllocations_; }
+
   void
   shutdown();
 
@@ -300,6 +345,41 @@ public:
     delayedCallTable_.callLater(delayMilliseconds, callback);
   }
 
+  /**
+   * Add the callback to the calls which processEvents() calls on its thread.
+   * Unlike callLater, this is thread-safe so that a worker thread can call it.
+   * If the thread is waiting in processEvents(maxWaitMilliseconds), this
+   * signals the wakeup event to end the wait so that the callback is called
+   * promptly. If an OnPostedCall is set, call it.
+   * @param callback This calls callback().
+   */
+  void
+  post(const Face::Callback& callback);
+
+  /**
+   * Call and remove the calls which were added by post. processEvents() calls
+   * this, and an event loop such as FaceReactor which does not call
+   * processEvents() calls this when notified by the OnPostedCall.
+   */
+  void
+  processPostedCalls();
+
+  /**
+   * An OnPostedCall function object is called by post, on the thread which
+   * called post, when a call is added. FaceReactor uses this to process the
+   * posted calls of its faces.
+   */
+  typedef func_lib::function<void()> OnPostedCall;
+
+  /**
+   * Set the function which post calls when it adds a call. If there are
+   * already posted calls, this also calls it once for them.
+   * @param onPostedCall The OnPostedCall, which must be thread-safe. To
+   * remove it, use OnPostedCall().
+   */
+  void
+  setOnPostedCall(const OnPostedCall& onPostedCall);
+
   /**
    * Get the next unique entry ID for the pending interest table, interest
    * filter table, etc. This uses an atomic_uint64_t to be thread safe. Most
@@ -456,10 +536,26 @@ private:
   InterestFilterTable interestFilterTable_;
   DelayedCallTable delayedCallTable_;
   std::vector<Face::Callback> onConnectedCallbacks_;
+  // The calls from post, which other threads may add.
+  std::vector<Face::Callback> postedCalls_;
+  OnPostedCall onPostedCall_;
+  // processEvents(maxWaitMilliseconds) creates this on the first wait, and
+  // waits on it with the transport so that post can end the wait. This is
+  // guarded by postedCallsMutex_.
+  ptr_lib::shared_ptr<WakeupEvent> wakeupEvent_;
+#if NDN_CPP_HAVE_STD_THREAD
+  std::mutex postedCallsMutex_;
+#endif
   CommandInterestGenerator commandInterestGenerator_;
   Name timeoutPrefix_;
   ConnectStatus connectStatus_;
   Blob nonceTemplate_;
+  // onReceivedElement decodes into these objects and reuses them for the next
+  // received packet if the application did not keep a shared_ptr to them.
+  ptr_lib::shared_ptr<Interest> receivedInterest_;
+  ptr_lib::shared_ptr<Data> receivedData_;
+  uint64_t nReceivedPackets_;
+  uint64_t nReceivedPacketAllocations_;
 #ifdef NDN_CPP_HAVE_BOOST_ASIO
   // ThreadsafeFace accesses lastEntryId_ outside of a thread safe dispatch, so
   // use atomic_uint64_t to be thread safe.
@@ -186,6 +186,13 @@ FilePrivateKeyStorage::generateKeyPair
   string keyFilePathNoExtension = maintainMapping(keyUri);
   string publicKeyFilePath = keyFilePathNoExtension + ".pub";
   string privateKeyFilePath = keyFilePathNoExtension + ".pri";
+  {
+    // In case the key was deleted outside of deleteKeyPair.
+#if NDN_CPP_HAVE_STD_THREAD
+    lock_guard<mutex> lock(privateKeyCacheMutex_);
+#endif
+    privateKeyCache_.erase(keyUri);
+  }
 
   ofstream publicKeyFile(publicKeyFilePath.c_str());
   publicKeyFile << toBase64(publicKeyDer.buf(), publicKeyDer.size(), true);
@@ -203,6 +210,12 @@ FilePrivateKeyStorage::deleteKeyPair(const Name& keyName)
 {
   string keyUri = keyName.toUri();
 
+  {
+#if NDN_CPP_HAVE_STD_THREAD
+    lock_guard<mutex> lock(privateKeyCacheMutex_);
+#endif
+    privateKeyCache_.erase(keyUri);
+  }
   remove(nameTransform(keyUri, ".pub").c_str());
   remove(nameTransform(keyUri, ".pri").c_str());
 }
@@ -232,68 +245,35 @@ FilePrivateKeyStorage::sign
   (const uint8_t *data, size_t dataLength, const Name& keyName,
    DigestAlgorithm digestAlgorithm)
 {
-  string keyURI = keyName.toUri();
-
-  if (!doesKeyExist(keyName, KEY_CLASS_PRIVATE))
-    throw SecurityException
-      ("FilePrivateKeyStorage::sign: private key doesn't exist");
+  ptr_lib::shared_ptr<PrivateKey> privateKey = getPrivateKey(keyName);
 
   if (digestAlgorithm != DIGEST_ALGORITHM_SHA256)
     throw SecurityException
       ("FilePrivateKeyStorage::sign: Unsupported digest algorithm");
 
-  // Read the private key.
-  ifstream file(nameTransform(keyURI, ".pri").c_str());
-  stringstream base64;
-  base64 << file.rdbuf();
-  vector<uint8_t> pkcs8Der;
-  fromBase64(base64.str(), pkcs8Der);
-
-  // The private key is generated by NFD which stores as PKCS #8. Decode it
-  // to find the algorithm OID and the inner private key DER.
-  ptr_lib::shared_ptr<DerNode> parsedNode = DerNode::parse(&pkcs8Der[0], 0);
-  const std::vector<ptr_lib::shared_ptr<DerNode> >& pkcs8Children =
-    parsedNode->getChildren();
-  // Get the algorithm OID and parameters.
-  const std::vector<ptr_lib::shared_ptr<DerNode> >& algorithmIdChildren =
-    DerNode::getSequence(pkcs8Children, 1).getChildren();
-  string oidString
-    (dynamic_cast<DerNode::DerOid&>(*algorithmIdChildren[0]).toVal().toRawStr());
-  ptr_lib::shared_ptr<DerNode> algorithmParameters = algorithmIdChildren[1];
-  // Get the value of the 3rd child which is the octet string.
-  Blob privateKeyDer = pkcs8Children[2]->toVal();
-
   // TODO: use RSA_size, etc. to get the proper size of the signature buffer.
   uint8_t signatureBits[1000];
   size_t signatureBitsLength;
   ndn_Error error;
 
-  // Decode the private key and sign.
 #if NDN_CPP_HAVE_LIBCRYPTO
-  if (oidString == RSA_ENCRYPTION_OID) {
-    RsaPrivateKeyLite privateKey;
-    if ((error = privateKey.decode(privateKeyDer)))
-      throw SecurityException
-        (string("FilePrivateKeyStorage::sign RSA: ") + ndn_getErrorString(error));
-
-    if ((error =  privateKey.signWithSha256
+  if (privateKey->getKeyType() == KEY_TYPE_RSA) {
+    if ((error =  privateKey->getRsaPrivateKey().signWithSha256
          (data, dataLength, signatureBits, signatureBitsLength)))
       throw SecurityException
         (string("FilePrivateKeyStorage::sign RSA: ") + ndn_getErrorString(error));
   }
-  else if (oidString == EC_ENCRYPTION_OID) {
-    EcPrivateKeyLite privateKey;
-    decodeEcPrivateKey(algorithmParameters, privateKeyDer, privateKey);
-
-    if ((error =  privateKey.signWithSha256
+  else if (privateKey->getKeyType() == KEY_TYPE_ECDSA) {
+    if ((error =  privateKey->getEcPrivateKey().signWithSha256
          (data, dataLength, signatureBits, signatureBitsLength)))
       throw SecurityException
         (string("FilePrivateKeyStorage::sign ECDSA: ") + ndn_getErrorString(error));
   }
   else
 #endif
+    // We don't expect this to happen since getPrivateKey checked the OID.
     throw SecurityException
-      ("FilePrivateKeyStorage::sign: Unrecognized private key OID");
+      ("FilePrivateKeyStorage::sign: Unrecognized private key type");
 
   return Blob(signatureBits, signatureBitsLength);
 }
@@ -320,6 +300,107 @@ FilePrivateKeyStorage::generateKey(const Name& keyName, const KeyParams& params)
   throw runtime_error("FilePrivateKeyStorage::generateKey not implemented");
 }
 
+ptr_lib::shared_ptr<FilePrivateKeyStorage::PrivateKey>
+FilePrivateKeyStorage::getPrivateKey(const Name& keyName)
+{
+  string keyURI = keyName.toUri();
+#if NDN_CPP_HAVE_STD_THREAD
+  // Hold the lock while decoding so that other threads wait for the result.
+  lock_guard<mutex> lock(privateKeyCacheMutex_);
+#endif
+
+  map<string, ptr_lib::shared_ptr<PrivateKey> >::iterator cached =
+    privateKeyCache_.find(keyURI);
+  // Use the saved file path to avoid the digest in nameTransform.
+  string filePath = (cached != privateKeyCache_.end() ?
+    cached->second->getFilePath() : nameTransform(keyURI, ".pri"));
+
+  // Checking the file status is much cheaper than reading and decoding it.
+  struct stat statInfo;
+  if (::stat(filePath.c_str(), &statInfo) != 0) {
+    if (cached != privateKeyCache_.end())
+      privateKeyCache_.erase(cached);
+    throw SecurityException
+      ("FilePrivateKeyStorage::sign: private key doesn't exist");
+  }
+
+  FileStatus fileStatus;
+  fileStatus.modificationTime_ = statInfo.st_mtime;
+#if defined(__APPLE__)
+  fileStatus.modificationNanoseconds_ = statInfo.st_mtimespec.tv_nsec;
+#elif defined(_WIN32)
+  // Windows stat has no nanoseconds, so rely on st_mtime alone.
+  fileStatus.modificationNanoseconds_ = 0;
+#else
+  fileStatus.modificationNanoseconds_ = statInfo.st_mtim.tv_nsec;
+#endif
+  fileStatus.inode_ = statInfo.st_ino;
+  fileStatus.size_ = statInfo.st_size;
+
+  if (cached != privateKeyCache_.end() &&
+      cached->second->isFileUnchanged(fileStatus))
+    return cached->second;
+
+  // Read the private key.
+  ifstream file(filePath.c_str());
+  stringstream base64;
+  base64 << file.rdbuf();
+  vector<uint8_t> pkcs8Der;
+  fromBase64(base64.str(), pkcs8Der);
+  if (pkcs8Der.size() == 0)
+    throw SecurityException
+      ("FilePrivateKeyStorage::sign: Can't read the private key file");
+
+  // The private key is generated by NFD which stores as PKCS #8. Decode it
+  // to find the algorithm OID and the inner private key DER.
+  ptr_lib::shared_ptr<DerNode> parsedNode = DerNode::parse(&pkcs8Der[0], 0);
+  const std::vector<ptr_lib::shared_ptr<DerNode> >& pkcs8Children =
+    parsedNode->getChildren();
+  // Get the algorithm OID and parameters.
+  const std::vector<ptr_lib::shared_ptr<DerNode> >& algorithmIdChildren =
+    DerNode::getSequence(pkcs8Children, 1).getChildren();
+  string oidString
+    (dynamic_cast<DerNode::DerOid&>(*algorithmIdChildren[0]).toVal().toRawStr());
+  ptr_lib::shared_ptr<DerNode> algorithmParameters = algorithmIdChildren[1];
+  // Get the value of the 3rd child which is the octet string.
+  Blob privateKeyDer = pkcs8Children[2]->toVal();
+
+  ptr_lib::shared_ptr<PrivateKey> privateKey;
+  // Decode the private key.
+#if NDN_CPP_HAVE_LIBCRYPTO
+  if (oidString == RSA_ENCRYPTION_OID) {
+    privateKey.reset(new PrivateKey
+      (KEY_TYPE_RSA, filePath, fileStatus));
+    ndn_Error error;
+    if ((error = privateKey->getRsaPrivateKey().decode(privateKeyDer)))
+      throw SecurityException
+        (string("FilePrivateKeyStorage::sign RSA: ") + ndn_getErrorString(error));
+  }
+  else if (oidString == EC_ENCRYPTION_OID) {
+    privateKey.reset(new PrivateKey
+      (KEY_TYPE_ECDSA, filePath, fileStatus));
+    decodeEcPrivateKey
+      (algorithmParameters, privateKeyDer, privateKey->getEcPrivateKey());
+  }
+  else
+#endif
+    throw SecurityException
+      ("FilePrivateKeyStorage::sign: Unrecognized private key OID");
+
+  privateKeyCache_[keyURI] = privateKey;
+  return privateKey;
+}
+
+bool
+FilePrivateKeyStorage::isSignThreadSafe()
+{
+#if NDN_CPP_HAVE_STD_THREAD
+  return true;
+#else
+  return false;
+#endif
+}
+
 bool
 FilePrivateKeyStorage::doesKeyExist(const Name& keyName, KeyClass keyClass)
 {
@@ -27,6 +27,7 @@
 #if NDN_CPP_HAVE_SYS_TIME_H
 #include <sys/time.h>
 #endif
+#include <string.h>
 #include <ctime>
 #include <fstream>
 #include <math.h>
@@ -38,10 +39,14 @@
 #include <ndn-cpp/security/identity/basic-identity-storage.hpp>
 #include <ndn-cpp/security/identity/file-private-key-storage.hpp>
 #include <ndn-cpp/security/identity/osx-private-key-storage.hpp>
+#include <ndn-cpp/encoding/tlv-0_2-wire-format.hpp>
 #include "../../util/config-file.hpp"
 #include "../../c/util/time.h"
 #include <ndn-cpp/lite/util/crypto-lite.hpp>
 #include <ndn-cpp/security/identity/identity-manager.hpp>
+#if NDN_CPP_HAVE_STD_THREAD
+#include <thread>
+#endif
 
 using namespace std;
 
@@ -208,6 +213,9 @@ IdentityManager::deleteIdentity(const Name& identityName)
 
   for (size_t i = 0; i < keysToDelete.size(); ++i)
     privateKeyStorage_->deleteKeyPair(keysToDelete[i]);
+
+  // A new key with the same name could have a different key type.
+  signatureTemplates_.clear();
 }
 
 Name
@@ -218,6 +226,8 @@ IdentityManager::generateKeyPair
   privateKeyStorage_->generateKeyPair(keyName, params);
   ptr_lib::shared_ptr<PublicKey> pubKey = privateKeyStorage_->getPublicKey(keyName);
   identityStorage_->addKey(keyName, params.getKeyType(), pubKey->getKeyDer());
+  // The new key may replace a key with the same name and a different type.
+  signatureTemplates_.clear();
 
   return keyName;
 }
@@ -270,6 +280,7 @@ IdentityManager::createIdentityCertificate(const Name& certificatePrefix,
     (certificatePrefix, *publicKey,  signerCertificateName, notBefore, notAfter);
 
   identityStorage_->addCertificate(*certificate);
+  signatureTemplates_.clear();
 
   return certificate->getName();
 }
@@ -405,6 +416,7 @@ void
 IdentityManager::addCertificateAsDefault(const IdentityCertificate& certificate)
 {
   identityStorage_->addCertificate(certificate);
+  signatureTemplates_.clear();
 
   setDefaultCertificateForKey(certificate);
 }
@@ -413,6 +425,7 @@ void
 IdentityManager::addCertificateAsIdentityDefault(const IdentityCertificate& certificate)
 {
   identityStorage_->addCertificate(certificate);
+  signatureTemplates_.clear();
 
   Name keyName = certificate.getPublicKeyName();
 
@@ -451,20 +464,74 @@ void
 IdentityManager::signByCertificate(Data &data, const Name &certificateName, WireFormat& wireFormat)
 {
   DigestAlgorithm digestAlgorithm;
-  ptr_lib::shared_ptr<Signature> signature = makeSignatureByCertificate
-    (certificateName, digestAlgorithm);
+  const ptr_lib::shared_ptr<Signature>& signatureTemplate =
+    getSignatureTemplate(certificateName, digestAlgorithm);
 
-  data.setSignature(*signature);
-  // Encode once to get the signed portion.
-  SignedBlob encoding = data.wireEncode(wireFormat);
-
-  data.getSignature()->setSignature
-    (privateKeyStorage_->sign(encoding.signedBuf(), encoding.signedSize(),
+  Blob signatureBits = signWithTemplate
+    (data, *signatureTemplate,
      IdentityCertificate::certificateNameToPublicKeyName(certificateName),
-     digestAlgorithm));
+     digestAlgorithm, wireFormat);
+  if (signatureBits.size() != signatureTemplate->getSignature().size())
+    // Save the length so that next time we use it.
+    setPlaceholderSignature(*signatureTemplate, signatureBits.size());
+}
+
+void
+IdentityManager::signByCertificate
+  (const vector<Data*>& dataList, const Name& certificateName, int nThreads,
+   WireFormat& wireFormat)
+{
+  if (dataList.size() == 0)
+    return;
+
+  // Get the template on this thread since it updates signatureTemplates_.
+  DigestAlgorithm digestAlgorithm;
+  const ptr_lib::shared_ptr<Signature>& signatureTemplate =
+    getSignatureTemplate(certificateName, digestAlgorithm);
+  Name keyName = IdentityCertificate::certificateNameToPublicKeyName
+    (certificateName);
+
+#if NDN_CPP_HAVE_STD_THREAD
+  if (nThreads <= 0)
+    nThreads = thread::hardware_concurrency();
+  if ((size_t)nThreads > dataList.size())
+    nThreads = dataList.size();
+  if (!privateKeyStorage_->isSignThreadSafe())
+    nThreads = 1;
+#else
+  nThreads = 1;
+#endif
+
+  if (nThreads <= 1) {
+    for (size_t i = 0; i < dataList.size(); ++i)
+      signWithTemplate
+        (*dataList[i], *signatureTemplate, keyName, digestAlgorithm, wireFormat);
+  }
+#if NDN_CPP_HAVE_STD_THREAD
+  else {
+    // Each thread signs every nThreads'th Data packet. The threads only read
+    // the template and keyName, and each Data packet is used by one thread.
+    string errorMessage;
+    mutex errorMessageMutex;
+    vector<thread> threads;
+    for (int iThread = 0; iThread < nThreads; ++iThread)
+      threads.push_back(thread
+        (&IdentityManager::signBatchWorker, this, &dataList, iThread, nThreads,
+         signatureTemplate.get(), &keyName, digestAlgorithm, &wireFormat,
+         &errorMessage, &errorMessageMutex));
+    for (size_t i = 0; i < threads.size(); ++i)
+      threads[i].join();
+
+    if (errorMessage != "")
+      throw SecurityException(errorMessage);
+  }
+#endif
 
-  // Encode again to include the signature.
-  data.wireEncode(wireFormat);
+  // Save the length of the last signature. See signByCertificate(Data).
+  const Blob& lastSignatureBits =
+    dataList.back()->getSignature()->getSignature();
+  if (lastSignatureBits.size() != signatureTemplate->getSignature().size())
+    setPlaceholderSignature(*signatureTemplate, lastSignatureBits.size());
 }
 
 void
@@ -496,6 +563,8 @@ void
 IdentityManager::signWithSha256(Data &data, WireFormat& wireFormat)
 {
   data.setSignature(DigestSha256Signature());
+  // Encode with a placeholder for the digest. See signByCertificate.
+  setPlaceholderSignature(*data.getSignature(), ndn_SHA256_DIGEST_SIZE);
 
   // Encode once to get the signed portion.
   SignedBlob encoding = data.wireEncode(wireFormat);
@@ -504,11 +573,9 @@ IdentityManager::signWithSha256(Data &data, WireFormat& wireFormat)
   uint8_t signedPortionDigest[ndn_SHA256_DIGEST_SIZE];
   CryptoLite::digestSha256
     (encoding.getSignedPortionBlobLite(), signedPortionDigest);
-  data.getSignature()->setSignature
-    (Blob(signedPortionDigest, sizeof(signedPortionDigest)));
+  Blob signatureBits(signedPortionDigest, sizeof(signedPortionDigest));
 
-  // Encode again to include the signature.
-  data.wireEncode(wireFormat);
+  setSignatureAndEncoding(data, encoding, signatureBits, wireFormat);
 }
 
 void
@@ -595,38 +662,138 @@ IdentityManager::getKeyNameFromCertificatePrefix(const Name & certificatePrefix)
   return result;
 }
 
+Blob
+IdentityManager::signWithTemplate
+  (Data& data, const Signature& signatureTemplate, const Name& keyName,
+   DigestAlgorithm digestAlgorithm, WireFormat& wireFormat)
+{
+  // The template has a placeholder signature value with the same length as
+  // the last signature by this certificate.
+  data.setSignature(signatureTemplate);
+  // Encode once to get the signed portion.
+  SignedBlob encoding = data.wireEncode(wireFormat);
+
+  Blob signatureBits = privateKeyStorage_->sign
+    (encoding.signedBuf(), encoding.signedSize(), keyName, digestAlgorithm);
+
+  setSignatureAndEncoding(data, encoding, signatureBits, wireFormat);
+  return signatureBits;
+}
+
+void
+IdentityManager::setPlaceholderSignature(Signature& signature, size_t length)
+{
+  signature.setSignature
+    (Blob(ptr_lib::make_shared<vector<uint8_t> >(length), false));
+}
+
+void
+IdentityManager::setSignatureAndEncoding
+  (Data& data, const SignedBlob& encoding, const Blob& signatureBits,
+   WireFormat& wireFormat)
+{
+  size_t placeholderSize = data.getSignature()->getSignature().size();
+  if (placeholderSize == 0 || signatureBits.size() != placeholderSize ||
+      &wireFormat != WireFormat::getDefaultWireFormat() ||
+      !dynamic_cast<Tlv0_2WireFormat*>(&wireFormat) ||
+      encoding.size() < encoding.getSignedPortionEndOffset() + placeholderSize) {
+    data.getSignature()->setSignature(signatureBits);
+    // Encode again to include the signature.
+    data.wireEncode(wireFormat);
+    return;
+  }
+
+  // The SignatureValue is the last field, so copy the encoding into a new
+  // buffer with the signature bits in place of the placeholder. Don't change
+  // the buffer of the encoding since other Blob objects may share it.
+  ptr_lib::shared_ptr<vector<uint8_t> > signedEncoding
+    (new vector<uint8_t>(encoding.buf(), encoding.buf() + encoding.size()));
+  memcpy(&(*signedEncoding)[signedEncoding->size() - signatureBits.size()],
+         signatureBits.buf(), signatureBits.size());
+
+  // This updates the change count of the Data, so set the default wire
+  // encoding after it.
+  data.getSignature()->setSignature(signatureBits);
+  data.setDefaultWireEncoding
+    (SignedBlob(Blob(signedEncoding, false),
+                encoding.getSignedPortionBeginOffset(),
+                encoding.getSignedPortionEndOffset()),
+     &wireFormat);
+}
+
+#if NDN_CPP_HAVE_STD_THREAD
+void
+IdentityManager::signBatchWorker
+  (const vector<Data*>* dataList, int iThread, int nThreads,
+   const Signature* signatureTemplate, const Name* keyName,
+   DigestAlgorithm digestAlgorithm, WireFormat* wireFormat,
+   string* errorMessage, mutex* errorMessageMutex)
+{
+  try {
+    for (size_t i = iThread; i < dataList->size(); i += nThreads)
+      signWithTemplate
+        (*(*dataList)[i], *signatureTemplate, *keyName, digestAlgorithm,
+         *wireFormat);
+  } catch (const std::exception& ex) {
+    lock_guard<mutex> lock(*errorMessageMutex);
+    if (*errorMessage == "")
+      *errorMessage = ex.what();
+  } catch (...) {
+    lock_guard<mutex> lock(*errorMessageMutex);
+    if (*errorMessage == "")
+      *errorMessage = "IdentityManager::signByCertificate: Error signing in a worker thread";
+  }
+}
+#endif
+
 ptr_lib::shared_ptr<Signature>
 IdentityManager::makeSignatureByCertificate
   (const Name& certificateName, DigestAlgorithm& digestAlgorithm)
 {
+  ptr_lib::shared_ptr<Signature> signature =
+    getSignatureTemplate(certificateName, digestAlgorithm)->clone();
+  // Don't give the application the placeholder signature value.
+  signature->setSignature(Blob());
+  return signature;
+}
+
+const ptr_lib::shared_ptr<Signature>&
+IdentityManager::getSignatureTemplate
+  (const Name& certificateName, DigestAlgorithm& digestAlgorithm)
+{
+  // All the supported signature types use SHA-256.
+  digestAlgorithm = DIGEST_ALGORITHM_SHA256;
+
+  map<Name, ptr_lib::shared_ptr<Signature> >::iterator found =
+    signatureTemplates_.find(certificateName);
+  if (found != signatureTemplates_.end())
+    return found->second;
+
   Name keyName = IdentityCertificate::certificateNameToPublicKeyName
     (certificateName);
   ptr_lib::shared_ptr<PublicKey> publicKey = privateKeyStorage_->getPublicKey
     (keyName);
   KeyType keyType = publicKey->getKeyType();
 
+  ptr_lib::shared_ptr<Signature> signature;
   if (keyType == KEY_TYPE_RSA) {
-    ptr_lib::shared_ptr<Sha256WithRsaSignature> signature
+    ptr_lib::shared_ptr<Sha256WithRsaSignature> rsaSignature
       (new Sha256WithRsaSignature());
-    digestAlgorithm = DIGEST_ALGORITHM_SHA256;
-
-    signature->getKeyLocator().setType(ndn_KeyLocatorType_KEYNAME);
-    signature->getKeyLocator().setKeyName(certificateName.getPrefix(-1));
-
-    return signature;
+    rsaSignature->getKeyLocator().setType(ndn_KeyLocatorType_KEYNAME);
+    rsaSignature->getKeyLocator().setKeyName(certificateName.getPrefix(-1));
+    signature = rsaSignature;
   }
   else if (keyType == KEY_TYPE_ECDSA) {
-    ptr_lib::shared_ptr<Sha256WithEcdsaSignature> signature
+    ptr_lib::shared_ptr<Sha256WithEcdsaSignature> ecdsaSignature
       (new Sha256WithEcdsaSignature());
-    digestAlgorithm = DIGEST_ALGORITHM_SHA256;
-
-    signature->getKeyLocator().setType(ndn_KeyLocatorType_KEYNAME);
-    signature->getKeyLocator().setKeyName(certificateName.getPrefix(-1));
-
-    return signature;
+    ecdsaSignature->getKeyLocator().setType(ndn_KeyLocatorType_KEYNAME);
+    ecdsaSignature->getKeyLocator().setKeyName(certificateName.getPrefix(-1));
+    signature = ecdsaSignature;
   }
   else
     throw SecurityException("Key type is not recognized");
+
+  return signatureTemplates_[certificateName] = signature;
 }
 
 }
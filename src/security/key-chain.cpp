@@ -20,6 +20,8 @@
  * A copy of the GNU Lesser General Public License is in the file COPYING.
  */
 
+#include <list>
+#include <map>
 #include <ndn-cpp/util/logging.hpp>
 #include <ndn-cpp/lite/util/crypto-lite.hpp>
 #include <ndn-cpp/lite/util/crypto-lite.hpp>
@@ -29,6 +31,7 @@
 #include <ndn-cpp/sha256-with-rsa-signature.hpp>
 #include <ndn-cpp/hmac-with-sha256-signature.hpp>
 #include <ndn-cpp/security/key-chain.hpp>
+#include "../c/util/time.h"
 
 INIT_LOGGER("ndn.KeyChain");
 
@@ -39,6 +42,123 @@ namespace ndn {
 
 const RsaKeyParams KeyChain::DEFAULT_KEY_PARAMS;
 
+/**
+ * A VerifiedDataCache holds the full names of the Data packets which were
+ * verified, with a limit on the number of entries (removing the least recently
+ * used) and a lifetime for each entry.
+ */
+class KeyChain::VerifiedDataCache {
+public:
+  VerifiedDataCache(size_t maxEntries, Milliseconds lifetime)
+  : maxEntries_(maxEntries), lifetime_(lifetime), policyChangeCount_(0)
+  {
+  }
+
+  /**
+   * Check if the Data packet with the full name was verified and has not
+   * expired. If found, mark it as the most recently used.
+   * @param fullName The full name of the Data packet.
+   * @param policyChangeCount The current change count of the policy manager.
+   * If this is different than when the entries were added, clear the cache.
+   * @param nowMilliseconds The current time in milliseconds since 1970.
+   * @return True if found.
+   */
+  bool
+  contains
+    (const Name& fullName, uint64_t policyChangeCount,
+     MillisecondsSince1970 nowMilliseconds);
+
+  /**
+   * Add the full name of the verified Data packet, removing the least recently
+   * used entry if the cache is full.
+   * @param fullName The full name of the Data packet.
+   * @param policyChangeCount The change count of the policy manager which
+   * verified the Data packet. If this is different than when the entries were
+   * added, first clear the cache.
+   * @param nowMilliseconds The current time in milliseconds since 1970.
+   */
+  void
+  add(const Name& fullName, uint64_t policyChangeCount,
+      MillisecondsSince1970 nowMilliseconds);
+
+private:
+  class Entry {
+  public:
+    MillisecondsSince1970 expirationTime_;
+    // The position of the map key in lru_.
+    list<const Name*>::iterator lruPosition_;
+  };
+
+  /**
+   * If policyChangeCount is different than policyChangeCount_, clear the cache
+   * and set policyChangeCount_.
+   */
+  void
+  checkPolicyChangeCount(uint64_t policyChangeCount);
+
+  size_t maxEntries_;
+  Milliseconds lifetime_;
+  uint64_t policyChangeCount_;
+  map<Name, Entry> entries_;
+  // lru_ has pointers to the keys of entries_. The least recently used is first.
+  list<const Name*> lru_;
+};
+
+bool
+KeyChain::VerifiedDataCache::contains
+  (const Name& fullName, uint64_t policyChangeCount,
+   MillisecondsSince1970 nowMilliseconds)
+{
+  checkPolicyChangeCount(policyChangeCount);
+
+  map<Name, Entry>::iterator entry = entries_.find(fullName);
+  if (entry == entries_.end())
+    return false;
+
+  if (nowMilliseconds >= entry->second.expirationTime_) {
+    lru_.erase(entry->second.lruPosition_);
+    entries_.erase(entry);
+    return false;
+  }
+
+  lru_.splice(lru_.end(), lru_, entry->second.lruPosition_);
+  return true;
+}
+
+void
+KeyChain::VerifiedDataCache::add
+  (const Name& fullName, uint64_t policyChangeCount,
+   MillisecondsSince1970 nowMilliseconds)
+{
+  checkPolicyChangeCount(policyChangeCount);
+
+  map<Name, Entry>::iterator entry = entries_.find(fullName);
+  if (entry != entries_.end())
+    lru_.splice(lru_.end(), lru_, entry->second.lruPosition_);
+  else {
+    if (entries_.size() >= maxEntries_) {
+      // Remove the least recently used.
+      entries_.erase(*lru_.front());
+      lru_.pop_front();
+    }
+
+    entry = entries_.insert(make_pair(fullName, Entry())).first;
+    entry->second.lruPosition_ = lru_.insert(lru_.end(), &entry->first);
+  }
+
+  entry->second.expirationTime_ = nowMilliseconds + lifetime_;
+}
+
+void
+KeyChain::VerifiedDataCache::checkPolicyChangeCount(uint64_t policyChangeCount)
+{
+  if (policyChangeCount != policyChangeCount_) {
+    entries_.clear();
+    lru_.clear();
+    policyChangeCount_ = policyChangeCount;
+  }
+}
+
 KeyChain::KeyChain
   (const ptr_lib::shared_ptr<IdentityManager>& identityManager,
    const ptr_lib::shared_ptr<PolicyManager>& policyManager)
@@ -104,8 +224,32 @@ KeyChain::verifyData
   _LOG_TRACE("Enter Verify");
 
   if (policyManager_->requireVerify(*data)) {
+    OnVerified onVerifiedToUse = onVerified;
+    if (verifiedDataCache_) {
+      // Let the policy manager update the change count before the lookup.
+      policyManager_->refresh();
+      uint64_t policyChangeCount = policyManager_->getChangeCount();
+      ptr_lib::shared_ptr<Name> fullName = data->getFullName();
+      if (verifiedDataCache_->contains
+          (*fullName, policyChangeCount, ndn_getNowMilliseconds())) {
+        try {
+          onVerified(data);
+        } catch (const std::exception& ex) {
+          _LOG_ERROR("KeyChain::verifyData: Error in onVerified: " << ex.what());
+        } catch (...) {
+          _LOG_ERROR("KeyChain::verifyData: Error in onVerified.");
+        }
+        return;
+      }
+
+      // Add the full name to the cache if the policy manager verifies it.
+      onVerifiedToUse = bind
+        (&KeyChain::onDataVerified, this, _1, fullName, policyChangeCount,
+         onVerified);
+    }
+
     ptr_lib::shared_ptr<ValidationRequest> nextStep = policyManager_->checkVerificationPolicy
-      (data, stepCount, onVerified, onValidationFailed);
+      (data, stepCount, onVerifiedToUse, onValidationFailed);
     if (nextStep)
       face_->expressInterest
         (*nextStep->interest_,
@@ -303,6 +447,34 @@ KeyChain::verifyInterestWithHmacWithSha256
 }
 #endif
 
+void
+KeyChain::setVerifiedDataCache(size_t maxEntries, Milliseconds lifetime)
+{
+  if (maxEntries == 0)
+    verifiedDataCache_.reset();
+  else
+    verifiedDataCache_.reset(new VerifiedDataCache(maxEntries, lifetime));
+}
+
+void
+KeyChain::setVerifierPool(const ptr_lib::shared_ptr<VerifierPool>& verifierPool)
+{
+  policyManager_->setVerifierPool(verifierPool);
+}
+
+void
+KeyChain::onDataVerified
+  (const ptr_lib::shared_ptr<Data>& data,
+   const ptr_lib::shared_ptr<Name>& fullName, uint64_t policyChangeCount,
+   const OnVerified& onVerified)
+{
+  if (verifiedDataCache_ &&
+      policyManager_->getChangeCount() == policyChangeCount)
+    verifiedDataCache_->add(*fullName, policyChangeCount, ndn_getNowMilliseconds());
+
+  onVerified(data);
+}
+
 void
 KeyChain::onCertificateData(const ptr_lib::shared_ptr<const Interest> &interest, const ptr_lib::shared_ptr<Data> &data, ptr_lib::shared_ptr<ValidationRequest> nextStep)
 {
@@ -30,14 +30,17 @@
 #include <sys/stat.h>
 #include <unistd.h>
 #include <stdexcept>
+#include <algorithm>
 #include <fstream>
 #include <sstream>
 #include <ndn-cpp/security/security-exception.hpp>
 #include <ndn-cpp/security/certificate/identity-certificate.hpp>
 #include "../../util/boost-info-parser.hpp"
+#include "../../impl/name-prefix-tree.hpp"
 #include "../../c/util/time.h"
 #include "../../encoding/base64.hpp"
 #include <ndn-cpp/util/logging.hpp>
+#include <ndn-cpp/security/policy/verifier-pool.hpp>
 #include <ndn-cpp/security/policy/config-policy-manager.hpp>
 
 using namespace std;
@@ -49,6 +52,53 @@ namespace ndn {
 
 using namespace regex_lib;
 
+/**
+ * Get the failure reason for when the signature does not verify.
+ * @param publicKeyDer The public key from findPublicKeyDer.
+ * @return The failure reason.
+ */
+static string
+getNotVerifiedReason(const Blob& publicKeyDer)
+{
+  if (publicKeyDer.isNull())
+    return "The non-KeyLocator signature did not verify";
+  else
+    return "The signature did not verify with the given public key";
+}
+
+/**
+ * This is called by the VerifierPool on the thread of the Face with the result
+ * of verifying the data signature. Call onVerified(data) or
+ * onValidationFailed(data, reason).
+ */
+static void
+onDataSignatureVerifyResult
+  (bool isVerified, const string& errorMessage,
+   const ptr_lib::shared_ptr<Data>& data, const OnVerified& onVerified,
+   const OnDataValidationFailed& onValidationFailed,
+   const string& notVerifiedReason)
+{
+  if (isVerified) {
+    try {
+      onVerified(data);
+    } catch (const std::exception& ex) {
+      _LOG_ERROR("ConfigPolicyManager::onDataSignatureVerifyResult: Error in onVerified: " << ex.what());
+    } catch (...) {
+      _LOG_ERROR("ConfigPolicyManager::onDataSignatureVerifyResult: Error in onVerified.");
+    }
+  }
+  else {
+    try {
+      onValidationFailed
+        (data, errorMessage != "" ? errorMessage : notVerifiedReason);
+    } catch (const std::exception& ex) {
+      _LOG_ERROR("ConfigPolicyManager::onDataSignatureVerifyResult: Error in onValidationFailed: " << ex.what());
+    } catch (...) {
+      _LOG_ERROR("ConfigPolicyManager::onDataSignatureVerifyResult: Error in onValidationFailed.");
+    }
+  }
+}
+
 /**
  * Ignore data and call onValidationFailed(interest, reason). This is so that an
  * OnInterestValidationFailed can be passed as an OnDataValidationFailed.
@@ -68,6 +118,136 @@ onInterestValidationFailedWrapper
   }
 }
 
+/**
+ * A CompiledRule holds a validator/rule from the configuration with its names
+ * parsed and its regular expressions compiled, so that matching a packet does
+ * not need to look up or parse the strings in the BoostInfoTree.
+ */
+class ConfigPolicyManager::CompiledRule {
+public:
+  /**
+   * A Filter is a "filter" of the rule, with either a regex matcher or a
+   * relation and name.
+   */
+  class Filter {
+  public:
+    // regex_ is null if this is a relation filter.
+    ptr_lib::shared_ptr<NdnRegexTopMatcher> regex_;
+    string relation_;
+    Name name_;
+  };
+
+  /**
+   * Create a CompiledRule for the validator/rule.
+   * @param rule The validator/rule from the configuration. This keeps a
+   * pointer to it, so it must remain valid while this object is used.
+   * @param ruleIndex The position of the rule in the configuration.
+   * @throws NdnRegexMatcherBase::Error if a regular expression is invalid.
+   */
+  CompiledRule(const BoostInfoTree& rule, size_t ruleIndex);
+
+  /**
+   * Check if the name passes all the filters of this rule.
+   * @param objName The name to check.
+   * @return True if all filters pass (or there are no filters).
+   */
+  bool
+  matchesFilters(const Name& objName) const;
+
+  /**
+   * Get the relation filter whose name is used to index this rule. Every
+   * supported relation requires the filter name to be a prefix of the name
+   * being matched.
+   * @return The first relation filter, or 0 if this rule has no relation
+   * filter.
+   */
+  const Filter*
+  getIndexFilter() const;
+
+  const BoostInfoTree* rule_;
+  size_t ruleIndex_;
+  string matchType_;
+  vector<Filter> filters_;
+
+  // The checker.
+  string checkerType_;
+  string sigType_;
+  // For a fixed-signer checker.
+  string signerType_;
+  string signerId_;
+  // For a customized checker with a key-locator relation.
+  string keyRelation_;
+  Name keyName_;
+  // For a customized checker with a key-locator regex.
+  string keyRegexString_;
+  ptr_lib::shared_ptr<NdnRegexTopMatcher> keyRegex_;
+  // For a customized checker with a key-locator hyper-relation.
+  string hyperKeyRegexString_;
+  ptr_lib::shared_ptr<NdnRegexTopMatcher> hyperKeyRegex_;
+  string hyperKeyExpansion_;
+  string hyperNameRegexString_;
+  ptr_lib::shared_ptr<NdnRegexTopMatcher> hyperNameRegex_;
+  string hyperNameExpansion_;
+  string hyperRelation_;
+};
+
+/**
+ * A RuleSet holds the CompiledRule for each validator/rule. Rules with a
+ * relation filter are indexed by the filter name so that finding the matching
+ * rule for a packet only checks the rules whose filter name is a prefix of the
+ * packet name, plus the rules which can't be indexed.
+ */
+class ConfigPolicyManager::RuleSet {
+public:
+  /**
+   * Create a RuleSet for the validator/rule entries in the configuration.
+   * @param root The root of the configuration.
+   * @throws NdnRegexMatcherBase::Error if a regular expression is invalid.
+   */
+  RuleSet(const BoostInfoTree& root);
+
+  /**
+   * Find the first rule (in configuration order) that matches the name.
+   * @param objName The name to be matched.
+   * @param matchType The rule type to match, "data" or "interest".
+   * @return The matching rule, or 0 if not found.
+   */
+  const CompiledRule*
+  findMatchingRule(const Name& objName, const string& matchType) const;
+
+  /**
+   * Get the CompiledRule for the validator/rule.
+   * @param rule The validator/rule from the configuration.
+   * @return The CompiledRule, or 0 if the rule is not in this RuleSet.
+   */
+  const CompiledRule*
+  getRule(const BoostInfoTree& rule) const;
+
+  /**
+   * The RuleIndex has the rules for one matchType. The values are indexes
+   * into rules_.
+   */
+  class RuleIndex {
+  public:
+    NamePrefixTree<size_t> relationRules_;
+    // unindexedRules_ is in increasing order.
+    vector<size_t> unindexedRules_;
+  };
+
+  // The rules in configuration order.
+  vector<ptr_lib::shared_ptr<CompiledRule> > rules_;
+  // The key is the matchType.
+  map<string, RuleIndex> ruleIndexes_;
+  map<const BoostInfoTree*, size_t> ruleByTree_;
+  // The matcher for hierarchical checkers.
+  ptr_lib::shared_ptr<NdnRegexTopMatcher> hierarchicalIdentityRegex_;
+};
+
+// The regex of the signing identity for a hierarchical checker. That means
+// everything before "ksk-?" in the key name.
+static const char* const hierarchicalIdentityRegex =
+  "^([^<KEY>]*)<KEY>(<>*)<ksk-.+><ID-CERT>";
+
 ConfigPolicyManager::ConfigPolicyManager
   (const string& configFileName,
    const ptr_lib::shared_ptr<CertificateCache>& certificateCache,
@@ -76,7 +256,8 @@ ConfigPolicyManager::ConfigPolicyManager
   : maxDepth_(searchDepth),
     keyGraceInterval_(graceInterval),
     keyTimestampTtl_(keyTimestampTtl),
-    maxTrackedKeys_(maxTrackedKeys)
+    maxTrackedKeys_(maxTrackedKeys),
+    changeCount_(0)
 {
   if (!certificateCache)
     certificateCache_.reset(new CertificateCache());
@@ -100,7 +281,9 @@ ConfigPolicyManager::reset()
   fixedCertificateCache_.clear();
   keyTimestamps_.clear();
   requiresVerification_ = true;
+  ++changeCount_;
   config_.reset(new BoostInfoParser());
+  ruleSet_.reset(new RuleSet(config_->getRoot()));
   refreshManager_.reset(new TrustAnchorRefreshManager());
 }
 
@@ -109,6 +292,7 @@ ConfigPolicyManager::load(const std::string& configFileName)
 {
   reset();
   config_->read(configFileName);
+  ruleSet_.reset(new RuleSet(config_->getRoot()));
   loadTrustAnchorCertificates();
 }
 
@@ -117,6 +301,7 @@ ConfigPolicyManager::load(const std::string& input, const std::string& inputName
 {
   reset();
   config_->read(input, inputName);
+  ruleSet_.reset(new RuleSet(config_->getRoot()));
   loadTrustAnchorCertificates();
 }
 
@@ -170,6 +355,29 @@ ConfigPolicyManager::checkVerificationPolicy
        bind(&ConfigPolicyManager::onCertificateDownloadComplete, this, _1,
             data, stepCount, onVerified, onValidationFailed),
        onValidationFailed, 2, stepCount + 1);
+  else if (verifierPool_) {
+    // Certificate is known. Find the public key here and verify the signature
+    // on a worker thread, which posts the result to the thread of the Face.
+    Blob publicKeyDer;
+    if (findPublicKeyDer(data->getSignature(), publicKeyDer, failureReason))
+      // Pass a clone of the signature in case the application modifies data.
+      // wireEncode returns the cached encoding if available.
+      verifierPool_->verifySignature
+        (data->getSignature()->clone(), data->wireEncode(), publicKeyDer,
+         bind(&onDataSignatureVerifyResult, _1, _2, data, onVerified,
+              onValidationFailed, getNotVerifiedReason(publicKeyDer)));
+    else {
+      try {
+        onValidationFailed(data, failureReason);
+      } catch (const std::exception& ex) {
+        _LOG_ERROR("ConfigPolicyManager::checkVerificationPolicy: Error in onValidationFailed: " << ex.what());
+      } catch (...) {
+        _LOG_ERROR("ConfigPolicyManager::checkVerificationPolicy: Error in onValidationFailed.");
+      }
+    }
+
+    return ptr_lib::shared_ptr<ValidationRequest>();
+  }
   else {
     // Certificate is known. Verify the signature.
     // wireEncode returns the cached encoding if available.
@@ -300,7 +508,8 @@ ConfigPolicyManager::getCertificateInterest
   }
 
   // first see if we can find a rule to match this packet
-  const BoostInfoTree* matchedRule = findMatchingRule(objectName, matchType);
+  const CompiledRule* matchedRule = findMatchingCompiledRule
+    (objectName, matchType);
 
   // No matching rule -> fail.
   if (!matchedRule) {
@@ -309,10 +518,8 @@ ConfigPolicyManager::getCertificateInterest
   }
 
   // Do a quick check if this is sig-type sha256.
-  const BoostInfoTree& checker = *(*matchedRule)["checker"][0];
-  const string& checkerType = checker["type"][0]->getValue();
-  if (checkerType == "customized" &&
-      checker["sig-type"][0]->getValue() == "sha256")
+  if (matchedRule->checkerType_ == "customized" &&
+      matchedRule->sigType_ == "sha256")
     // The signature is a simple DigestSha256 so we don't fetch certificates.
     return ptr_lib::make_shared<Interest>();
 
@@ -337,11 +544,11 @@ ConfigPolicyManager::getCertificateInterest
     return ptr_lib::shared_ptr<Interest>();
 
   // Before we look up keys, refresh any certificate directories.
-  refreshManager_->refreshAnchors();
+  refresh();
 
   // If we don't actually have the certificate yet, return a certificateInterest
   //   for it.
-  ptr_lib::shared_ptr<IdentityCertificate> foundCert =
+  ptr_lib::shared_ptr<const IdentityCertificate> foundCert =
     refreshManager_->getCertificate(signatureName);
   if (!foundCert)
     foundCert = certificateCache_->getCertificate(signatureName);
@@ -457,26 +664,39 @@ ConfigPolicyManager::checkSignatureMatch
   (const Name& signatureName, const Name& objectName, const BoostInfoTree& rule,
    string& failureReason)
 {
-  const BoostInfoTree& checker = *rule["checker"][0];
-  const string& checkerType = checker["type"][0]->getValue();
+  const CompiledRule* compiledRule = ruleSet_->getRule(rule);
+  if (!compiledRule) {
+    failureReason = "The rule is not in the loaded configuration";
+    return false;
+  }
+
+  return checkSignatureMatch
+    (signatureName, objectName, *compiledRule, failureReason);
+}
+
+bool
+ConfigPolicyManager::checkSignatureMatch
+  (const Name& signatureName, const Name& objectName, const CompiledRule& rule,
+   string& failureReason)
+{
+  const string& checkerType = rule.checkerType_;
   if (checkerType == "fixed-signer") {
-    const BoostInfoTree& signerInfo = *checker["signer"][0];
-    const string& signerType = signerInfo["type"][0]->getValue();
+    const string& signerType = rule.signerType_;
 
-    ptr_lib::shared_ptr<Certificate> cert;
+    ptr_lib::shared_ptr<const Certificate> cert;
     if (signerType == "file") {
-      cert = lookupCertificate(signerInfo["file-name"][0]->getValue(), true);
+      cert = lookupCertificate(rule.signerId_, true);
       if (!cert) {
         failureReason = "Can't find fixed-signer certificate file: " +
-          signerInfo["file-name"][0]->getValue();
+          rule.signerId_;
         return false;
       }
     }
     else if (signerType == "base64") {
-      cert = lookupCertificate(signerInfo["base64-string"][0]->getValue(), false);
+      cert = lookupCertificate(rule.signerId_, false);
       if (!cert) {
         failureReason = "Can't find fixed-signer certificate base64: " +
-          signerInfo["base64-string"][0]->getValue();
+          rule.signerId_;
         return false;
       }
     }
@@ -495,9 +715,7 @@ ConfigPolicyManager::checkSignatureMatch
   }
   else if (checkerType == "hierarchical") {
     // This just means the data/interest name has the signing identity as a prefix.
-    // That means everything before "ksk-?" in the key name.
-    string identityRegex = "^([^<KEY>]*)<KEY>(<>*)<ksk-.+><ID-CERT>";
-    NdnRegexTopMatcher identityMatch(identityRegex);
+    NdnRegexTopMatcher& identityMatch = *ruleSet_->hierarchicalIdentityRegex_;
     if (identityMatch.match(signatureName)) {
       Name identityPrefix = identityMatch.expand("\\1")
         .append(identityMatch.expand("\\2"));
@@ -510,78 +728,65 @@ ConfigPolicyManager::checkSignatureMatch
       }
     }
     else {
-      failureReason = "The hierarchical identityRegex \"" + identityRegex +
+      failureReason = "The hierarchical identityRegex \"" +
+        string(hierarchicalIdentityRegex) +
         "\" does not match signatureName \"" + signatureName.toUri() + "\"";
       return false;
     }
   }
   else if (checkerType == "customized") {
-    const BoostInfoTree& keyLocatorInfo = *checker["key-locator"][0];
     // Not checking type - only name is supported.
 
     // Is this a simple relation?
-    const string* relationType = keyLocatorInfo.getFirstValue("relation");
-    if (relationType) {
-      Name matchName(keyLocatorInfo["name"][0]->getValue());
-      if (matchesRelation(signatureName, matchName, *relationType))
+    if (rule.keyRelation_ != "") {
+      if (matchesRelation(signatureName, rule.keyName_, rule.keyRelation_))
         return true;
       else {
         failureReason = "The custom signatureName \"" + signatureName.toUri() +
-          "\" does not match matchName \"" + matchName.toUri() +
-          "\" using relation " + *relationType;
+          "\" does not match matchName \"" + rule.keyName_.toUri() +
+          "\" using relation " + rule.keyRelation_;
         return false;
       }
     }
 
     // Is this a simple regex?
-    const string* keyRegex = keyLocatorInfo.getFirstValue("regex");
-    if (keyRegex) {
-      if (NdnRegexTopMatcher(*keyRegex).match(signatureName))
+    if (rule.keyRegex_) {
+      if (rule.keyRegex_->match(signatureName))
         return true;
       else {
         failureReason = "The custom signatureName \"" + signatureName.toUri() +
-          "\" does not regex match keyRegex \"" + *keyRegex + "\"";
+          "\" does not regex match keyRegex \"" + rule.keyRegexString_ + "\"";
         return false;
       }
     }
 
     // Is this a hyper-relation?
-    vector<const BoostInfoTree*> hyperRelationList = keyLocatorInfo["hyper-relation"];
-    if (hyperRelationList.size() >= 1) {
-      const BoostInfoTree& hyperRelation = *hyperRelationList[0];
+    if (rule.hyperKeyRegex_) {
+      NdnRegexTopMatcher& keyMatch = *rule.hyperKeyRegex_;
+      if (!keyMatch.match(signatureName)) {
+        failureReason = "The custom hyper-relation signatureName \"" +
+          signatureName.toUri() + "\" does not match the keyRegex \"" +
+          rule.hyperKeyRegexString_ + "\"";
+        return false;
+      }
+      Name keyMatchPrefix = keyMatch.expand(rule.hyperKeyExpansion_);
 
-      const string* keyRegex = hyperRelation.getFirstValue("k-regex");
-      const string* keyExpansion = hyperRelation.getFirstValue("k-expand");
-      const string* nameRegex = hyperRelation.getFirstValue("p-regex");
-      const string* nameExpansion = hyperRelation.getFirstValue("p-expand");
-      const string* relationType = hyperRelation.getFirstValue("h-relation");
-      if (keyRegex && keyExpansion && nameRegex && nameExpansion && relationType) {
-        NdnRegexTopMatcher keyMatch(*keyRegex);
-        if (!keyMatch.match(signatureName)) {
-          failureReason = "The custom hyper-relation signatureName \"" +
-            signatureName.toUri() + "\" does not match the keyRegex \"" +
-            *keyRegex + "\"";
-          return false;
-        }
-        Name keyMatchPrefix = keyMatch.expand(*keyExpansion);
-
-        NdnRegexTopMatcher nameMatch(*nameRegex);
-        if (!nameMatch.match(objectName)) {
-          failureReason = "The custom hyper-relation objectName \"" +
-            objectName.toUri() + "\" does not match the nameRegex \"" +
-            *nameRegex + "\"";
-          return false;
-        }
-        Name nameMatchExpansion = nameMatch.expand(*nameExpansion);
+      NdnRegexTopMatcher& nameMatch = *rule.hyperNameRegex_;
+      if (!nameMatch.match(objectName)) {
+        failureReason = "The custom hyper-relation objectName \"" +
+          objectName.toUri() + "\" does not match the nameRegex \"" +
+          rule.hyperNameRegexString_ + "\"";
+        return false;
+      }
+      Name nameMatchExpansion = nameMatch.expand(rule.hyperNameExpansion_);
 
-        if (matchesRelation(nameMatchExpansion, keyMatchPrefix, *relationType))
-          return true;
-        else {
-          failureReason = "The custom hyper-relation nameMatch \"" +
-            nameMatchExpansion.toUri() + "\" does not match the keyMatchPrefix \"" +
-            keyMatchPrefix.toUri() + "\" using relation " + *relationType;
-          return false;
-        }
+      if (matchesRelation(nameMatchExpansion, keyMatchPrefix, rule.hyperRelation_))
+        return true;
+      else {
+        failureReason = "The custom hyper-relation nameMatch \"" +
+          nameMatchExpansion.toUri() + "\" does not match the keyMatchPrefix \"" +
+          keyMatchPrefix.toUri() + "\" using relation " + rule.hyperRelation_;
+        return false;
       }
     }
   }
@@ -590,29 +795,31 @@ ConfigPolicyManager::checkSignatureMatch
   return false;
 }
 
-ptr_lib::shared_ptr<IdentityCertificate>
+ptr_lib::shared_ptr<const IdentityCertificate>
 ConfigPolicyManager::lookupCertificate(const string& certID, bool isPath)
 {
-  ptr_lib::shared_ptr<IdentityCertificate> cert;
-
-  map<string, string>::iterator iCertUri = fixedCertificateCache_.find(certID);
-  if (iCertUri == fixedCertificateCache_.end()) {
-    if (isPath)
-      // Load the certificate data (base64 encoded IdentityCertificate)
-      cert = TrustAnchorRefreshManager::loadIdentityCertificateFromFile(certID);
-    else {
-      vector<uint8_t> certData;
-      fromBase64(certID.c_str(), certData);
-      cert.reset(new IdentityCertificate());
-      cert->wireDecode(certData);
-    }
+  map<string, Name>::iterator iCertName = fixedCertificateCache_.find(certID);
+  if (iCertName != fixedCertificateCache_.end()) {
+    ptr_lib::shared_ptr<const IdentityCertificate> cachedCert =
+      certificateCache_->getCertificate(iCertName->second);
+    if (cachedCert)
+      return cachedCert;
+    // The certificate cache is bounded and removed it, so load it again.
+  }
 
-    string certUri = cert->getName().getPrefix(-1).toUri();
-    fixedCertificateCache_[certID] = certUri;
-    certificateCache_->insertCertificate(*cert);
+  ptr_lib::shared_ptr<IdentityCertificate> cert;
+  if (isPath)
+    // Load the certificate data (base64 encoded IdentityCertificate)
+    cert = TrustAnchorRefreshManager::loadIdentityCertificateFromFile(certID);
+  else {
+    vector<uint8_t> certData;
+    fromBase64(certID.c_str(), certData);
+    cert.reset(new IdentityCertificate());
+    cert->wireDecode(certData);
   }
-  else
-    cert = certificateCache_->getCertificate(Name(iCertUri->second));
+
+  fixedCertificateCache_[certID] = cert->getName().getPrefix(-1);
+  certificateCache_->insertCertificate(*cert);
 
   return cert;
 }
@@ -621,45 +828,214 @@ const BoostInfoTree*
 ConfigPolicyManager::findMatchingRule
   (const Name& objName, const string& matchType) const
 {
-  vector<const BoostInfoTree*> rules = config_->getRoot()["validator/rule"];
-  for (size_t iRule = 0; iRule < rules.size(); ++iRule) {
-    const BoostInfoTree& r = *rules[iRule];
-
-    if (r["for"][0]->getValue() == matchType) {
-      bool passed = true;
-      vector<const BoostInfoTree*> filters = r["filter"];
-      if (filters.size() == 0)
-        // no filters means we pass!
-        return &r;
-      else {
-        for (size_t iFilter = 0; iFilter < filters.size(); ++iFilter) {
-          const BoostInfoTree& f = *filters[iFilter];
-
-          // Don't check the type - it can only be name for now.
-          // We need to see if this is a regex or a relation.
-          const string* regexPattern = f.getFirstValue("regex");
-          if (!regexPattern) {
-            const string& matchRelation = f["relation"][0]->getValue();
-            const string& matchUri = f["name"][0]->getValue();
-            Name matchName(matchUri);
-            passed = matchesRelation(objName, matchName, matchRelation);
-          }
-          else
-            passed = NdnRegexTopMatcher(*regexPattern).match(objName);
+  const CompiledRule* rule = findMatchingCompiledRule(objName, matchType);
+  return rule ? rule->rule_ : 0;
+}
 
-          if (!passed)
-            break;
-        }
+const ConfigPolicyManager::CompiledRule*
+ConfigPolicyManager::findMatchingCompiledRule
+  (const Name& objName, const string& matchType) const
+{
+  return ruleSet_->findMatchingRule(objName, matchType);
+}
+
+ConfigPolicyManager::CompiledRule::CompiledRule
+  (const BoostInfoTree& rule, size_t ruleIndex)
+: rule_(&rule), ruleIndex_(ruleIndex)
+{
+  const string* matchType = rule.getFirstValue("for");
+  if (matchType)
+    matchType_ = *matchType;
+
+  vector<const BoostInfoTree*> filters = rule["filter"];
+  for (size_t iFilter = 0; iFilter < filters.size(); ++iFilter) {
+    const BoostInfoTree& f = *filters[iFilter];
+    Filter filter;
+
+    // Don't check the type - it can only be name for now.
+    // We need to see if this is a regex or a relation.
+    const string* regexPattern = f.getFirstValue("regex");
+    if (!regexPattern) {
+      const string* matchRelation = f.getFirstValue("relation");
+      const string* matchUri = f.getFirstValue("name");
+      if (matchRelation)
+        filter.relation_ = *matchRelation;
+      if (matchUri)
+        filter.name_ = Name(*matchUri);
+    }
+    else
+      filter.regex_.reset(new NdnRegexTopMatcher(*regexPattern));
+
+    filters_.push_back(filter);
+  }
+
+  vector<const BoostInfoTree*> checkers = rule["checker"];
+  if (checkers.size() == 0)
+    return;
+  const BoostInfoTree& checker = *checkers[0];
+
+  const string* checkerType = checker.getFirstValue("type");
+  if (checkerType)
+    checkerType_ = *checkerType;
+  const string* sigType = checker.getFirstValue("sig-type");
+  if (sigType)
+    sigType_ = *sigType;
+
+  if (checkerType_ == "fixed-signer") {
+    vector<const BoostInfoTree*> signers = checker["signer"];
+    if (signers.size() >= 1) {
+      const BoostInfoTree& signerInfo = *signers[0];
+      const string* signerType = signerInfo.getFirstValue("type");
+      if (signerType)
+        signerType_ = *signerType;
+
+      const string* signerId = 0;
+      if (signerType_ == "file")
+        signerId = signerInfo.getFirstValue("file-name");
+      else if (signerType_ == "base64")
+        signerId = signerInfo.getFirstValue("base64-string");
+      if (signerId)
+        signerId_ = *signerId;
+    }
+  }
+  else if (checkerType_ == "customized") {
+    vector<const BoostInfoTree*> keyLocators = checker["key-locator"];
+    if (keyLocators.size() == 0)
+      return;
+    const BoostInfoTree& keyLocatorInfo = *keyLocators[0];
 
-        if (passed)
-          return &r;
+    const string* relationType = keyLocatorInfo.getFirstValue("relation");
+    if (relationType) {
+      keyRelation_ = *relationType;
+      const string* keyUri = keyLocatorInfo.getFirstValue("name");
+      if (keyUri)
+        keyName_ = Name(*keyUri);
+      return;
+    }
+
+    const string* keyRegex = keyLocatorInfo.getFirstValue("regex");
+    if (keyRegex) {
+      keyRegexString_ = *keyRegex;
+      keyRegex_.reset(new NdnRegexTopMatcher(*keyRegex));
+      return;
+    }
+
+    vector<const BoostInfoTree*> hyperRelationList =
+      keyLocatorInfo["hyper-relation"];
+    if (hyperRelationList.size() >= 1) {
+      const BoostInfoTree& hyperRelation = *hyperRelationList[0];
+
+      const string* keyRegex = hyperRelation.getFirstValue("k-regex");
+      const string* keyExpansion = hyperRelation.getFirstValue("k-expand");
+      const string* nameRegex = hyperRelation.getFirstValue("p-regex");
+      const string* nameExpansion = hyperRelation.getFirstValue("p-expand");
+      const string* relationType = hyperRelation.getFirstValue("h-relation");
+      if (keyRegex && keyExpansion && nameRegex && nameExpansion && relationType) {
+        hyperKeyRegexString_ = *keyRegex;
+        hyperKeyRegex_.reset(new NdnRegexTopMatcher(*keyRegex));
+        hyperKeyExpansion_ = *keyExpansion;
+        hyperNameRegexString_ = *nameRegex;
+        hyperNameRegex_.reset(new NdnRegexTopMatcher(*nameRegex));
+        hyperNameExpansion_ = *nameExpansion;
+        hyperRelation_ = *relationType;
       }
     }
   }
+}
+
+bool
+ConfigPolicyManager::CompiledRule::matchesFilters(const Name& objName) const
+{
+  for (size_t i = 0; i < filters_.size(); ++i) {
+    const Filter& filter = filters_[i];
+
+    bool passed;
+    if (filter.regex_)
+      passed = filter.regex_->match(objName);
+    else
+      passed = matchesRelation(objName, filter.name_, filter.relation_);
+
+    if (!passed)
+      return false;
+  }
+
+  // No filters means we pass.
+  return true;
+}
+
+const ConfigPolicyManager::CompiledRule::Filter*
+ConfigPolicyManager::CompiledRule::getIndexFilter() const
+{
+  for (size_t i = 0; i < filters_.size(); ++i) {
+    const Filter& filter = filters_[i];
+    if (!filter.regex_ &&
+        (filter.relation_ == "is-prefix-of" ||
+         filter.relation_ == "is-strict-prefix-of" ||
+         filter.relation_ == "equal"))
+      return &filter;
+  }
+
+  return 0;
+}
+
+ConfigPolicyManager::RuleSet::RuleSet(const BoostInfoTree& root)
+: hierarchicalIdentityRegex_
+    (new NdnRegexTopMatcher(hierarchicalIdentityRegex))
+{
+  vector<const BoostInfoTree*> rules = root["validator/rule"];
+  for (size_t iRule = 0; iRule < rules.size(); ++iRule) {
+    ptr_lib::shared_ptr<CompiledRule> rule
+      (new CompiledRule(*rules[iRule], iRule));
+    rules_.push_back(rule);
+    ruleByTree_[rules[iRule]] = iRule;
+
+    RuleIndex& ruleIndex = ruleIndexes_[rule->matchType_];
+    const CompiledRule::Filter* indexFilter = rule->getIndexFilter();
+    if (indexFilter)
+      ruleIndex.relationRules_.add
+        (indexFilter->name_, indexFilter->name_.size(), iRule);
+    else
+      ruleIndex.unindexedRules_.push_back(iRule);
+  }
+}
+
+const ConfigPolicyManager::CompiledRule*
+ConfigPolicyManager::RuleSet::findMatchingRule
+  (const Name& objName, const string& matchType) const
+{
+  map<string, RuleIndex>::const_iterator ruleIndex =
+    ruleIndexes_.find(matchType);
+  if (ruleIndex == ruleIndexes_.end())
+    return 0;
+
+  // A rule with a relation filter can only match if the filter name is a
+  // prefix of objName. Check the candidates in configuration order.
+  vector<size_t> candidates(ruleIndex->second.unindexedRules_);
+  size_t nUnindexed = candidates.size();
+  ruleIndex->second.relationRules_.getPrefixValues(objName, candidates);
+  if (candidates.size() > nUnindexed)
+    sort(candidates.begin(), candidates.end());
+
+  for (size_t i = 0; i < candidates.size(); ++i) {
+    const CompiledRule& rule = *rules_[candidates[i]];
+    if (rule.matchesFilters(objName))
+      return &rule;
+  }
 
   return 0;
 }
 
+const ConfigPolicyManager::CompiledRule*
+ConfigPolicyManager::RuleSet::getRule(const BoostInfoTree& rule) const
+{
+  map<const BoostInfoTree*, size_t>::const_iterator found =
+    ruleByTree_.find(&rule);
+  if (found == ruleByTree_.end())
+    return 0;
+  else
+    return rules_[found->second].get();
+}
+
 bool
 ConfigPolicyManager::matchesRelation
   (const Name& name, const Name& matchName, const string& matchRelation)
@@ -709,8 +1085,8 @@ ConfigPolicyManager::interestTimestampIsFresh
   (const Name& keyName, MillisecondsSince1970 timestamp,
    string& failureReason) const
 {
-  map<string, MillisecondsSince1970>::const_iterator lastTimestamp =
-    keyTimestamps_.find(keyName.toUri());
+  NameMap<MillisecondsSince1970>::type::const_iterator lastTimestamp =
+    keyTimestamps_.find(keyName);
   if (lastTimestamp == keyTimestamps_.end()) {
     MillisecondsSince1970 now = ndn_getNowMilliseconds();
     MillisecondsSince1970 notBefore = now - keyGraceInterval_;
@@ -742,25 +1118,28 @@ void
 ConfigPolicyManager::updateTimestampForKey
   (const Name& keyName, MillisecondsSince1970 timestamp)
 {
-  keyTimestamps_[keyName.toUri()] = timestamp;
+  keyTimestamps_[keyName] = timestamp;
 
   if (keyTimestamps_.size() >= maxTrackedKeys_) {
     MillisecondsSince1970 now = ndn_getNowMilliseconds();
     MillisecondsSince1970 oldestTimestamp = now;
-    string oldestKey;
+    Name oldestKey;
+    bool haveOldestKey = false;
 
     // Get the keys to erase without disturbing the map.
-    vector<string> keysToErase;
+    vector<Name> keysToErase;
 
-    for (map<string, MillisecondsSince1970>::iterator entry = keyTimestamps_.begin();
+    for (NameMap<MillisecondsSince1970>::type::iterator entry =
+           keyTimestamps_.begin();
          entry != keyTimestamps_.end(); ++entry) {
-      const string& keyUri = entry->first;
+      const Name& entryKeyName = entry->first;
       MillisecondsSince1970 ts = entry->second;
       if (now - ts > keyTimestampTtl_)
-        keysToErase.push_back(keyUri);
+        keysToErase.push_back(entryKeyName);
       else if (ts < oldestTimestamp) {
         oldestTimestamp = ts;
-        oldestKey = keyUri;
+        oldestKey = entryKeyName;
+        haveOldestKey = true;
       }
     }
 
@@ -768,7 +1147,7 @@ ConfigPolicyManager::updateTimestampForKey
     for (size_t i = 0; i < keysToErase.size(); ++i)
       keyTimestamps_.erase(keysToErase[i]);
 
-    if (keyTimestamps_.size() > maxTrackedKeys_ && oldestKey != "")
+    if (keyTimestamps_.size() > maxTrackedKeys_ && haveOldestKey)
       // have not removed enough
       keyTimestamps_.erase(oldestKey);
   }
@@ -778,24 +1157,37 @@ bool
 ConfigPolicyManager::verify
   (const Signature* signatureInfo, const SignedBlob& signedBlob,
    string& failureReason) const
+{
+  Blob publicKeyDer;
+  if (!findPublicKeyDer(signatureInfo, publicKeyDer, failureReason))
+    return false;
+
+  if (verifySignature(signatureInfo, signedBlob, publicKeyDer))
+    return true;
+  else {
+    failureReason = getNotVerifiedReason(publicKeyDer);
+    return false;
+  }
+}
+
+bool
+ConfigPolicyManager::findPublicKeyDer
+  (const Signature* signatureInfo, Blob& publicKeyDer,
+   string& failureReason) const
 {
   // We have already checked once if there should be a key locator.
   if (!KeyLocator::canGetFromSignature(signatureInfo)) {
     // There is no KeyLocator, so assume it is not needed (such as DigestSha256).
-    if (verifySignature(signatureInfo, signedBlob, Blob()))
-      return true;
-    else {
-      failureReason = "The non-KeyLocator signature did not verify";
-      return false;
-    }
+    publicKeyDer = Blob();
+    return true;
   }
 
   const KeyLocator& keyLocator = KeyLocator::getFromSignature(signatureInfo);
 
   if (keyLocator.getType() == ndn_KeyLocatorType_KEYNAME) {
     // Assume the key name is a certificate name.
-    Name signatureName = keyLocator.getKeyName();
-    ptr_lib::shared_ptr<IdentityCertificate> certificate =
+    const Name& signatureName = keyLocator.getKeyName();
+    ptr_lib::shared_ptr<const IdentityCertificate> certificate =
       refreshManager_->getCertificate(signatureName);
     if (!certificate)
       certificate = certificateCache_->getCertificate(signatureName);
@@ -805,7 +1197,7 @@ ConfigPolicyManager::verify
       return false;
     }
 
-    Blob publicKeyDer = certificate->getPublicKeyInfo().getKeyDer();
+    publicKeyDer = certificate->getPublicKeyInfo().getKeyDer();
     if (publicKeyDer.isNull()) {
       // We don't expect this to happen.
       failureReason = "There is no public key in the certificate with name " +
@@ -813,12 +1205,7 @@ ConfigPolicyManager::verify
       return false;
     }
 
-    if (verifySignature(signatureInfo, signedBlob, publicKeyDer))
-      return true;
-    else {
-      failureReason = "The signature did not verify with the given public key";
-      return false;
-    }
+    return true;
   }
   else {
     failureReason = "The KeyLocator does not have a key name";
@@ -888,6 +1275,13 @@ ConfigPolicyManager::TrustAnchorRefreshManager::addDirectory
 }
 
 void
+ConfigPolicyManager::refresh()
+{
+  if (refreshManager_->refreshAnchors())
+    ++changeCount_;
+}
+
+bool
 ConfigPolicyManager::TrustAnchorRefreshManager::refreshAnchors()
 {
   MillisecondsSince1970 refreshTime = ndn_getNowMilliseconds();
@@ -895,11 +1289,17 @@ ConfigPolicyManager::TrustAnchorRefreshManager::refreshAnchors()
   //   modify refreshDirectories_ while we are iterating.
   vector<string> directoriesToAdd;
   vector<MillisecondsSince1970> refreshPeriodsToAdd;
+  // The encoding of each reloaded certificate before the reload, to check if
+  // the reload changes the trust anchors.
+  map<string, Blob> oldCertificates;
 
   for (map<string, ptr_lib::shared_ptr<DirectoryInfo> >::iterator it =
         refreshDirectories_.begin(); it != refreshDirectories_.end(); ++it) {
     const string& directory = it->first;
     const DirectoryInfo& info = *(it->second);
+    if (info.refreshPeriod_ <= 0)
+      // The directory has no refresh period, so it is only loaded once.
+      continue;
 
     MillisecondsSince1970 nextRefreshTime = info.nextRefresh_;
     if (nextRefreshTime <= refreshTime) {
@@ -908,8 +1308,14 @@ ConfigPolicyManager::TrustAnchorRefreshManager::refreshAnchors()
       // Delete the certificates associated with this directory if possible
       //   then re-import.
       // IdentityStorage subclasses may not support deletion.
-      for (size_t i = 0; i < certificateList.size(); ++i)
-        certificateCache_.deleteCertificate(Name(certificateList[i]));
+      for (size_t i = 0; i < certificateList.size(); ++i) {
+        Name certificateName(certificateList[i]);
+        ptr_lib::shared_ptr<const IdentityCertificate> certificate =
+          certificateCache_.getCertificate(certificateName);
+        if (certificate)
+          oldCertificates[certificateList[i]] = certificate->wireEncode();
+        certificateCache_.deleteCertificate(certificateName);
+      }
 
       directoriesToAdd.push_back(directory);
       refreshPeriodsToAdd.push_back(info.refreshPeriod_);
@@ -919,6 +1325,30 @@ ConfigPolicyManager::TrustAnchorRefreshManager::refreshAnchors()
   // Now that we are done with the iterator, add to refreshDirectories_.
   for (size_t i = 0; i < directoriesToAdd.size(); ++i)
     addDirectory(directoriesToAdd[i], refreshPeriodsToAdd[i]);
+
+  // Compare the reloaded certificates with the old ones.
+  size_t nNewCertificates = 0;
+  for (size_t i = 0; i < directoriesToAdd.size(); ++i) {
+    const vector<string>& certificateList =
+      refreshDirectories_[directoriesToAdd[i]]->certificateNames_;
+    for (size_t j = 0; j < certificateList.size(); ++j) {
+      map<string, Blob>::iterator oldCertificate =
+        oldCertificates.find(certificateList[j]);
+      if (oldCertificate == oldCertificates.end())
+        // A new certificate.
+        return true;
+
+      ptr_lib::shared_ptr<const IdentityCertificate> certificate =
+        certificateCache_.getCertificate(Name(certificateList[j]));
+      if (!certificate ||
+          !certificate->wireEncode().equals(oldCertificate->second))
+        return true;
+      ++nNewCertificates;
+    }
+  }
+
+  // Return true if a certificate was removed.
+  return nNewCertificates != oldCertificates.size();
 }
 
 }
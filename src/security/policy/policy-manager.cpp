@@ -19,6 +19,8 @@
  * A copy of the GNU Lesser General Public License is in the file COPYING.
  */
 
+#include <list>
+#include <map>
 #include "../../c/util/crypto.h"
 #include "../../c/util/ndn_memory.h"
 #include <ndn-cpp/security/security-exception.hpp>
@@ -29,18 +31,126 @@
 #include <ndn-cpp/lite/security/ec-public-key-lite.hpp>
 #include <ndn-cpp/lite/security/rsa-public-key-lite.hpp>
 #include <ndn-cpp/security/policy/policy-manager.hpp>
+#if NDN_CPP_HAVE_STD_THREAD
+#include <mutex>
+#endif
 
 using namespace std;
 
 namespace ndn {
 
+#if NDN_CPP_HAVE_LIBCRYPTO
+
+/**
+ * A PublicKeyCache holds decoded public keys of type Key (RsaPublicKeyLite or
+ * EcPublicKeyLite) keyed by their DER encoding, so that verifySignature decodes
+ * each key once instead of on every verification. When the cache is full, it
+ * removes the least recently used key. The methods are thread-safe, but
+ * verifying with a shared key from several threads needs the application's
+ * OpenSSL locking callbacks with OpenSSL before 1.1.0.
+ */
+template<class Key> class PublicKeyCache {
+public:
+  PublicKeyCache(size_t maxSize)
+  : maxSize_(maxSize)
+  {
+  }
+
+  /**
+   * Get the decoded key for publicKeyDer, decoding it and adding it to the
+   * cache if needed.
+   * @param publicKeyDer The DER-encoded public key.
+   * @param key Set this to the decoded key.
+   * @return 0 for success, else NDN_ERROR_Error_decoding_key if publicKeyDer
+   * can't be decoded.
+   */
+  ndn_Error
+  get(const Blob& publicKeyDer, ptr_lib::shared_ptr<Key>& key)
+  {
+    {
+#if NDN_CPP_HAVE_STD_THREAD
+      lock_guard<mutex> lock(mutex_);
+#endif
+      typename KeyMap::iterator found = keys_.find(publicKeyDer);
+      if (found != keys_.end()) {
+        // Move it to the front as the most recently used.
+        leastRecentlyUsed_.splice
+          (leastRecentlyUsed_.begin(), leastRecentlyUsed_,
+           found->second.second);
+        key = found->second.first;
+        return NDN_ERROR_success;
+      }
+    }
+
+    // Decode without holding the lock.
+    ptr_lib::shared_ptr<Key> decodedKey(new Key());
+    ndn_Error error;
+    if ((error = decodedKey->decode(publicKeyDer.buf(), publicKeyDer.size())))
+      return error;
+
+#if NDN_CPP_HAVE_STD_THREAD
+    lock_guard<mutex> lock(mutex_);
+#endif
+    if (keys_.find(publicKeyDer) == keys_.end()) {
+      // Another thread didn't already add it.
+      if (keys_.size() >= maxSize_) {
+        keys_.erase(leastRecentlyUsed_.back());
+        leastRecentlyUsed_.pop_back();
+      }
+      leastRecentlyUsed_.push_front(publicKeyDer);
+      keys_[publicKeyDer] = KeyEntry(decodedKey, leastRecentlyUsed_.begin());
+    }
+
+    key = decodedKey;
+    return NDN_ERROR_success;
+  }
+
+private:
+  /**
+   * Order the DER encodings by size and then by content, which is cheaper
+   * than the lexicographic order of Blob.
+   */
+  class DerLess {
+  public:
+    bool
+    operator()(const Blob& x, const Blob& y) const
+    {
+      if (x.size() != y.size())
+        return x.size() < y.size();
+      return ndn_memcmp(x.buf(), y.buf(), x.size()) < 0;
+    }
+  };
+
+  typedef std::pair<ptr_lib::shared_ptr<Key>, std::list<Blob>::iterator>
+    KeyEntry;
+  typedef std::map<Blob, KeyEntry, DerLess> KeyMap;
+
+  size_t maxSize_;
+  KeyMap keys_;
+  // The DER encodings in keys_, with the most recently used at the front.
+  std::list<Blob> leastRecentlyUsed_;
+#if NDN_CPP_HAVE_STD_THREAD
+  std::mutex mutex_;
+#endif
+};
+
+// The number of keys to keep, which is much more than the number of keys used
+// by the signers of a typical application.
+static const size_t MAX_PUBLIC_KEY_CACHE_SIZE = 100;
+
+static PublicKeyCache<RsaPublicKeyLite> rsaPublicKeyCache
+  (MAX_PUBLIC_KEY_CACHE_SIZE);
+static PublicKeyCache<EcPublicKeyLite> ecPublicKeyCache
+  (MAX_PUBLIC_KEY_CACHE_SIZE);
+
+#endif
+
 bool
 PolicyManager::verifySignature
   (const Signature* signature, const SignedBlob& signedBlob,
    const Blob& publicKeyDer)
 {
   ndn_Error error;
-  bool verified;
 
   if (dynamic_cast<const DigestSha256Signature *>(signature))
     return CryptoLite::verifyDigestSha256Signature
@@ -49,28 +159,28 @@ PolicyManager::verifySignature
   else if (dynamic_cast<const Sha256WithRsaSignature *>(signature)) {
     if (publicKeyDer.isNull())
       return false;
-    if ((error = RsaPublicKeyLite::verifySha256WithRsaSignature
-         (signature->getSignature(), signedBlob.getSignedPortionBlobLite(),
-          publicKeyDer, verified)) != 0) {
+    ptr_lib::shared_ptr<RsaPublicKeyLite> publicKey;
+    if ((error = rsaPublicKeyCache.get(publicKeyDer, publicKey)) != 0) {
       if (error == NDN_ERROR_Error_decoding_key)
         throw UnrecognizedKeyFormatException("Error decoding public key");
       else
         throw SecurityException(ndn_getErrorString(error));
     }
-    return verified;
+    return publicKey->verifyWithSha256
+      (signature->getSignature(), signedBlob.getSignedPortionBlobLite());
   }
   else if (dynamic_cast<const Sha256WithEcdsaSignature *>(signature)) {
     if (publicKeyDer.isNull())
       return false;
-    if ((error = EcPublicKeyLite::verifySha256WithEcdsaSignature
-         (signature->getSignature(), signedBlob.getSignedPortionBlobLite(),
-          publicKeyDer, verified)) != 0) {
+    ptr_lib::shared_ptr<EcPublicKeyLite> publicKey;
+    if ((error = ecPublicKeyCache.get(publicKeyDer, publicKey)) != 0) {
       if (error == NDN_ERROR_Error_decoding_key)
         throw UnrecognizedKeyFormatException("Error decoding public key");
       else
         throw SecurityException(ndn_getErrorString(error));
     }
-    return verified;
+    return publicKey->verifyWithSha256
+      (signature->getSignature(), signedBlob.getSignedPortionBlobLite());
   }
   else
 #endif
@@ -0,0 +1,138 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2017 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+
+#include <ndn-cpp/security/policy/policy-manager.hpp>
+#include <ndn-cpp/security/policy/verifier-pool.hpp>
+
+using namespace std;
+using namespace ndn::func_lib;
+
+namespace ndn {
+
+#if NDN_CPP_HAVE_STD_THREAD
+
+VerifierPool::VerifierPool(Face& face, int nThreads)
+: face_(face), isStopping_(false)
+{
+  if (nThreads <= 0)
+    nThreads = thread::hardware_concurrency();
+  if (nThreads <= 0)
+    // hardware_concurrency can return 0 if it is unknown.
+    nThreads = 1;
+
+  for (int i = 0; i < nThreads; ++i)
+    threads_.push_back(thread(&VerifierPool::worker, this));
+}
+
+VerifierPool::~VerifierPool()
+{
+  {
+    lock_guard<mutex> lock(jobsMutex_);
+    isStopping_ = true;
+  }
+  jobsCondition_.notify_all();
+
+  for (size_t i = 0; i < threads_.size(); ++i)
+    threads_[i].join();
+}
+
+void
+VerifierPool::verifySignature
+  (const ptr_lib::shared_ptr<const Signature>& signature,
+   const SignedBlob& signedBlob, const Blob& publicKeyDer,
+   const OnVerifyResult& onResult)
+{
+  {
+    lock_guard<mutex> lock(jobsMutex_);
+    jobs_.push_back(Job(signature, signedBlob, publicKeyDer, onResult));
+  }
+  jobsCondition_.notify_one();
+}
+
+size_t
+VerifierPool::getThreadCount() const { return threads_.size(); }
+
+void
+VerifierPool::worker()
+{
+  while (true) {
+    unique_lock<mutex> lock(jobsMutex_);
+    while (jobs_.size() == 0 && !isStopping_)
+      jobsCondition_.wait(lock);
+    if (jobs_.size() == 0)
+      // isStopping_ and all the jobs are done.
+      return;
+
+    Job job(jobs_.front());
+    jobs_.pop_front();
+    lock.unlock();
+
+    processJob(job);
+  }
+}
+
+#else // NDN_CPP_HAVE_STD_THREAD
+
+// Without std::thread, verifySignature processes the job on the calling
+// thread.
+
+VerifierPool::VerifierPool(Face& face, int nThreads)
+: face_(face)
+{
+}
+
+VerifierPool::~VerifierPool() {}
+
+void
+VerifierPool::verifySignature
+  (const ptr_lib::shared_ptr<const Signature>& signature,
+   const SignedBlob& signedBlob, const Blob& publicKeyDer,
+   const OnVerifyResult& onResult)
+{
+  processJob(Job(signature, signedBlob, publicKeyDer, onResult));
+}
+
+size_t
+VerifierPool::getThreadCount() const { return 0; }
+
+#endif // NDN_CPP_HAVE_STD_THREAD
+
+void
+VerifierPool::processJob(const Job& job)
+{
+  bool isVerified = false;
+  string errorMessage;
+  try {
+    isVerified = PolicyManager::verifySignature
+      (job.signature_.get(), job.signedBlob_, job.publicKeyDer_);
+  } catch (const std::exception& ex) {
+    errorMessage = ex.what();
+    if (errorMessage == "")
+      errorMessage = "Error verifying the signature";
+  } catch (...) {
+    errorMessage = "Error verifying the signature";
+  }
+
+  face_.post(bind(job.onResult_, isVerified, errorMessage));
+}
+
+}
@@ -196,6 +196,12 @@ ThreadsafeFace::send(const uint8_t *encoding, size_t encodingLength)
     (boost::bind(&Node::send, node_, encoding, encodingLength));
 }
 
+void
+ThreadsafeFace::flush()
+{
+  ioService_.dispatch(boost::bind(&Node::flush, node_));
+}
+
 void
 ThreadsafeFace::shutdown()
 {
@@ -208,19 +214,52 @@ ThreadsafeFace::shutdown()
  * @param callback The original caller's callback.
  * @param timer This is not used, but passed in the function object to keep
  * the timer object alive until this is called.
+ * @param call This is not used, but passed in the function object to keep the
+ * CancellableCall from callLaterCancellable alive until this is called. This
+ * is null for callLater.
  */
 static void
 waitHandler
   (const boost::system::error_code& errorCode, const Face::Callback& callback,
-   ptr_lib::shared_ptr<boost::asio::deadline_timer> timer)
+   ptr_lib::shared_ptr<boost::asio::deadline_timer> timer,
+   ptr_lib::shared_ptr<Face::CancellableCall> call)
 {
   if (errorCode != boost::system::errc::success)
-    // Don't expect this to happen.
+    // The call was cancelled.
     return;
 
   callback();
 }
 
+/**
+ * A DeadlineTimerCall is the Face::CancellableCall for a deadline_timer from
+ * ThreadsafeFace::callLaterCancellable. It keeps a weak_ptr so that the timer
+ * is not kept alive after it is called.
+ */
+class DeadlineTimerCall : public Face::CancellableCall {
+public:
+  DeadlineTimerCall
+    (const ptr_lib::shared_ptr<boost::asio::deadline_timer>& timer)
+  : timer_(timer)
+  {
+  }
+
+  virtual void
+  cancel()
+  {
+    ptr_lib::shared_ptr<boost::asio::deadline_timer> timer = timer_.lock();
+    if (timer) {
+      // This calls waitHandler with operation_aborted, which releases the
+      // callback and the timer.
+      boost::system::error_code errorCode;
+      timer->cancel(errorCode);
+    }
+  }
+
+private:
+  ptr_lib::weak_ptr<boost::asio::deadline_timer> timer_;
+};
+
 void
 ThreadsafeFace::callLater
   (Milliseconds delayMilliseconds, const Callback& callback)
@@ -230,7 +269,29 @@ ThreadsafeFace::callLater
      (ioService_, boost::posix_time::milliseconds(delayMilliseconds)));
 
   // Pass the timer to waitHandler to keep it alive.
-  timer->async_wait(boost::bind(&waitHandler, _1, callback, timer));
+  timer->async_wait(boost::bind
+    (&waitHandler, _1, callback, timer,
+     ptr_lib::shared_ptr<Face::CancellableCall>()));
+}
+
+ptr_lib::shared_ptr<Face::CancellableCall>
+ThreadsafeFace::callLaterCancellable
+  (Milliseconds delayMilliseconds, const Callback& callback)
+{
+  ptr_lib::shared_ptr<boost::asio::deadline_timer> timer
+    (new boost::asio::deadline_timer
+     (ioService_, boost::posix_time::milliseconds(delayMilliseconds)));
+
+  ptr_lib::shared_ptr<CancellableCall> call(new DeadlineTimerCall(timer));
+  // Pass the timer and the call to waitHandler to keep them alive.
+  timer->async_wait(boost::bind(&waitHandler, _1, callback, timer, call));
+  return call;
+}
+
+void
+ThreadsafeFace::post(const Callback& callback)
+{
+  ioService_.post(callback);
 }
 
 }
@@ -22,6 +22,9 @@
 #ifndef NDN_ASYNC_SOCKET_TRANSPORT_HPP
 #define NDN_ASYNC_SOCKET_TRANSPORT_HPP
 
+#include <deque>
+#include <string>
+#include <vector>
 #include <stdexcept>
 #include <boost/bind.hpp>
 #include <boost/asio.hpp>
@@ -50,7 +53,11 @@ public:
    */
   AsyncSocketTransport(boost::asio::io_service& ioService)
   : ioService_(ioService), socket_(new typename AsioProtocol::socket(ioService)),
-    elementBuffer_(new DynamicUInt8Vector(1000)), isConnected_(false)
+    elementBuffer_(new DynamicUInt8Vector(1000)), isConnected_(false),
+    sendQueueOffset_(0), nSendQueueBytes_(0), isWaitingToWrite_(false),
+    maxSendQueueLength_(1000),
+    sendQueueFullPolicy_(Transport::SEND_QUEUE_FULL_BLOCK),
+    nDroppedPackets_(0)
   {
     ndn_ElementReader_initialize(&elementReader_, 0, elementBuffer_.get());
   }
@@ -72,6 +79,7 @@ public:
      ElementListener& elementListener, const Transport::OnConnected& onConnected)
   {
     close();
+    writeError_ = "";
 
     ndn_ElementReader_reset(&elementReader_, &elementListener);
 
@@ -81,28 +89,84 @@ public:
   }
 
   /**
-   * Set data to the host. To be thread-safe, this must be called from a
-   * dispatch to the ioService which was given to the constructor, as is done by
-   * ThreadsafeFace.
+   * Copy the data to the send queue and write as much of the queue as the
+   * socket accepts without blocking. The ioService writes the rest when the
+   * socket is ready. If the queue is full, do what setSendQueueLimit says. To
+   * be thread-safe, this must be called from a dispatch to the ioService which
+   * was given to the constructor, as is done by ThreadsafeFace.
    * @param data A pointer to the buffer of data to send.
    * @param dataLength The number of bytes in data.
+   * @throws runtime_error if the socket is not connected or if writing fails.
+   * If writing the queue later on the ioService failed and closed the socket,
+   * this throws with the error from that write.
    */
   void
   send(const uint8_t *data, size_t dataLength)
   {
-    if (!isConnected_)
+    if (!isConnected_) {
+      if (writeError_ != "")
+        throw std::runtime_error("AsyncSocketTransport.send: " + writeError_);
       throw std::runtime_error
         ("AsyncSocketTransport.send: The socket is not connected");
+    }
 
-    // Assume that this is called from a dispatch so that we are already in the
-    // ioService_ thread. Just do a blocking write.
-    boost::system::error_code errorCode;
-    boost::asio::write
-      (*socket_, boost::asio::buffer(data, dataLength), errorCode);
-    if (errorCode != boost::system::errc::success)
-      throw std::runtime_error("AsyncSocketTransport.send: Error in write");
+    if (maxSendQueueLength_ > 0 && sendQueue_.size() >= maxSendQueueLength_) {
+      if (sendQueueFullPolicy_ == Transport::SEND_QUEUE_FULL_BLOCK)
+        writeSendQueueBlocking();
+      else {
+        ++nDroppedPackets_;
+        if (sendQueueFullPolicy_ == Transport::SEND_QUEUE_FULL_NOTIFY &&
+            onSendQueueFull_)
+          onSendQueueFull_(Blob(data, dataLength));
+        return;
+      }
+    }
+
+    sendQueue_.push_back(Blob(data, dataLength));
+    nSendQueueBytes_ += dataLength;
+    // If we are waiting for the socket to be ready, writeHandler will write.
+    if (!isWaitingToWrite_ && !writeSendQueue())
+      throw std::runtime_error("AsyncSocketTransport.send: " + writeError_);
   }
 
+  /**
+   * Set the limit of the send queue and what send does when the queue is full.
+   * @param maxSendQueueLength The maximum number of packets in the send queue,
+   * or 0 for no limit.
+   * @param sendQueueFullPolicy What send does when the queue is full.
+   * @param onSendQueueFull If sendQueueFullPolicy is SEND_QUEUE_FULL_NOTIFY,
+   * send calls onSendQueueFull(packet) with each packet that it drops.
+   */
+  void
+  setSendQueueLimit
+    (size_t maxSendQueueLength,
+     Transport::SendQueueFullPolicy sendQueueFullPolicy,
+     const Transport::OnSendQueueFull& onSendQueueFull)
+  {
+    maxSendQueueLength_ = maxSendQueueLength;
+    sendQueueFullPolicy_ = sendQueueFullPolicy;
+    onSendQueueFull_ = onSendQueueFull;
+  }
+
+  /**
+   * Get the number of packets which are waiting in the send queue.
+   */
+  size_t
+  getSendQueueLength() const { return sendQueue_.size(); }
+
+  /**
+   * Get the number of bytes which are waiting in the send queue.
+   */
+  size_t
+  getSendQueueBytes() const { return nSendQueueBytes_ - sendQueueOffset_; }
+
+  /**
+   * Get the number of packets which send has dropped because the send queue
+   * was full.
+   */
+  uint64_t
+  getNDroppedPackets() const { return nDroppedPackets_; }
+
   bool
   getIsConnected()
   {
@@ -123,6 +187,11 @@ public:
     }
 
     isConnected_ = false;
+    sendQueue_.clear();
+    sendQueueOffset_ = 0;
+    nSendQueueBytes_ = 0;
+    // Closing the socket cancels the wait in writeHandler.
+    isWaitingToWrite_ = false;
   }
 
 private:
@@ -139,6 +208,8 @@ private:
       throw std::runtime_error("AsyncSocketTransport: Error in async_connect");
 
     isConnected_ = true;
+    // Don't let write_some block the ioService thread. See writeSendQueue.
+    socket_->non_blocking(true);
     onConnected();
 
     socket_->async_receive
@@ -175,12 +246,139 @@ private:
          boost::bind(&AsyncSocketTransport::readHandler, this, _1, _2));
   }
 
+  /**
+   * Write as much of the send queue as the socket accepts without blocking.
+   * If the socket is not ready for the rest, ask the ioService to call
+   * writeHandler when it is ready.
+   * @return True for success, or false if the write failed, in which case this
+   * closes the socket and sets writeError_.
+   */
+  bool
+  writeSendQueue()
+  {
+    std::vector<boost::asio::const_buffer> buffers;
+    while (sendQueue_.size() > 0) {
+      // Gather the queued packets so that one call writes them all.
+      buffers.clear();
+      for (size_t i = 0; i < sendQueue_.size() && i < MAX_WRITE_BUFFERS; ++i) {
+        size_t offset = (i == 0 ? sendQueueOffset_ : 0);
+        buffers.push_back(boost::asio::buffer
+          (sendQueue_[i].buf() + offset, sendQueue_[i].size() - offset));
+      }
+
+      boost::system::error_code errorCode;
+      size_t nBytesWritten = socket_->write_some(buffers, errorCode);
+      if (errorCode == boost::asio::error::would_block ||
+          errorCode == boost::asio::error::try_again) {
+        // Wait until the socket is ready. (The null_buffers write does not
+        // write any data.)
+        isWaitingToWrite_ = true;
+        socket_->async_write_some
+          (boost::asio::null_buffers(),
+           boost::bind(&AsyncSocketTransport::writeHandler, this, _1));
+        return true;
+      }
+      if (errorCode != boost::system::errc::success) {
+        close();
+        writeError_ = "Error in write: " + errorCode.message();
+        return false;
+      }
+
+      removeWrittenBytes(nBytesWritten);
+    }
+
+    return true;
+  }
+
+  /**
+   * This is called by async_write_some when the socket is ready to write.
+   */
+  void
+  writeHandler(const boost::system::error_code& errorCode)
+  {
+    if (errorCode == boost::asio::error::operation_aborted)
+      // The socket was closed. close() already reset isWaitingToWrite_.
+      return;
+
+    isWaitingToWrite_ = false;
+    // Throwing here would escape from the ioService, so save the error and the
+    // next call to send throws it.
+    if (errorCode != boost::system::errc::success) {
+      close();
+      writeError_ = "Error in async_write_some: " + errorCode.message();
+      return;
+    }
+
+    writeSendQueue();
+  }
+
+  /**
+   * Do a blocking write of the whole send queue. This is used by send for
+   * SEND_QUEUE_FULL_BLOCK.
+   */
+  void
+  writeSendQueueBlocking()
+  {
+    // The blocking write polls the socket until it is ready.
+    socket_->non_blocking(false);
+    boost::system::error_code errorCode;
+    while (sendQueue_.size() > 0 &&
+           errorCode == boost::system::errc::success) {
+      const Blob& packet = sendQueue_.front();
+      boost::asio::write
+        (*socket_, boost::asio::buffer
+         (packet.buf() + sendQueueOffset_, packet.size() - sendQueueOffset_),
+         errorCode);
+      if (errorCode == boost::system::errc::success)
+        removeWrittenBytes(packet.size() - sendQueueOffset_);
+    }
+    socket_->non_blocking(true);
+
+    if (errorCode != boost::system::errc::success) {
+      close();
+      throw std::runtime_error("AsyncSocketTransport.send: Error in write");
+    }
+  }
+
+  /**
+   * Remove the written bytes from the front of the send queue.
+   */
+  void
+  removeWrittenBytes(size_t nBytesWritten)
+  {
+    while (nBytesWritten > 0) {
+      size_t nBytesLeft = sendQueue_.front().size() - sendQueueOffset_;
+      if (nBytesWritten < nBytesLeft) {
+        sendQueueOffset_ += nBytesWritten;
+        return;
+      }
+
+      nBytesWritten -= nBytesLeft;
+      nSendQueueBytes_ -= sendQueue_.front().size();
+      sendQueue_.pop_front();
+      sendQueueOffset_ = 0;
+    }
+  }
+
+  // The most packets to give to one call to write_some.
+  static const size_t MAX_WRITE_BUFFERS = 64;
+
   boost::asio::io_service& ioService_;
   ptr_lib::shared_ptr<typename AsioProtocol::socket> socket_;
   uint8_t receiveBuffer_[MAX_NDN_PACKET_SIZE];
   ptr_lib::shared_ptr<DynamicUInt8Vector> elementBuffer_;
   ndn_ElementReader elementReader_;
   bool isConnected_;
+  std::deque<Blob> sendQueue_;
+  size_t sendQueueOffset_;   /**< The number of bytes of the front packet which are written. */
+  size_t nSendQueueBytes_;   /**< The total size of the packets in sendQueue_. */
+  bool isWaitingToWrite_;
+  size_t maxSendQueueLength_;
+  Transport::SendQueueFullPolicy sendQueueFullPolicy_;
+  Transport::OnSendQueueFull onSendQueueFull_;
+  uint64_t nDroppedPackets_;
+  // The error from writing the send queue on the ioService, or "" if none.
+  std::string writeError_;
 };
 
 }
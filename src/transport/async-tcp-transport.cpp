@@ -116,6 +116,33 @@ AsyncTcpTransport::send(const uint8_t *data, size_t dataLength)
   socketTransport_->send(data, dataLength);
 }
 
+void
+AsyncTcpTransport::setSendQueueLimit
+  (size_t maxSendQueueLength, SendQueueFullPolicy sendQueueFullPolicy,
+   const OnSendQueueFull& onSendQueueFull)
+{
+  socketTransport_->setSendQueueLimit
+    (maxSendQueueLength, sendQueueFullPolicy, onSendQueueFull);
+}
+
+size_t
+AsyncTcpTransport::getSendQueueLength() const
+{
+  return socketTransport_->getSendQueueLength();
+}
+
+size_t
+AsyncTcpTransport::getSendQueueBytes() const
+{
+  return socketTransport_->getSendQueueBytes();
+}
+
+uint64_t
+AsyncTcpTransport::getNDroppedPackets() const
+{
+  return socketTransport_->getNDroppedPackets();
+}
+
 bool
 AsyncTcpTransport::getIsConnected()
 {
@@ -76,6 +76,33 @@ AsyncUnixTransport::send(const uint8_t *data, size_t dataLength)
   socketTransport_->send(data, dataLength);
 }
 
+void
+AsyncUnixTransport::setSendQueueLimit
+  (size_t maxSendQueueLength, SendQueueFullPolicy sendQueueFullPolicy,
+   const OnSendQueueFull& onSendQueueFull)
+{
+  socketTransport_->setSendQueueLimit
+    (maxSendQueueLength, sendQueueFullPolicy, onSendQueueFull);
+}
+
+size_t
+AsyncUnixTransport::getSendQueueLength() const
+{
+  return socketTransport_->getSendQueueLength();
+}
+
+size_t
+AsyncUnixTransport::getSendQueueBytes() const
+{
+  return socketTransport_->getSendQueueBytes();
+}
+
+uint64_t
+AsyncUnixTransport::getNDroppedPackets() const
+{
+  return socketTransport_->getNDroppedPackets();
+}
+
 bool
 AsyncUnixTransport::getIsConnected()
 {
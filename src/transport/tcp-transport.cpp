@@ -23,6 +23,7 @@
 #include <ndn-cpp/ndn-cpp-config.h>
 #if NDN_CPP_HAVE_UNISTD_H
 
+#include <limits.h>
 #include <stdexcept>
 #include <stdlib.h>
 #include "../c/transport/tcp-transport.h"
@@ -35,13 +36,18 @@ using namespace std;
 
 namespace ndn {
 
+// Send the queue when it has this many packets, which is also the most that
+// ndn_SocketTransport_sendBatch gives to one system call.
+static const size_t MAX_SEND_QUEUE_PACKETS = 64;
+
 TcpTransport::ConnectionInfo::~ConnectionInfo()
 {
 }
 
 TcpTransport::TcpTransport()
   : isConnected_(false), transport_(new struct ndn_TcpTransport),
-    elementBuffer_(new DynamicUInt8Vector(1000)), connectionInfo_("", 0)
+    elementBuffer_(new DynamicUInt8Vector(1000)), isProcessingEvents_(false),
+    connectionInfo_("", 0)
 {
   ndn_TcpTransport_initialize(transport_.get(), elementBuffer_.get());
 }
@@ -93,21 +99,97 @@ TcpTransport::connect
 void
 TcpTransport::send(const uint8_t *data, size_t dataLength)
 {
+  if (isProcessingEvents_) {
+    // A callback is sending. Send with the other packets from the callbacks.
+    sendQueue_.push_back(Blob(data, dataLength));
+    if (sendQueue_.size() >= MAX_SEND_QUEUE_PACKETS)
+      flush();
+    return;
+  }
+
   ndn_Error error;
   if ((error = ndn_TcpTransport_send(transport_.get(), data, dataLength)))
     throw runtime_error(ndn_getErrorString(error));
 }
 
+void
+TcpTransport::sendBatch(const vector<Blob>& packets)
+{
+  if (sendQueue_.size() > 0) {
+    // Keep the order with the queued packets.
+    sendQueue_.insert(sendQueue_.end(), packets.begin(), packets.end());
+    flush();
+    return;
+  }
+  if (packets.size() == 0)
+    return;
+
+  vector<struct ndn_Blob> blobs(packets.size());
+  for (size_t i = 0; i < packets.size(); ++i) {
+    blobs[i].value = packets[i].buf();
+    blobs[i].length = packets[i].size();
+  }
+
+  ndn_Error error;
+  if ((error = ndn_TcpTransport_sendBatch
+       (transport_.get(), &blobs[0], blobs.size())))
+    throw runtime_error(ndn_getErrorString(error));
+}
+
+void
+TcpTransport::flush()
+{
+  if (sendQueue_.size() == 0)
+    return;
+
+  vector<Blob> packets;
+  packets.swap(sendQueue_);
+  sendBatch(packets);
+}
+
 void
 TcpTransport::processEvents()
 {
   uint8_t buffer[MAX_NDN_PACKET_SIZE];
   ndn_Error error;
-  if ((error = ndn_TcpTransport_processEvents
-       (transport_.get(), buffer, sizeof(buffer))))
+  // Queue the packets which the callbacks send and send them together below.
+  isProcessingEvents_ = true;
+  try {
+    error = ndn_TcpTransport_processEvents
+      (transport_.get(), buffer, sizeof(buffer));
+  } catch (...) {
+    isProcessingEvents_ = false;
+    flush();
+    throw;
+  }
+  isProcessingEvents_ = false;
+  flush();
+
+  if (error)
     throw runtime_error(ndn_getErrorString(error));
 }
 
+void
+TcpTransport::waitForReceive
+  (Milliseconds maxWaitMilliseconds, int wakeupDescriptor)
+{
+  // Don't overflow the int for a very long wait.
+  int timeoutMilliseconds = maxWaitMilliseconds >= INT_MAX ?
+    INT_MAX : (int)maxWaitMilliseconds;
+  int receiveIsReady;
+  ndn_Error error;
+  if ((error = ndn_TcpTransport_waitForReceive
+       (transport_.get(), timeoutMilliseconds, wakeupDescriptor,
+        &receiveIsReady)))
+    throw runtime_error(ndn_getErrorString(error));
+}
+
+int
+TcpTransport::getSocketDescriptor()
+{
+  return transport_->base.socketDescriptor;
+}
+
 bool
 TcpTransport::getIsConnected()
 {
@@ -117,6 +199,13 @@ TcpTransport::getIsConnected()
 void
 TcpTransport::close()
 {
+  try {
+    flush();
+  } catch (...) {
+    // Ignore errors sending to a connection which we are closing.
+  }
+  sendQueue_.clear();
+
   ndn_Error error;
   if ((error = ndn_TcpTransport_close(transport_.get())))
     throw runtime_error(ndn_getErrorString(error));
@@ -56,12 +56,36 @@ Transport::send(const uint8_t *data, size_t dataLength)
   throw logic_error("unimplemented");
 }
 
+void
+Transport::sendBatch(const vector<Blob>& packets)
+{
+  for (size_t i = 0; i < packets.size(); ++i)
+    send(packets[i].buf(), packets[i].size());
+}
+
+void
+Transport::flush()
+{
+}
+
 void
 Transport::processEvents()
 {
   throw logic_error("unimplemented");
 }
 
+void
+Transport::waitForReceive
+  (Milliseconds maxWaitMilliseconds, int wakeupDescriptor)
+{
+}
+
+int
+Transport::getSocketDescriptor()
+{
+  return -1;
+}
+
 bool
 Transport::getIsConnected()
 {
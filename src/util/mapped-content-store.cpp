@@ -0,0 +1,430 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2017 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+#include <stdexcept>
+#include <ndn-cpp/ndn-cpp-config.h>
+#if NDN_CPP_HAVE_UNISTD_H
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "../c/util/ndn_memory.h"
+#include <ndn-cpp/util/mapped-content-store.hpp>
+
+using namespace std;
+
+namespace ndn {
+
+static const char MAGIC[8] = { 'N', 'D', 'N', 'C', 'S', 'T', 'O', '1' };
+
+/**
+ * The Header is at the front of the file. The positions are only modified
+ * while holding the write lock.
+ */
+class MappedContentStore::Header {
+public:
+  char magic_[8];
+  uint64_t capacity_;
+  uint64_t firstPosition_; /**< The position of the oldest record. */
+  uint64_t endPosition_;   /**< The position for the next record. */
+  uint8_t reserved_[32];
+};
+
+/**
+ * A RecordHeader is at the front of each record in the log. A record whose
+ * encodingLength_ is 0 is padding to the end of the circular log.
+ */
+class MappedContentStore::RecordHeader {
+public:
+  uint32_t recordLength_;
+  uint32_t encodingLength_;
+  MillisecondsSince1970 addTime_;
+};
+
+/**
+ * A FileLock holds an fcntl lock on the whole file until it is destroyed.
+ */
+class MappedContentStore::FileLock {
+public:
+  /**
+   * Wait to lock the file.
+   * @param fd The file descriptor.
+   * @param type F_RDLCK or F_WRLCK.
+   */
+  FileLock(int fd, short type)
+  : fd_(fd)
+  {
+    setLock(type);
+  }
+
+  ~FileLock()
+  {
+    try {
+      setLock(F_UNLCK);
+    } catch (...) {
+      // Don't throw from the destructor.
+    }
+  }
+
+private:
+  void
+  setLock(short type)
+  {
+    struct flock lock;
+    ndn_memset((uint8_t*)&lock, 0, sizeof(lock));
+    lock.l_type = type;
+    lock.l_whence = SEEK_SET;
+    lock.l_start = 0;
+    lock.l_len = 0;
+    while (fcntl(fd_, F_SETLKW, &lock) < 0) {
+      if (errno != EINTR)
+        throw runtime_error("MappedContentStore: Error locking the file");
+    }
+  }
+
+  int fd_;
+};
+
+// Each record starts on this boundary, so there is always room for a
+// RecordHeader at the end of the circular log.
+static const size_t RECORD_ALIGNMENT = 16;
+
+MappedContentStore::MappedContentStore
+  (const string& filePath, size_t capacityBytes)
+: fd_(-1), map_(0), mapLength_(0), header_(0), log_(0)
+{
+  fd_ = open(filePath.c_str(), O_RDWR | O_CREAT, 0644);
+  if (fd_ < 0)
+    throw runtime_error("MappedContentStore: Cannot open " + filePath);
+
+  try {
+    // Hold the write lock in case another process is creating the file.
+    FileLock lock(fd_, F_WRLCK);
+
+    struct stat fileStat;
+    if (fstat(fd_, &fileStat) < 0)
+      throw runtime_error("MappedContentStore: Cannot stat " + filePath);
+
+    uint64_t capacity;
+    if (fileStat.st_size == 0) {
+      // Create a new store.
+      capacity = capacityBytes / RECORD_ALIGNMENT * RECORD_ALIGNMENT;
+      if (capacity < 2 * RECORD_ALIGNMENT)
+        throw runtime_error("MappedContentStore: The capacity is too small");
+      if (ftruncate(fd_, sizeof(Header) + capacity) < 0)
+        throw runtime_error("MappedContentStore: Cannot set the size of " + filePath);
+    }
+    else {
+      if ((size_t)fileStat.st_size < sizeof(Header))
+        throw runtime_error(filePath + " is not a MappedContentStore");
+      capacity = (uint64_t)fileStat.st_size - sizeof(Header);
+    }
+
+    mapLength_ = sizeof(Header) + capacity;
+    void* map = mmap
+      (0, mapLength_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (map == MAP_FAILED)
+      throw runtime_error("MappedContentStore: Cannot mmap " + filePath);
+    map_ = (uint8_t*)map;
+    header_ = (Header*)map_;
+    log_ = map_ + sizeof(Header);
+
+    if (fileStat.st_size == 0) {
+      ndn_memset(map_, 0, sizeof(Header));
+      header_->capacity_ = capacity;
+      header_->firstPosition_ = 0;
+      header_->endPosition_ = 0;
+      // Write the magic last so that a partially created file is not valid.
+      ndn_memcpy((uint8_t*)header_->magic_, (const uint8_t*)MAGIC, sizeof(MAGIC));
+    }
+    else {
+      if (ndn_memcmp
+          ((const uint8_t*)header_->magic_, (const uint8_t*)MAGIC,
+           sizeof(MAGIC)) != 0 ||
+          header_->capacity_ != capacity)
+        throw runtime_error(filePath + " is not a MappedContentStore");
+
+      // The file may have been left corrupted, for example by a crash before
+      // the mapped pages were written.
+      if (!isValidLog())
+        resetLog();
+    }
+  } catch (...) {
+    if (map_)
+      munmap(map_, mapLength_);
+    ::close(fd_);
+    throw;
+  }
+}
+
+MappedContentStore::~MappedContentStore()
+{
+  munmap(map_, mapLength_);
+  ::close(fd_);
+}
+
+uint64_t
+MappedContentStore::append
+  (const uint8_t* encoding, size_t encodingLength,
+   MillisecondsSince1970 addTime)
+{
+  uint64_t capacity = header_->capacity_;
+  size_t recordLength =
+    (sizeof(RecordHeader) + encodingLength + RECORD_ALIGNMENT - 1) /
+    RECORD_ALIGNMENT * RECORD_ALIGNMENT;
+  if (encodingLength == 0 || recordLength > capacity)
+    throw runtime_error
+      ("MappedContentStore::append: The encoding is empty or larger than the capacity");
+
+  FileLock lock(fd_, F_WRLCK);
+  if (!isValidHeader())
+    resetLog();
+
+  uint64_t offset = header_->endPosition_ % capacity;
+  if (offset + recordLength > capacity) {
+    // The record doesn't fit before the end of the circular log, so pad to
+    // the end and write it at the beginning.
+    uint32_t paddingLength = (uint32_t)(capacity - offset);
+    makeRoom(header_->endPosition_ + paddingLength);
+    RecordHeader* padding = getRecordHeader(header_->endPosition_);
+    padding->recordLength_ = paddingLength;
+    padding->encodingLength_ = 0;
+    padding->addTime_ = addTime;
+    header_->endPosition_ += paddingLength;
+  }
+
+  uint64_t position = header_->endPosition_;
+  makeRoom(position + recordLength);
+  RecordHeader* record = getRecordHeader(position);
+  record->recordLength_ = (uint32_t)recordLength;
+  record->encodingLength_ = (uint32_t)encodingLength;
+  record->addTime_ = addTime;
+  ndn_memcpy((uint8_t*)record + sizeof(RecordHeader), encoding, encodingLength);
+  // Update the end last so that a reader never sees a partial record.
+  header_->endPosition_ = position + recordLength;
+
+  return position;
+}
+
+bool
+MappedContentStore::read(uint64_t position, Blob& encoding)
+{
+  {
+    FileLock lock(fd_, F_RDLCK);
+
+    if (isValidHeader()) {
+      if (position < header_->firstPosition_ ||
+          position >= header_->endPosition_)
+        return false;
+
+      const RecordHeader* record = getRecordHeader(position);
+      if (isValidRecord(position, *record)) {
+        if (record->encodingLength_ == 0)
+          return false;
+        encoding = Blob
+          ((const uint8_t*)record + sizeof(RecordHeader),
+           record->encodingLength_);
+        return true;
+      }
+    }
+  }
+
+  // The log is corrupted, so the record is lost.
+  repairLog();
+  return false;
+}
+
+uint64_t
+MappedContentStore::readNewRecords
+  (uint64_t& position, vector<Record>& records, size_t maxBytes)
+{
+  {
+    FileLock lock(fd_, F_RDLCK);
+    if (readNewRecordsLocked(position, records, maxBytes))
+      return header_->firstPosition_;
+  }
+
+  // Reset the corrupted log and read again, which starts from the end.
+  repairLog();
+  FileLock lock(fd_, F_RDLCK);
+  readNewRecordsLocked(position, records, maxBytes);
+  return header_->firstPosition_;
+}
+
+bool
+MappedContentStore::readNewRecordsLocked
+  (uint64_t& position, vector<Record>& records, size_t maxBytes)
+{
+  if (!isValidHeader())
+    return false;
+  if (position < header_->firstPosition_ || position > header_->endPosition_)
+    position = header_->firstPosition_;
+
+  size_t nBytes = 0;
+  while (position < header_->endPosition_ &&
+         (maxBytes == 0 || nBytes < maxBytes)) {
+    const RecordHeader* record = getRecordHeader(position);
+    if (!isValidRecord(position, *record))
+      return false;
+
+    if (record->encodingLength_ > 0) {
+      records.push_back(Record
+        (position, record->addTime_,
+         Blob((const uint8_t*)record + sizeof(RecordHeader),
+              record->encodingLength_)));
+      nBytes += record->encodingLength_;
+    }
+
+    position += record->recordLength_;
+  }
+
+  return true;
+}
+
+size_t
+MappedContentStore::getCapacity() const { return (size_t)header_->capacity_; }
+
+MappedContentStore::RecordHeader*
+MappedContentStore::getRecordHeader(uint64_t position) const
+{
+  return (RecordHeader*)(log_ + position % header_->capacity_);
+}
+
+void
+MappedContentStore::makeRoom(uint64_t endPosition)
+{
+  while (endPosition - header_->firstPosition_ > header_->capacity_) {
+    const RecordHeader* record = getRecordHeader(header_->firstPosition_);
+    if (!isValidRecord(header_->firstPosition_, *record)) {
+      // Don't loop on a bad record length. The caller writes at endPosition_.
+      resetLog();
+      return;
+    }
+
+    header_->firstPosition_ += record->recordLength_;
+  }
+}
+
+bool
+MappedContentStore::isValidHeader() const
+{
+  return header_->firstPosition_ <= header_->endPosition_ &&
+         header_->endPosition_ - header_->firstPosition_ <= header_->capacity_ &&
+         header_->firstPosition_ % RECORD_ALIGNMENT == 0 &&
+         header_->endPosition_ % RECORD_ALIGNMENT == 0;
+}
+
+bool
+MappedContentStore::isValidRecord
+  (uint64_t position, const RecordHeader& record) const
+{
+  // A record never wraps around the end of the circular log.
+  return record.recordLength_ >= sizeof(RecordHeader) &&
+         record.recordLength_ % RECORD_ALIGNMENT == 0 &&
+         record.recordLength_ <=
+           header_->capacity_ - position % header_->capacity_ &&
+         position + record.recordLength_ <= header_->endPosition_ &&
+         record.encodingLength_ <= record.recordLength_ - sizeof(RecordHeader);
+}
+
+bool
+MappedContentStore::isValidLog() const
+{
+  if (!isValidHeader())
+    return false;
+
+  uint64_t position = header_->firstPosition_;
+  while (position < header_->endPosition_) {
+    const RecordHeader* record = getRecordHeader(position);
+    if (!isValidRecord(position, *record))
+      return false;
+    position += record->recordLength_;
+  }
+
+  return true;
+}
+
+void
+MappedContentStore::resetLog()
+{
+  // Remove all the records. Start after the largest position so that a
+  // position is never reused.
+  uint64_t position = header_->firstPosition_ > header_->endPosition_ ?
+    header_->firstPosition_ : header_->endPosition_;
+  position = (position + RECORD_ALIGNMENT - 1) / RECORD_ALIGNMENT *
+    RECORD_ALIGNMENT;
+  header_->firstPosition_ = position;
+  header_->endPosition_ = position;
+}
+
+void
+MappedContentStore::repairLog()
+{
+  FileLock lock(fd_, F_WRLCK);
+  // Another process may have already reset the log.
+  if (!isValidLog())
+    resetLog();
+}
+
+}
+
+#else // NDN_CPP_HAVE_UNISTD_H
+
+#include <ndn-cpp/util/mapped-content-store.hpp>
+
+using namespace std;
+
+namespace ndn {
+
+// Without Unix support for mmap, the constructor throws so that the other
+// methods are never called. Define them so that MemoryContentCache links.
+
+MappedContentStore::MappedContentStore
+  (const string& filePath, size_t capacityBytes)
+{
+  throw runtime_error
+    ("MappedContentStore is not supported on this platform");
+}
+
+MappedContentStore::~MappedContentStore() {}
+
+uint64_t
+MappedContentStore::append
+  (const uint8_t* encoding, size_t encodingLength,
+   MillisecondsSince1970 addTime) { return 0; }
+
+bool
+MappedContentStore::read(uint64_t position, Blob& encoding) { return false; }
+
+uint64_t
+MappedContentStore::readNewRecords
+  (uint64_t& position, vector<Record>& records, size_t maxBytes)
+{
+  return 0;
+}
+
+size_t
+MappedContentStore::getCapacity() const { return 0; }
+
+}
+
+#endif // NDN_CPP_HAVE_UNISTD_H
@@ -19,9 +19,10 @@
  * A copy of the GNU Lesser General Public License is in the file COPYING.
  */
 
-#include <algorithm>
 #include "../c/util/time.h"
+#include <ndn-cpp/lite/encoding/tlv-0_2-wire-format-lite.hpp>
 #include <ndn-cpp/util/logging.hpp>
+#include "../impl/name-prefix-tree.hpp"
 #include <ndn-cpp/util/memory-content-cache.hpp>
 
 using namespace std;
@@ -31,12 +32,90 @@ INIT_LOGGER("ndn.MemoryContentCache");
 
 namespace ndn {
 
+// The total size of the encodings which syncContentStore copies from the
+// store at a time.
+static const size_t MAX_STORE_READ_BYTES = 256 * 1024;
+
+/**
+ * The PendingInterestIndex holds the pending interests from
+ * storePendingInterest, indexed by the interest name so that a Data packet
+ * only needs to check the interests whose name is a prefix of the Data name.
+ * Interests with a lifetime are also in a heap ordered by timeout time.
+ */
+class MemoryContentCache::Impl::PendingInterestIndex {
+public:
+  void
+  add(const ptr_lib::shared_ptr<const PendingInterest>& pendingInterest)
+  {
+    const Interest& interest = *pendingInterest->getInterest();
+    interests_.add(interest.getName(), interest.getName().size(), pendingInterest);
+    if (interest.getInterestLifetimeMilliseconds() >= 0.0)
+      timeouts_.push(pendingInterest);
+  }
+
+  void
+  remove(const ptr_lib::shared_ptr<const PendingInterest>& pendingInterest)
+  {
+    // If the interest has a lifetime, leave it in timeouts_ and skip it when
+    // it is popped.
+    const Name& name = pendingInterest->getInterest()->getName();
+    interests_.remove(name, name.size(), pendingInterest);
+  }
+
+  /**
+   * Remove the timed-out interests, which are at the top of timeouts_.
+   * @param nowMilliseconds The current time in milliseconds from
+   * ndn_getNowMilliseconds.
+   */
+  void
+  removeTimedOut(MillisecondsSince1970 nowMilliseconds)
+  {
+    while (timeouts_.size() > 0 && timeouts_.top()->isTimedOut(nowMilliseconds)) {
+      remove(timeouts_.top());
+      timeouts_.pop();
+    }
+  }
+
+  /**
+   * Compare shared_ptrs to PendingInterest based on the timeout time. This is
+   * "greater than" so that a priority_queue puts the interest which times out
+   * first at the top.
+   */
+  class Compare {
+  public:
+    bool
+    operator()
+      (const ptr_lib::shared_ptr<const PendingInterest>& x,
+       const ptr_lib::shared_ptr<const PendingInterest>& y) const
+    {
+      return x->getTimeoutPeriodStart() +
+               x->getInterest()->getInterestLifetimeMilliseconds() >
+             y->getTimeoutPeriodStart() +
+               y->getInterest()->getInterestLifetimeMilliseconds();
+    }
+  };
+
+  // The key is the interest name.
+  NamePrefixTree<ptr_lib::shared_ptr<const PendingInterest> > interests_;
+  // The interests with a lifetime, which may still have removed interests.
+  priority_queue
+    <ptr_lib::shared_ptr<const PendingInterest>,
+     vector<ptr_lib::shared_ptr<const PendingInterest> >, Compare> timeouts_;
+};
+
 MemoryContentCache::Impl::Impl
-  (Face* face, Milliseconds cleanupIntervalMilliseconds)
+  (Face* face, Milliseconds cleanupIntervalMilliseconds,
+   const ptr_lib::shared_ptr<MappedContentStore>& contentStore)
 : face_(face), cleanupIntervalMilliseconds_(cleanupIntervalMilliseconds),
   nextCleanupTime_(ndn_getNowMilliseconds() + cleanupIntervalMilliseconds),
-  isDoingCleanup_(false)
+  pendingInterestIndex_(new PendingInterestIndex()), isDoingCleanup_(false),
+  evictionSequence_(0), evictionPolicy_(LRU),
+  maxEntries_(0), maxBytes_(0), nContentBytes_(0), nHits_(0), nMisses_(0),
+  nEvictions_(0), contentStore_(contentStore), storeReadPosition_(0)
 {
+  if (contentStore_)
+    // Start with the content which is already in the store.
+    syncContentStore();
 }
 
 void
@@ -54,7 +133,7 @@ MemoryContentCache::Impl::registerPrefix
    const OnInterestCallback& onDataNotFound,
    const ForwardingFlags& flags, WireFormat& wireFormat)
 {
-  onDataNotFoundForPrefix_[prefix.toUri()] = onDataNotFound;
+  onDataNotFoundForPrefix_[prefix] = onDataNotFound;
   uint64_t registeredPrefixId = face_->registerPrefix
     (prefix, 
      bind(&MemoryContentCache::Impl::onInterest, shared_from_this(), _1, _2, _3, _4, _5),
@@ -67,7 +146,7 @@ void
 MemoryContentCache::Impl::setInterestFilter
   (const InterestFilter& filter, const OnInterestCallback& onDataNotFound)
 {
-  onDataNotFoundForPrefix_[filter.getPrefix().toUri()] = onDataNotFound;
+  onDataNotFoundForPrefix_[filter.getPrefix()] = onDataNotFound;
   uint64_t interestFilterId = face_->setInterestFilter
     (filter,
      bind(&MemoryContentCache::Impl::onInterest, shared_from_this(), _1, _2, _3, _4, _5));
@@ -79,7 +158,7 @@ void
 MemoryContentCache::Impl::setInterestFilter
   (const Name& prefix, const OnInterestCallback& onDataNotFound)
 {
-  onDataNotFoundForPrefix_[prefix.toUri()] = onDataNotFound;
+  onDataNotFoundForPrefix_[prefix] = onDataNotFound;
   uint64_t interestFilterId = face_->setInterestFilter
     (prefix,
      bind(&MemoryContentCache::Impl::onInterest, shared_from_this(), _1, _2, _3, _4, _5));
@@ -107,41 +186,49 @@ MemoryContentCache::Impl::add(const Data& data)
 {
   doCleanup();
 
-  if (data.getMetaInfo().getFreshnessPeriod() >= 0.0) {
-    // The content will go stale, so use staleTimeCache_.
-    ptr_lib::shared_ptr<const StaleTimeContent> content(new StaleTimeContent(data));
-    // Insert into staleTimeCache_, sorted on content->staleTimeMilliseconds_.
-    staleTimeCache_.insert
-      (std::lower_bound(staleTimeCache_.begin(), staleTimeCache_.end(), content, contentCompare_),
-       content);
+  if (contentStore_) {
+    // syncContentStore adds the new content to the cache, along with any
+    // content which other processes appended to the store.
+    // wireEncode returns the cached encoding if available.
+    Blob encoding = data.wireEncode();
+    contentStore_->append
+      (encoding.buf(), encoding.size(), ndn_getNowMilliseconds());
+    syncContentStore();
   }
-  else
-    // The data does not go stale, so use noStaleTimeCache_.
-    noStaleTimeCache_.push_back
-      (ptr_lib::make_shared<const Content>(data));
-
-  // Remove timed-out interests and check if the data packet matches any pending
-  // interest.
-  // Go backwards through the list so we can erase entries.
-  MillisecondsSince1970 nowMilliseconds = ndn_getNowMilliseconds();
-  for (int i = (int)pendingInterestTable_.size() - 1; i >= 0; --i) {
-    if (pendingInterestTable_[i]->isTimedOut(nowMilliseconds)) {
-      pendingInterestTable_.erase(pendingInterestTable_.begin() + i);
-      continue;
+  else {
+    ptr_lib::shared_ptr<const Content> content;
+    if (data.getMetaInfo().getFreshnessPeriod() >= 0.0) {
+      // The content will go stale, so also add it to staleTimeHeap_.
+      ptr_lib::shared_ptr<const StaleTimeContent> staleTimeContent
+        (new StaleTimeContent(data));
+      staleTimeHeap_.push(staleTimeContent);
+      content = staleTimeContent;
     }
+    else
+      content = ptr_lib::make_shared<const Content>(data);
 
-    if (pendingInterestTable_[i]->getInterest()->matchesName(data.getName())) {
+    addContent(content, content->getDataEncoding().size(), 0);
+  }
+
+  // Remove timed-out interests and check if the data packet matches any pending
+  // interest. Only the interests whose name is a prefix of the data name can
+  // match.
+  pendingInterestIndex_->removeTimedOut(ndn_getNowMilliseconds());
+  vector<ptr_lib::shared_ptr<const PendingInterest> > candidates;
+  pendingInterestIndex_->interests_.getPrefixValues(data.getName(), candidates);
+  for (size_t i = 0; i < candidates.size(); ++i) {
+    if (candidates[i]->getInterest()->matchesName(data.getName())) {
       try {
         // Send to the same transport from the original call to onInterest.
         // wireEncode returns the cached encoding if available.
-        pendingInterestTable_[i]->getFace().send(*data.wireEncode());
+        candidates[i]->getFace().send(*data.wireEncode());
       } catch (std::exception& e) {
         _LOG_DEBUG("Error in send: " << e.what());
         return;
       }
 
       // The pending interest is satisfied, so remove it.
-      pendingInterestTable_.erase(pendingInterestTable_.begin() + i);
+      pendingInterestIndex_->remove(candidates[i]);
     }
   }
 }
@@ -150,7 +237,7 @@ void
 MemoryContentCache::Impl::storePendingInterest
   (const ptr_lib::shared_ptr<const Interest>& interest, Face& face)
 {
-  pendingInterestTable_.push_back(ptr_lib::shared_ptr<PendingInterest>
+  pendingInterestIndex_->add(ptr_lib::shared_ptr<PendingInterest>
     (new PendingInterest(interest, face)));
 }
 
@@ -161,17 +248,13 @@ MemoryContentCache::Impl::getPendingInterestsForName
 {
   pendingInterests.clear();
 
-  // Remove timed-out interests as we add results.
-  // Go backwards through the list so we can erase entries.
-  MillisecondsSince1970 nowMilliseconds = ndn_getNowMilliseconds();
-  for (int i = (int)pendingInterestTable_.size() - 1; i >= 0; --i) {
-    if (pendingInterestTable_[i]->isTimedOut(nowMilliseconds)) {
-      pendingInterestTable_.erase(pendingInterestTable_.begin() + i);
-      continue;
-    }
-
-    if (pendingInterestTable_[i]->getInterest()->matchesName(name))
-      pendingInterests.push_back(pendingInterestTable_[i]);
+  pendingInterestIndex_->removeTimedOut(ndn_getNowMilliseconds());
+  // Only the interests whose name is a prefix of the name can match.
+  vector<ptr_lib::shared_ptr<const PendingInterest> > candidates;
+  pendingInterestIndex_->interests_.getPrefixValues(name, candidates);
+  for (size_t i = 0; i < candidates.size(); ++i) {
+    if (candidates[i]->getInterest()->matchesName(name))
+      pendingInterests.push_back(candidates[i]);
   }
 }
 
@@ -182,18 +265,8 @@ MemoryContentCache::Impl::getPendingInterestsWithPrefix
 {
   pendingInterests.clear();
 
-  // Remove timed-out interests as we add results.
-  // Go backwards through the list so we can erase entries.
-  MillisecondsSince1970 nowMilliseconds = ndn_getNowMilliseconds();
-  for (int i = (int)pendingInterestTable_.size() - 1; i >= 0; --i) {
-    if (pendingInterestTable_[i]->isTimedOut(nowMilliseconds)) {
-      pendingInterestTable_.erase(pendingInterestTable_.begin() + i);
-      continue;
-    }
-
-    if (prefix.isPrefixOf(pendingInterestTable_[i]->getInterest()->getName()))
-      pendingInterests.push_back(pendingInterestTable_[i]);
-  }
+  pendingInterestIndex_->removeTimedOut(ndn_getNowMilliseconds());
+  pendingInterestIndex_->interests_.getValuesWithPrefix(prefix, pendingInterests);
 }
 
 void
@@ -205,64 +278,62 @@ MemoryContentCache::Impl::onInterest
 {
   doCleanup();
 
-  const Name::Component* selectedComponent = 0;
-  Blob selectedEncoding;
-  // We need to iterate over both arrays.
-  size_t totalSize = staleTimeCache_.size() + noStaleTimeCache_.size();
-  for (size_t i = 0; i < totalSize; ++i) {
-    const Content* content;
-    if (i < staleTimeCache_.size())
-      content = staleTimeCache_[i].get();
-    else
-      // We have iterated over the first array. Get from the second.
-      content = noStaleTimeCache_[i - staleTimeCache_.size()].get();
+  if (contentStore_)
+    syncContentStore();
 
-    if (interest->matchesName(content->getName())) {
-      if (interest->getChildSelector() < 0) {
-        // No child selector, so send the first match that we have found.
-        face.send(*content->getDataEncoding());
-        return;
-      }
-      else {
-        // Update selectedEncoding based on the child selector.
-        const Name::Component* component;
-        if (content->getName().size() > interest->getName().size())
-          component = &content->getName().get(interest->getName().size());
-        else
-          component = &emptyComponent_;
-
-        bool gotBetterMatch = false;
-        if (!selectedEncoding)
-          // Save the first match.
-          gotBetterMatch = true;
-        else {
-          if (interest->getChildSelector() == 0) {
-            // Leftmost child.
-            if (*component < *selectedComponent)
-              gotBetterMatch = true;
-          }
-          else {
-            // Rightmost child.
-            if (*component > *selectedComponent)
-              gotBetterMatch = true;
-          }
+  const Name& interestName = interest->getName();
+  ContentMap::iterator selected;
+  Blob selectedEncoding;
+  ptr_lib::shared_ptr<ContentList> contentList;
+  while (true) {
+    // All the names with the interest name as a prefix are in the range
+    // [interestName, interestName.getSuccessor()) in canonical order.
+    ContentMap::iterator begin = contentByName_.lower_bound(interestName);
+    ContentMap::iterator end = interestName.size() == 0 ? contentByName_.end()
+      : contentByName_.lower_bound(interestName.getSuccessor());
+
+    selected = contentByName_.end();
+    if (interest->getChildSelector() == 1) {
+      // Rightmost child. Search backward so that the first match has the
+      // greatest component after the interest name.
+      for (ContentMap::iterator i = end; i != begin; ) {
+        --i;
+        if (interest->matchesName(i->first)) {
+          selected = i;
+          break;
         }
-
-        if (gotBetterMatch) {
-          selectedComponent = component;
-          selectedEncoding = content->getDataEncoding();
+      }
+    }
+    else {
+      // No child selector or the leftmost child. Search forward so that the
+      // first match has the least component after the interest name.
+      for (ContentMap::iterator i = begin; i != end; ++i) {
+        if (interest->matchesName(i->first)) {
+          selected = i;
+          break;
         }
       }
     }
+
+    if (selected == contentByName_.end() ||
+        getDataEncoding(selected, selectedEncoding))
+      break;
+    // The content was overwritten in contentStore_, so search again.
+    removeOverwrittenEntry(selected, contentList);
   }
+  callOnContentRemoved(contentList);
 
-  if (selectedEncoding)
-    // We found the leftmost or rightmost child.
+  if (selected != contentByName_.end()) {
+    ++nHits_;
+    onContentUsed(selected);
     face.send(*selectedEncoding);
+  }
   else {
+    ++nMisses_;
+
     // Call the onDataNotFound callback (if defined).
-    map<string, OnInterestCallback>::iterator onDataNotFound =
-      onDataNotFoundForPrefix_.find(prefix->toUri());
+    NameMap<OnInterestCallback>::type::iterator onDataNotFound =
+      onDataNotFoundForPrefix_.find(*prefix);
     if (onDataNotFound != onDataNotFoundForPrefix_.end() &&
         onDataNotFound->second) {
       try {
@@ -289,36 +360,259 @@ MemoryContentCache::Impl::doCleanup()
   ptr_lib::shared_ptr<ContentList> contentList;
   MillisecondsSince1970 now = ndn_getNowMilliseconds();
   if (now >= nextCleanupTime_) {
-    // staleTimeCache_ is sorted on staleTimeMilliseconds_, so we only need to
-    // erase the stale entries at the front, then quit.
-    while (staleTimeCache_.size() > 0 && staleTimeCache_.front()->isStale(now)) {
+    // The top of staleTimeHeap_ goes stale first, so we only need to pop the
+    // stale entries at the top, then quit.
+    while (staleTimeHeap_.size() > 0 && staleTimeHeap_.top()->isStale(now)) {
+      ptr_lib::shared_ptr<const StaleTimeContent> content = staleTimeHeap_.top();
+      staleTimeHeap_.pop();
+
+      ContentMap::iterator found = contentByName_.find(content->getName());
+      if (found == contentByName_.end() || found->second.content_ != content)
+        // The content was already replaced or evicted.
+        continue;
+
       if (onContentRemoved_) {
         // Add to the list of removed content for the OnContentRemoved callback.
         // We make a separate list instead of calling the callback each time
-        // because the callback might call add again to modify the staleTimeCache_.
+        // because the callback might call add again to modify the cache.
         if (!contentList)
           contentList.reset(new ContentList());
 
-        contentList->push_back(staleTimeCache_.front());
+        contentList->push_back(content);
       }
 
-      staleTimeCache_.erase(staleTimeCache_.begin());
+      removeEntry(found);
     }
 
     nextCleanupTime_ = now + cleanupIntervalMilliseconds_;
   }
 
+  callOnContentRemoved(contentList);
+
+  isDoingCleanup_ = false;
+}
+
+void
+MemoryContentCache::Impl::setContentLimits(size_t maxEntries, size_t maxBytes)
+{
+  maxEntries_ = maxEntries;
+  maxBytes_ = maxBytes;
+
+  ptr_lib::shared_ptr<ContentList> contentList;
+  evictContent(contentByName_.end(), contentList);
+  callOnContentRemoved(contentList);
+}
+
+void
+MemoryContentCache::Impl::setEvictionPolicy(EvictionPolicy evictionPolicy)
+{
+  if (evictionPolicy == evictionPolicy_)
+    return;
+
+  evictionPolicy_ = evictionPolicy;
+  // Make new keys for the new policy, keeping the existing order among entries
+  // with the same key.
+  EvictionMap oldOrder;
+  oldOrder.swap(evictionOrder_);
+  for (EvictionMap::iterator i = oldOrder.begin(); i != oldOrder.end(); ++i)
+    addEvictionKey(i->second);
+}
+
+void
+MemoryContentCache::Impl::addEvictionKey(ContentMap::iterator entry)
+{
+  entry->second.evictionKey_ = EvictionKey
+    (evictionPolicy_ == LFU ? entry->second.useCount_ : 0, ++evictionSequence_);
+  evictionOrder_[entry->second.evictionKey_] = entry;
+}
+
+void
+MemoryContentCache::Impl::onContentUsed(ContentMap::iterator entry)
+{
+  ++entry->second.useCount_;
+
+  if (evictionPolicy_ == CLOCK)
+    // Don't change the order. evictContent checks the flag.
+    entry->second.isReferenced_ = true;
+  else {
+    // Move to the back of the LRU order, or of the entries with the same use
+    // count for LFU.
+    evictionOrder_.erase(entry->second.evictionKey_);
+    addEvictionKey(entry);
+  }
+}
+
+void
+MemoryContentCache::Impl::removeEntry(ContentMap::iterator entry)
+{
+  evictionOrder_.erase(entry->second.evictionKey_);
+  if (contentStore_)
+    entryByStorePosition_.erase(entry->second.storePosition_);
+  nContentBytes_ -= entry->second.nBytes_;
+  contentByName_.erase(entry);
+}
+
+void
+MemoryContentCache::Impl::addContent
+  (const ptr_lib::shared_ptr<const Content>& content, size_t nBytes,
+   uint64_t storePosition)
+{
+  // Replace any content with the same name.
+  ContentMap::iterator found = contentByName_.find(content->getName());
+  if (found != contentByName_.end())
+    removeEntry(found);
+  ContentMap::iterator entry = contentByName_.insert
+    (ContentMap::value_type
+     (content->getName(), Entry(content, nBytes, storePosition))).first;
+  nContentBytes_ += nBytes;
+  addEvictionKey(entry);
+  if (contentStore_)
+    entryByStorePosition_[storePosition] = entry;
+
+  if ((maxEntries_ > 0 && contentByName_.size() > maxEntries_) ||
+      (maxBytes_ > 0 && nContentBytes_ > maxBytes_)) {
+    ptr_lib::shared_ptr<ContentList> contentList;
+    evictContent(entry, contentList);
+    callOnContentRemoved(contentList);
+  }
+}
+
+void
+MemoryContentCache::Impl::syncContentStore()
+{
+  struct ndn_NameComponent nameComponents[100];
+  struct ndn_NameComponent keyNameComponents[100];
+  vector<MappedContentStore::Record> records;
+  size_t nBytes;
+  ptr_lib::shared_ptr<ContentList> contentList;
+
+  // Read in batches so that a large store is not copied into memory at once.
+  do {
+    records.clear();
+    uint64_t firstPosition = contentStore_->readNewRecords
+      (storeReadPosition_, records, MAX_STORE_READ_BYTES);
+
+    // Remove the entries whose content was overwritten in the store.
+    while (entryByStorePosition_.size() > 0 &&
+           entryByStorePosition_.begin()->first < firstPosition)
+      removeOverwrittenEntry
+        (entryByStorePosition_.begin()->second, contentList);
+
+    nBytes = 0;
+    for (size_t i = 0; i < records.size(); ++i) {
+      const MappedContentStore::Record& record = records[i];
+      nBytes += record.encoding.size();
+
+      // Only get the name and FreshnessPeriod, without copying the content.
+      DataLite dataLite
+        (nameComponents, sizeof(nameComponents) / sizeof(nameComponents[0]),
+         keyNameComponents,
+         sizeof(keyNameComponents) / sizeof(keyNameComponents[0]));
+      size_t signedPortionBeginOffset, signedPortionEndOffset;
+      ndn_Error error;
+      if ((error = Tlv0_2WireFormatLite::decodeData
+           (dataLite, record.encoding.buf(), record.encoding.size(),
+            &signedPortionBeginOffset, &signedPortionEndOffset))) {
+        _LOG_ERROR("MemoryContentCache: Error decoding content in the store: " <<
+                   ndn_getErrorString(error));
+        continue;
+      }
+
+      Name name;
+      name.set(dataLite.getName());
+      Milliseconds freshnessPeriod = dataLite.getMetaInfo().getFreshnessPeriod();
+
+      // Keep only the name in memory since the encoding is in the store.
+      ptr_lib::shared_ptr<const Content> content;
+      if (freshnessPeriod >= 0.0) {
+        ptr_lib::shared_ptr<const StaleTimeContent> staleTimeContent
+          (new StaleTimeContent(name, record.addTime + freshnessPeriod));
+        staleTimeHeap_.push(staleTimeContent);
+        content = staleTimeContent;
+      }
+      else
+        content.reset(new Content(name, Blob()));
+
+      addContent(content, record.encoding.size(), record.position);
+    }
+  } while (nBytes >= MAX_STORE_READ_BYTES);
+
+  callOnContentRemoved(contentList);
+}
+
+void
+MemoryContentCache::Impl::removeOverwrittenEntry
+  (ContentMap::iterator entry, ptr_lib::shared_ptr<ContentList>& contentList)
+{
+  if (onContentRemoved_) {
+    if (!contentList)
+      contentList.reset(new ContentList());
+
+    contentList->push_back(entry->second.content_);
+  }
+
+  removeEntry(entry);
+}
+
+bool
+MemoryContentCache::Impl::getDataEncoding
+  (ContentMap::iterator entry, Blob& encoding)
+{
+  if (contentStore_)
+    return contentStore_->read(entry->second.storePosition_, encoding);
+  else {
+    encoding = entry->second.content_->getDataEncoding();
+    return true;
+  }
+}
+
+void
+MemoryContentCache::Impl::evictContent
+  (ContentMap::iterator keep, ptr_lib::shared_ptr<ContentList>& contentList)
+{
+  while ((maxEntries_ > 0 && contentByName_.size() > maxEntries_) ||
+         (maxBytes_ > 0 && nContentBytes_ > maxBytes_)) {
+    EvictionMap::iterator victim = evictionOrder_.begin();
+    if (victim != evictionOrder_.end() && victim->second == keep)
+      ++victim;
+    if (victim == evictionOrder_.end())
+      // Only the entry to keep is left.
+      break;
+
+    ContentMap::iterator entry = victim->second;
+    if (evictionPolicy_ == CLOCK && entry->second.isReferenced_) {
+      // Give a second chance by clearing the flag and moving to the back.
+      entry->second.isReferenced_ = false;
+      evictionOrder_.erase(victim);
+      addEvictionKey(entry);
+      continue;
+    }
+
+    if (onContentRemoved_) {
+      if (!contentList)
+        contentList.reset(new ContentList());
+
+      contentList->push_back(entry->second.content_);
+    }
+
+    removeEntry(entry);
+    ++nEvictions_;
+  }
+}
+
+void
+MemoryContentCache::Impl::callOnContentRemoved
+  (const ptr_lib::shared_ptr<ContentList>& contentList)
+{
   if (onContentRemoved_ && contentList) {
     try {
       onContentRemoved_(contentList);
     } catch (const std::exception& ex) {
-      _LOG_ERROR("MemoryContentCache::doCleanup(): Error in onContentRemoved: " << ex.what());
+      _LOG_ERROR("MemoryContentCache: Error in onContentRemoved: " << ex.what());
     } catch (...) {
-      _LOG_ERROR("MemoryContentCache::doCleanup(): Error in onContentRemoved.");
+      _LOG_ERROR("MemoryContentCache: Error in onContentRemoved.");
     }
   }
-
-  isDoingCleanup_ = false;
 }
 
 MemoryContentCache::Impl::StaleTimeContent::StaleTimeContent(const Data& data)
@@ -0,0 +1,285 @@
+/**
+ * Copyright (C) 2017 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+#include "gtest/gtest.h"
+#include <ndn-cpp/ndn-cpp-config.h>
+// Only test if ndn-cpp-config.h defines NDN_CPP_HAVE_BOOST_ASIO.
+#ifdef NDN_CPP_HAVE_BOOST_ASIO
+
+#include <cstring>
+#include <cstdio>
+#include <stdexcept>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <boost/asio.hpp>
+#include <ndn-cpp/transport/async-unix-transport.hpp>
+#include "../../src/c/util/time.h"
+#include "../../src/encoding/element-listener.hpp"
+
+using namespace std;
+using namespace ndn;
+using namespace ndn::func_lib;
+
+// The size of each sent packet. This is large so that a few packets fill the
+// socket buffer.
+static const size_t PACKET_SIZE = 8000;
+
+class NullElementListener : public ElementListener {
+public:
+  virtual void
+  onReceivedElement(const uint8_t *element, size_t elementLength) {}
+};
+
+class CallbackCounter {
+public:
+  CallbackCounter()
+  : nConnected_(0)
+  {
+  }
+
+  void
+  onConnected() { ++nConnected_; }
+
+  void
+  onSendQueueFull(const Blob& packet) { droppedPackets_.push_back(packet); }
+
+  int nConnected_;
+  vector<Blob> droppedPackets_;
+};
+
+class TestAsyncSocketTransport : public ::testing::Test {
+public:
+  TestAsyncSocketTransport()
+  : transport_(ioService_), peerSocket_(-1), nextPacketValue_(0)
+  {
+    char filePath[100];
+    sprintf(filePath, "/tmp/test-async-socket-transport-%d.sock", (int)getpid());
+    filePath_ = filePath;
+    ::unlink(filePath_.c_str());
+
+    listenSocket_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, filePath_.c_str());
+    if (listenSocket_ < 0 ||
+        ::bind(listenSocket_, (struct sockaddr*)&address, sizeof(address)) < 0 ||
+        ::listen(listenSocket_, 5) < 0)
+      throw runtime_error("TestAsyncSocketTransport: Cannot listen");
+  }
+
+  virtual
+  ~TestAsyncSocketTransport()
+  {
+    transport_.close();
+    if (peerSocket_ >= 0)
+      ::close(peerSocket_);
+    ::close(listenSocket_);
+    ::unlink(filePath_.c_str());
+  }
+
+  /**
+   * Connect transport_ and accept the connection into peerSocket_.
+   * @return True for success.
+   */
+  bool
+  connect()
+  {
+    transport_.connect
+      (AsyncUnixTransport::ConnectionInfo(filePath_.c_str()), elementListener_,
+       bind(&CallbackCounter::onConnected, &counter_));
+    MillisecondsSince1970 endTime = ndn_getNowMilliseconds() + 2000;
+    while (counter_.nConnected_ == 0 && ndn_getNowMilliseconds() < endTime)
+      ioService_.poll();
+    if (counter_.nConnected_ == 0)
+      return false;
+
+    peerSocket_ = ::accept(listenSocket_, 0, 0);
+    return peerSocket_ >= 0;
+  }
+
+  /**
+   * Send the next packet and add it to expected_ unless it is dropped.
+   * @return True if the packet was dropped.
+   */
+  bool
+  sendPacket()
+  {
+    vector<uint8_t> packet(PACKET_SIZE, nextPacketValue_++);
+    uint64_t nDroppedPackets = transport_.getNDroppedPackets();
+    transport_.send(&packet[0], packet.size());
+    if (transport_.getNDroppedPackets() != nDroppedPackets)
+      return true;
+
+    expected_.insert(expected_.end(), packet.begin(), packet.end());
+    return false;
+  }
+
+  /**
+   * Send packets until the transport has queued nPackets.
+   * @return True if the queue has nPackets.
+   */
+  bool
+  fillSendQueue(size_t nPackets)
+  {
+    for (int i = 0; i < 1000 && transport_.getSendQueueLength() < nPackets; ++i)
+      sendPacket();
+    return transport_.getSendQueueLength() == nPackets;
+  }
+
+  /**
+   * Receive the bytes which are ready on peerSocket_ into received_.
+   */
+  void
+  receiveReady()
+  {
+    uint8_t buffer[10000];
+    while (true) {
+      ssize_t nBytes = recv(peerSocket_, buffer, sizeof(buffer), MSG_DONTWAIT);
+      if (nBytes <= 0)
+        return;
+      received_.insert(received_.end(), buffer, buffer + nBytes);
+    }
+  }
+
+  /**
+   * Receive on peerSocket_ and let the ioService write the send queue until
+   * all of expected_ is received.
+   */
+  void
+  receiveAll()
+  {
+    MillisecondsSince1970 endTime = ndn_getNowMilliseconds() + 5000;
+    while (received_.size() < expected_.size() &&
+           ndn_getNowMilliseconds() < endTime) {
+      receiveReady();
+      ioService_.poll();
+    }
+  }
+
+  boost::asio::io_service ioService_;
+  AsyncUnixTransport transport_;
+  NullElementListener elementListener_;
+  CallbackCounter counter_;
+  string filePath_;
+  int listenSocket_;
+  int peerSocket_;
+  uint8_t nextPacketValue_;
+  vector<uint8_t> expected_;
+  vector<uint8_t> received_;
+};
+
+TEST_F(TestAsyncSocketTransport, DropAndNotify)
+{
+  ASSERT_TRUE(connect());
+  transport_.setSendQueueLimit(5, Transport::SEND_QUEUE_FULL_DROP);
+
+  // The socket buffer fills, then the send queue, then send drops a packet.
+  int nSent = 0;
+  while (nSent < 1000 && !sendPacket())
+    ++nSent;
+  ASSERT_EQ((size_t)5, transport_.getSendQueueLength());
+  ASSERT_EQ((uint64_t)1, transport_.getNDroppedPackets());
+
+  // The queue holds the bytes not yet accepted by the socket, which may start
+  // in the middle of a packet after a partial write.
+  receiveReady();
+  ASSERT_EQ(expected_.size(), received_.size() + transport_.getSendQueueBytes());
+  ASSERT_TRUE(transport_.getSendQueueBytes() > 4 * PACKET_SIZE);
+  ASSERT_TRUE(transport_.getSendQueueBytes() <= 5 * PACKET_SIZE);
+
+  transport_.setSendQueueLimit
+    (5, Transport::SEND_QUEUE_FULL_NOTIFY,
+     bind(&CallbackCounter::onSendQueueFull, &counter_, _1));
+  uint8_t droppedValue = nextPacketValue_;
+  ASSERT_TRUE(sendPacket());
+  ASSERT_EQ((uint64_t)2, transport_.getNDroppedPackets());
+  ASSERT_EQ((size_t)1, counter_.droppedPackets_.size());
+  ASSERT_TRUE(counter_.droppedPackets_[0].equals
+              (Blob(vector<uint8_t>(PACKET_SIZE, droppedValue))));
+
+  // When the socket is ready, the ioService writes the rest of the queue.
+  receiveAll();
+  ASSERT_EQ((size_t)0, transport_.getSendQueueLength());
+  ASSERT_EQ((size_t)0, transport_.getSendQueueBytes());
+  ASSERT_TRUE(expected_ == received_) <<
+    "The queued packets were not written in order";
+}
+
+TEST_F(TestAsyncSocketTransport, Block)
+{
+  ASSERT_TRUE(connect());
+  transport_.setSendQueueLimit(5, Transport::SEND_QUEUE_FULL_BLOCK);
+  ASSERT_TRUE(fillSendQueue(5));
+
+  // Make room in the socket buffer, then send to the full queue. The blocking
+  // write writes the queue and the new packet waits for the ioService.
+  receiveReady();
+  ASSERT_FALSE(sendPacket());
+  ASSERT_EQ((uint64_t)0, transport_.getNDroppedPackets());
+  ASSERT_EQ((size_t)1, transport_.getSendQueueLength());
+  ASSERT_EQ(PACKET_SIZE, transport_.getSendQueueBytes());
+
+  receiveAll();
+  ASSERT_EQ((size_t)0, transport_.getSendQueueLength());
+  ASSERT_TRUE(expected_ == received_) <<
+    "The packets were not written in order";
+}
+
+TEST_F(TestAsyncSocketTransport, WriteError)
+{
+  ASSERT_TRUE(connect());
+  transport_.setSendQueueLimit(0, Transport::SEND_QUEUE_FULL_BLOCK);
+  ASSERT_TRUE(fillSendQueue(1));
+
+  // The peer stops receiving. When the socket is ready, the ioService write
+  // fails. This must not throw from the ioService.
+  ::shutdown(peerSocket_, SHUT_RD);
+  receiveReady();
+  MillisecondsSince1970 endTime = ndn_getNowMilliseconds() + 2000;
+  while (transport_.getIsConnected() && ndn_getNowMilliseconds() < endTime) {
+    ASSERT_NO_THROW(ioService_.poll());
+    receiveReady();
+  }
+  ASSERT_FALSE(transport_.getIsConnected()) <<
+    "The failed write did not close the transport";
+  ASSERT_EQ((size_t)0, transport_.getSendQueueLength());
+
+  // The next send reports the error.
+  vector<uint8_t> packet(10, 0);
+  try {
+    transport_.send(&packet[0], packet.size());
+    FAIL() << "send did not report the write error";
+  } catch (const runtime_error& ex) {
+    ASSERT_TRUE(string(ex.what()).find("Error in write") != string::npos) <<
+      "send did not report the write error: " << ex.what();
+  }
+}
+
+#endif // NDN_CPP_HAVE_BOOST_ASIO
+
+int
+main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
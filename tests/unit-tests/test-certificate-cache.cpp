@@ -0,0 +1,193 @@
+/**
+ * Copyright (C) 2017 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+#include "gtest/gtest.h"
+#include <ndn-cpp/security/identity/identity-manager.hpp>
+#include <ndn-cpp/security/identity/memory-identity-storage.hpp>
+#include <ndn-cpp/security/identity/memory-private-key-storage.hpp>
+#include <ndn-cpp/security/policy/certificate-cache.hpp>
+#include <ndn-cpp/security/policy/config-policy-manager.hpp>
+#include "../../src/encoding/base64.hpp"
+
+using namespace std;
+using namespace ndn;
+using namespace ndn::func_lib;
+
+/**
+ * Make an IdentityCertificate with only the name, which is enough for the
+ * cache.
+ * @param identity The identity, such as "/A".
+ */
+static IdentityCertificate
+makeCertificate(const string& identity)
+{
+  IdentityCertificate certificate;
+  certificate.setName(Name(identity).append("KEY").append("ksk-1").append
+    ("ID-CERT").appendVersion(1));
+  return certificate;
+}
+
+/**
+ * Get the certificate name without the version, as used by the cache.
+ */
+static Name
+getCacheName(const string& identity)
+{
+  return makeCertificate(identity).getName().getPrefix(-1);
+}
+
+class VerificationCounter {
+public:
+  VerificationCounter()
+  : successCount_(0), failureCount_(0)
+  {
+  }
+
+  void
+  onVerified(const ptr_lib::shared_ptr<Data>& data) { ++successCount_; }
+
+  void
+  onValidationFailed
+    (const ptr_lib::shared_ptr<Data>& data, const string& reason)
+  {
+    ++failureCount_;
+  }
+
+  int successCount_;
+  int failureCount_;
+};
+
+TEST(TestCertificateCache, LeastRecentlyUsed)
+{
+  CertificateCache cache(2);
+  ASSERT_EQ((size_t)2, cache.getCapacity());
+
+  cache.insertCertificate(makeCertificate("/A"));
+  cache.insertCertificate(makeCertificate("/B"));
+  ASSERT_EQ((size_t)2, cache.size());
+
+  // Using /A makes /B the least recently used.
+  ASSERT_TRUE((bool)cache.getCertificate(getCacheName("/A")));
+  cache.insertCertificate(makeCertificate("/C"));
+  ASSERT_EQ((size_t)2, cache.size());
+  ASSERT_TRUE((bool)cache.getCertificate(getCacheName("/A")));
+  ASSERT_FALSE((bool)cache.getCertificate(getCacheName("/B"))) <<
+    "The least recently used certificate was not removed";
+  ASSERT_TRUE((bool)cache.getCertificate(getCacheName("/C")));
+
+  // Inserting an existing certificate replaces it and doesn't remove another.
+  cache.insertCertificate(makeCertificate("/A"));
+  ASSERT_EQ((size_t)2, cache.size());
+  ASSERT_TRUE((bool)cache.getCertificate(getCacheName("/C")));
+
+  cache.deleteCertificate(getCacheName("/A"));
+  ASSERT_EQ((size_t)1, cache.size());
+  ASSERT_FALSE((bool)cache.getCertificate(getCacheName("/A")));
+  // Deleting a missing certificate does nothing.
+  cache.deleteCertificate(getCacheName("/A"));
+  ASSERT_EQ((size_t)1, cache.size());
+
+  cache.reset();
+  ASSERT_EQ((size_t)0, cache.size());
+  ASSERT_FALSE((bool)cache.getCertificate(getCacheName("/C")));
+}
+
+TEST(TestCertificateCache, NoLimit)
+{
+  CertificateCache cache(0);
+  for (int i = 0; i < 2000; ++i) {
+    ostringstream identity;
+    identity << "/Identity" << i;
+    cache.insertCertificate(makeCertificate(identity.str()));
+  }
+
+  ASSERT_EQ((size_t)2000, cache.size()) <<
+    "A cache with capacity 0 removed a certificate";
+  ASSERT_TRUE((bool)cache.getCertificate(getCacheName("/Identity0")));
+}
+
+TEST(TestCertificateCache, ReloadFixedSigner)
+{
+  ptr_lib::shared_ptr<IdentityManager> identityManager(new IdentityManager
+    (ptr_lib::make_shared<MemoryIdentityStorage>(),
+     ptr_lib::make_shared<MemoryPrivateKeyStorage>()));
+  Name certificateName = identityManager->createIdentityAndCertificate
+    (Name("/TestCertificateCache/Signer"), EcdsaKeyParams());
+  Blob encoding = identityManager->getCertificate(certificateName)->wireEncode();
+
+  string config =
+    "validator\n"
+    "{\n"
+    "  rule\n"
+    "  {\n"
+    "    id \"Fixed signer\"\n"
+    "    for data\n"
+    "    filter\n"
+    "    {\n"
+    "      type name\n"
+    "      name /TestData\n"
+    "      relation is-prefix-of\n"
+    "    }\n"
+    "    checker\n"
+    "    {\n"
+    "      type fixed-signer\n"
+    "      sig-type ecdsa-sha256\n"
+    "      signer\n"
+    "      {\n"
+    "        type base64\n"
+    "        base64-string \"" + toBase64(encoding.buf(), encoding.size()) + "\"\n"
+    "      }\n"
+    "    }\n"
+    "  }\n"
+    "}\n";
+  ptr_lib::shared_ptr<CertificateCache> cache(new CertificateCache(1));
+  ConfigPolicyManager policyManager("", cache);
+  policyManager.load(config, "test-certificate-cache");
+
+  ptr_lib::shared_ptr<Data> data(new Data(Name("/TestData/1")));
+  identityManager->signByCertificate(*data, certificateName);
+  VerificationCounter counter;
+  OnVerified onVerified = bind
+    (&VerificationCounter::onVerified, &counter, _1);
+  OnDataValidationFailed onValidationFailed = bind
+    (&VerificationCounter::onValidationFailed, &counter, _1, _2);
+
+  // Checking the rule loads the fixed signer into the cache.
+  policyManager.checkVerificationPolicy(data, 0, onVerified, onValidationFailed);
+  Name cacheName = certificateName.getPrefix(-1);
+  ASSERT_TRUE((bool)cache->getCertificate(cacheName));
+
+  // Another certificate removes the fixed signer from the full cache.
+  cache->insertCertificate(makeCertificate("/Other"));
+  ASSERT_FALSE((bool)cache->getCertificate(cacheName));
+
+  // Checking the rule again loads the fixed signer again.
+  policyManager.checkVerificationPolicy(data, 0, onVerified, onValidationFailed);
+  ASSERT_TRUE((bool)cache->getCertificate(cacheName)) <<
+    "lookupCertificate did not reload the removed fixed signer";
+  ASSERT_EQ(2, counter.successCount_ + counter.failureCount_);
+}
+
+int
+main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
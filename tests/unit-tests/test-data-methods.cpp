@@ -348,6 +348,13 @@ public:
     keyChain_.sign(data, certificateName);
   }
 
+  void
+  signDataBatch
+    (const vector<Data*>& dataList, const Name& certificateName, int nThreads)
+  {
+    keyChain_.signBatch(dataList, certificateName, nThreads);
+  }
+
   void
   signDataWithSha256(Data& data)
   {
@@ -362,6 +369,9 @@ public:
     keyChain_.verifyData(data, verifiedCallback, failedCallback);
   }
 
+  const Name&
+  getDefaultCertName() { return defaultCertName_; }
+
   const Name&
   getEcdsaCertName() { return ecdsaCertName_; }
 
@@ -490,6 +500,38 @@ TEST_F(TestDataMethods, VerifyEcdsa)
   ASSERT_EQ(counter.onVerifiedCallCount_, 1) << "Verification callback was not used.";
 }
 
+TEST_F(TestDataMethods, VerifyBatch)
+{
+  // Sign with RSA and ECDSA, and with one thread and multiple threads.
+  for (int iTest = 0; iTest < 4; ++iTest) {
+    Name certificateName = (iTest < 2 ? credentials.getDefaultCertName()
+                                      : credentials.getEcdsaCertName());
+    int nThreads = (iTest % 2 == 0 ? 1 : 4);
+
+    vector<ptr_lib::shared_ptr<Data> > dataPackets;
+    vector<Data*> dataList;
+    for (int i = 0; i < 20; ++i) {
+      dataPackets.push_back(createFreshData());
+      dataPackets.back()->getName().appendSegment(i);
+      dataList.push_back(dataPackets.back().get());
+    }
+
+    credentials.signDataBatch(dataList, certificateName, nThreads);
+
+    VerifyCounter counter;
+    for (size_t i = 0; i < dataPackets.size(); ++i) {
+      // Decode the encoding to check the signature bits in the encoding.
+      ptr_lib::shared_ptr<Data> decodedData(new Data());
+      decodedData->wireDecode(dataPackets[i]->wireEncode());
+      credentials.verifyData
+        (decodedData, bind(&VerifyCounter::onVerified, &counter, _1),
+         bind(&VerifyCounter::onValidationFailed, &counter, _1, _2));
+    }
+    ASSERT_EQ(counter.onValidationFailedCallCount_, 0) << "Signature verification failed";
+    ASSERT_EQ((size_t)counter.onVerifiedCallCount_, dataPackets.size()) << "Verification callback was not used.";
+  }
+}
+
 TEST_F(TestDataMethods, VerifyDigestSha256)
 {
   VerifyCounter counter;
@@ -575,6 +617,14 @@ TEST_F(TestDataMethods, FullName)
   Name saveFullName(*data.getFullName());
   data.setContent(Blob());
   ASSERT_FALSE(data.getFullName()->get(-1).equals(saveFullName.get(-1)));
+
+  // Decoding a different packet into the same object should change the full
+  // name.
+  data.wireDecode(codedData, sizeof(codedData));
+  saveFullName = *data.getFullName();
+  data.wireDecode(freshData->wireEncode());
+  ASSERT_FALSE(data.getFullName()->get(-1).equals(saveFullName.get(-1)));
+  ASSERT_EQ(freshData->getName(), data.getFullName()->getPrefix(-1));
 }
 
 int
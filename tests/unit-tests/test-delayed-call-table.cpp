@@ -0,0 +1,177 @@
+/**
+ * Copyright (C) 2017 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+#include "gtest/gtest.h"
+#include "../../src/c/util/time.h"
+#include "../../src/impl/delayed-call-table.hpp"
+
+using namespace std;
+using namespace ndn;
+using namespace ndn::func_lib;
+
+/**
+ * A CallRecorder records the values of the calls in the order they are
+ * called.
+ */
+class CallRecorder {
+public:
+  void
+  onCall(int value) { values_.push_back(value); }
+
+  void
+  onNewFirstCall(MillisecondsSince1970 callTime)
+  {
+    newFirstCallTimes_.push_back(callTime);
+  }
+
+  Face::Callback
+  makeCall(int value) { return bind(&CallRecorder::onCall, this, value); }
+
+  vector<int> values_;
+  vector<MillisecondsSince1970> newFirstCallTimes_;
+};
+
+static void
+doNothing(ptr_lib::shared_ptr<int> value) {}
+
+TEST(TestDelayedCallTable, CallOrder)
+{
+  DelayedCallTable table;
+  CallRecorder recorder;
+  ASSERT_EQ(-1, table.getNextCallTime());
+
+  // Negative delays are already timed out, in order of the call time.
+  table.callLater(-20, recorder.makeCall(2));
+  table.callLater(-30, recorder.makeCall(1));
+  table.callLater(10000, recorder.makeCall(5));
+  table.callLater(-10, recorder.makeCall(3));
+  ptr_lib::shared_ptr<DelayedCallTable::Entry> entry = table.callLater
+    (-5, recorder.makeCall(4));
+  ASSERT_EQ((size_t)5, table.size());
+  ASSERT_TRUE(table.getNextCallTime() <= ndn_getNowMilliseconds() - 30);
+
+  table.callTimedOut();
+  ASSERT_EQ((size_t)4, recorder.values_.size());
+  for (int i = 0; i < 4; ++i)
+    ASSERT_EQ(i + 1, recorder.values_[i]);
+  ASSERT_EQ((size_t)1, table.size());
+  ASSERT_TRUE(table.getNextCallTime() > ndn_getNowMilliseconds() + 5000) <<
+    "The call in the future should be the next call";
+
+  // Cancelling an entry which was already called does nothing.
+  table.cancel(entry);
+  ASSERT_EQ((size_t)1, table.size());
+  table.cancel(ptr_lib::shared_ptr<DelayedCallTable::Entry>());
+  ASSERT_EQ((size_t)1, table.size());
+}
+
+TEST(TestDelayedCallTable, Cancel)
+{
+  DelayedCallTable table;
+  CallRecorder recorder;
+
+  ptr_lib::shared_ptr<DelayedCallTable::Entry> entry1 = table.callLater
+    (-20, recorder.makeCall(1));
+  table.callLater(-10, recorder.makeCall(2));
+  ptr_lib::shared_ptr<int> value(new int(3));
+  ptr_lib::shared_ptr<DelayedCallTable::Entry> entry3 = table.callLater
+    (-5, bind(&doNothing, value));
+  ASSERT_EQ(2, value.use_count());
+
+  table.cancel(entry1);
+  table.cancel(entry3);
+  ASSERT_TRUE(entry1->getIsCancelled());
+  ASSERT_EQ((size_t)1, table.size());
+  ASSERT_EQ(1, value.use_count()) << "cancel did not release the callback";
+  // Cancelling again does nothing.
+  table.cancel(entry1);
+  ASSERT_EQ((size_t)1, table.size());
+
+  // The next call time skips the cancelled entry at the front.
+  ASSERT_EQ((size_t)0, recorder.values_.size());
+  MillisecondsSince1970 nextCallTime = table.getNextCallTime();
+  ASSERT_TRUE(nextCallTime > entry1->getCallTime());
+  ASSERT_TRUE(nextCallTime < entry3->getCallTime());
+
+  table.callTimedOut();
+  ASSERT_EQ((size_t)1, recorder.values_.size());
+  ASSERT_EQ(2, recorder.values_[0]);
+  ASSERT_EQ((size_t)0, table.size());
+  ASSERT_EQ(-1, table.getNextCallTime());
+}
+
+TEST(TestDelayedCallTable, RemoveCancelled)
+{
+  DelayedCallTable table;
+  CallRecorder recorder;
+
+  vector<ptr_lib::shared_ptr<DelayedCallTable::Entry> > entries;
+  for (int i = 0; i < 200; ++i)
+    entries.push_back(table.callLater(10000 + i, recorder.makeCall(i)));
+
+  // Cancelling most of the entries compacts the table. Keep every fourth.
+  for (int i = 0; i < 200; ++i) {
+    if (i % 4 != 3)
+      table.cancel(entries[i]);
+  }
+  ASSERT_EQ((size_t)50, table.size());
+  ASSERT_EQ(entries[3]->getCallTime(), table.getNextCallTime());
+
+  for (int i = 3; i < 200; i += 4)
+    table.cancel(entries[i]);
+  ASSERT_EQ((size_t)0, table.size());
+  ASSERT_EQ(-1, table.getNextCallTime());
+
+  // The table still works after being compacted.
+  table.callLater(-1, recorder.makeCall(1000));
+  table.callTimedOut();
+  ASSERT_EQ((size_t)1, recorder.values_.size());
+  ASSERT_EQ(1000, recorder.values_[0]);
+}
+
+TEST(TestDelayedCallTable, OnNewFirstCall)
+{
+  DelayedCallTable table;
+  CallRecorder recorder;
+  table.setOnNewFirstCall
+    (bind(&CallRecorder::onNewFirstCall, &recorder, _1));
+
+  ptr_lib::shared_ptr<DelayedCallTable::Entry> entry1 = table.callLater
+    (1000, recorder.makeCall(1));
+  table.callLater(2000, recorder.makeCall(2));
+  ptr_lib::shared_ptr<DelayedCallTable::Entry> entry3 = table.callLater
+    (500, recorder.makeCall(3));
+
+  ASSERT_EQ((size_t)2, recorder.newFirstCallTimes_.size()) <<
+    "Only a call which is now the next call should be reported";
+  ASSERT_EQ(entry1->getCallTime(), recorder.newFirstCallTimes_[0]);
+  ASSERT_EQ(entry3->getCallTime(), recorder.newFirstCallTimes_[1]);
+
+  table.setOnNewFirstCall(DelayedCallTable::OnNewFirstCall());
+  table.callLater(100, recorder.makeCall(4));
+  ASSERT_EQ((size_t)2, recorder.newFirstCallTimes_.size());
+}
+
+int
+main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
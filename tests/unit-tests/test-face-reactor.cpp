@@ -0,0 +1,310 @@
+/**
+ * Copyright (C) 2017 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+#include "gtest/gtest.h"
+#include <cstring>
+#include <stdexcept>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <ndn-cpp/digest-sha256-signature.hpp>
+#include <ndn-cpp/transport/udp-transport.hpp>
+#include <ndn-cpp/face-reactor.hpp>
+#include "../../src/c/util/time.h"
+
+using namespace std;
+using namespace ndn;
+using namespace ndn::func_lib;
+
+/**
+ * A Forwarder is a UDP socket on the loopback interface which answers each
+ * received Interest with a Data packet, in place of NFD.
+ */
+class Forwarder {
+public:
+  Forwarder()
+  {
+    socket_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (socket_ < 0)
+      throw runtime_error("Forwarder: Cannot create the socket");
+
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0;
+    socklen_t addressLength = sizeof(address);
+    if (::bind(socket_, (struct sockaddr*)&address, sizeof(address)) < 0 ||
+        getsockname(socket_, (struct sockaddr*)&address, &addressLength) < 0) {
+      ::close(socket_);
+      throw runtime_error("Forwarder: Cannot bind the socket");
+    }
+    port_ = ntohs(address.sin_port);
+  }
+
+  ~Forwarder()
+  {
+    ::close(socket_);
+  }
+
+  /**
+   * Make a Face which sends to this forwarder over a UdpTransport. The
+   * transport connects on the first expressInterest.
+   */
+  ptr_lib::shared_ptr<Face>
+  makeFace()
+  {
+    return ptr_lib::make_shared<Face>
+      (ptr_lib::make_shared<UdpTransport>(),
+       ptr_lib::make_shared<UdpTransport::ConnectionInfo>("127.0.0.1", port_));
+  }
+
+  /**
+   * Receive the given number of Interest packets and answer each with a Data
+   * packet of the same name.
+   * @param nInterests The number of Interest packets to answer.
+   * @return True if all were received before the timeout.
+   */
+  bool
+  answerInterests(int nInterests)
+  {
+    for (int i = 0; i < nInterests; ++i) {
+      struct pollfd pollInfo;
+      pollInfo.fd = socket_;
+      pollInfo.events = POLLIN;
+      if (poll(&pollInfo, 1, 2000) <= 0)
+        return false;
+
+      uint8_t buffer[8800];
+      struct sockaddr_in from;
+      socklen_t fromLength = sizeof(from);
+      ssize_t nBytes = recvfrom
+        (socket_, buffer, sizeof(buffer), 0, (struct sockaddr*)&from,
+         &fromLength);
+      if (nBytes <= 0)
+        return false;
+
+      Interest interest;
+      interest.wireDecode(buffer, nBytes);
+      Data data(interest.getName());
+      data.setContent(Blob((const uint8_t*)"content", 7));
+      data.setSignature(DigestSha256Signature());
+      Blob encoding = data.wireEncode();
+      sendto(socket_, encoding.buf(), encoding.size(), 0,
+             (struct sockaddr*)&from, fromLength);
+    }
+
+    return true;
+  }
+
+private:
+  int socket_;
+  unsigned short port_;
+};
+
+class CallbackCounter {
+public:
+  CallbackCounter()
+  : nData_(0), nTimeouts_(0), nCalls_(0)
+  {
+  }
+
+  void
+  onData
+    (const ptr_lib::shared_ptr<const Interest>& interest,
+     const ptr_lib::shared_ptr<Data>& data)
+  {
+    ++nData_;
+    lastData_ = data;
+  }
+
+  void
+  onTimeout(const ptr_lib::shared_ptr<const Interest>& interest)
+  {
+    ++nTimeouts_;
+  }
+
+  void
+  onCall() { ++nCalls_; }
+
+  int nData_;
+  int nTimeouts_;
+  int nCalls_;
+  ptr_lib::shared_ptr<Data> lastData_;
+};
+
+class TestFaceReactor : public ::testing::Test {
+public:
+  TestFaceReactor()
+  {
+    face1_ = forwarder_.makeFace();
+    face2_ = forwarder_.makeFace();
+  }
+
+  /**
+   * Express an Interest on the face with the callbacks of counter.
+   */
+  void
+  expressInterest
+    (Face& face, const Name& name, CallbackCounter& counter,
+     Milliseconds lifetimeMilliseconds = 4000)
+  {
+    Interest interest(name);
+    interest.setInterestLifetimeMilliseconds(lifetimeMilliseconds);
+    face.expressInterest
+      (interest, bind(&CallbackCounter::onData, &counter, _1, _2),
+       bind(&CallbackCounter::onTimeout, &counter, _1));
+  }
+
+  Forwarder forwarder_;
+  ptr_lib::shared_ptr<Face> face1_;
+  ptr_lib::shared_ptr<Face> face2_;
+};
+
+TEST_F(TestFaceReactor, Dispatch)
+{
+  FaceReactor reactor;
+  reactor.addFace(*face1_);
+  reactor.addFace(*face2_);
+  reactor.addFace(*face1_);
+  ASSERT_EQ((size_t)2, reactor.size()) << "Adding a face twice should do nothing";
+
+  // The faces connect when expressing the interests, after being added.
+  CallbackCounter counter1;
+  CallbackCounter counter2;
+  expressInterest(*face1_, Name("/test/face1"), counter1);
+  expressInterest(*face2_, Name("/test/face2"), counter2);
+  ASSERT_TRUE(forwarder_.answerInterests(2));
+
+  MillisecondsSince1970 endTime = ndn_getNowMilliseconds() + 2000;
+  while ((counter1.nData_ < 1 || counter2.nData_ < 1) &&
+         ndn_getNowMilliseconds() < endTime)
+    reactor.processEvents(100);
+
+  ASSERT_EQ(1, counter1.nData_);
+  ASSERT_EQ(1, counter2.nData_);
+  ASSERT_TRUE(counter1.lastData_->getName().equals(Name("/test/face1"))) <<
+    "The Data was dispatched to the wrong face";
+  ASSERT_TRUE(counter2.lastData_->getName().equals(Name("/test/face2"))) <<
+    "The Data was dispatched to the wrong face";
+
+  // The answered interests don't time out later.
+  reactor.processEvents(0);
+  ASSERT_EQ(0, counter1.nTimeouts_);
+  ASSERT_EQ(0, counter2.nTimeouts_);
+
+  reactor.removeFace(*face1_);
+  reactor.removeFace(*face2_);
+  ASSERT_EQ((size_t)0, reactor.size());
+}
+
+TEST_F(TestFaceReactor, CallLater)
+{
+  FaceReactor reactor;
+  reactor.addFace(*face1_);
+  reactor.addFace(*face2_);
+
+  CallbackCounter counter1;
+  CallbackCounter counter2;
+  face1_->callLater(200, bind(&CallbackCounter::onCall, &counter1));
+  face2_->callLater(50, bind(&CallbackCounter::onCall, &counter2));
+
+  // The wait ends for the earliest call time of any face.
+  MillisecondsSince1970 startTime = ndn_getNowMilliseconds();
+  reactor.processEvents(2000);
+  ASSERT_EQ(0, counter1.nCalls_);
+  ASSERT_EQ(1, counter2.nCalls_);
+  ASSERT_LT(ndn_getNowMilliseconds() - startTime, 1000) <<
+    "processEvents did not wake up for the callLater of the second face";
+
+  reactor.processEvents(2000);
+  ASSERT_EQ(1, counter1.nCalls_);
+  ASSERT_GE(ndn_getNowMilliseconds() - startTime, 200) <<
+    "The callLater was called too early";
+
+  // The interest timeout is also a timer in the reactor.
+  CallbackCounter timeoutCounter;
+  expressInterest(*face1_, Name("/test/timeout"), timeoutCounter, 100);
+  startTime = ndn_getNowMilliseconds();
+  while (timeoutCounter.nTimeouts_ == 0 &&
+         ndn_getNowMilliseconds() - startTime < 2000)
+    reactor.processEvents(2000);
+  ASSERT_EQ(1, timeoutCounter.nTimeouts_);
+  ASSERT_LT(ndn_getNowMilliseconds() - startTime, 1000);
+
+  // A call which was posted before the face was added is called without
+  // waiting.
+  reactor.removeFace(*face2_);
+  face2_->post(bind(&CallbackCounter::onCall, &counter2));
+  reactor.addFace(*face2_);
+  startTime = ndn_getNowMilliseconds();
+  reactor.processEvents(2000);
+  ASSERT_EQ(2, counter2.nCalls_);
+  ASSERT_LT(ndn_getNowMilliseconds() - startTime, 1000);
+}
+
+TEST_F(TestFaceReactor, RemoveFaceInCallback)
+{
+  FaceReactor reactor;
+  reactor.addFace(*face1_);
+  reactor.addFace(*face2_);
+
+  // The callLater of the first face to be called removes the other face, so
+  // that the callLater of the other face is not called.
+  CallbackCounter counter1;
+  CallbackCounter counter2;
+  face1_->callLater
+    (50, bind(&FaceReactor::removeFace, &reactor, ref(*face2_)));
+  face1_->callLater(50, bind(&CallbackCounter::onCall, &counter1));
+  face2_->callLater
+    (50, bind(&FaceReactor::removeFace, &reactor, ref(*face1_)));
+  face2_->callLater(50, bind(&CallbackCounter::onCall, &counter2));
+
+  usleep(100 * 1000);
+  reactor.processEvents(0);
+  ASSERT_EQ((size_t)1, reactor.size());
+  ASSERT_EQ(1, counter1.nCalls_ + counter2.nCalls_) <<
+    "A face removed in a callback was still processed";
+
+  // The reactor doesn't receive for the removed face, which can process its
+  // own events again.
+  Face& removedFace = counter1.nCalls_ == 1 ? *face2_ : *face1_;
+  CallbackCounter dataCounter;
+  expressInterest(removedFace, Name("/test/removed"), dataCounter);
+  ASSERT_TRUE(forwarder_.answerInterests(1));
+  reactor.processEvents(200);
+  ASSERT_EQ(0, dataCounter.nData_) <<
+    "The reactor processed the socket of a removed face";
+
+  MillisecondsSince1970 endTime = ndn_getNowMilliseconds() + 2000;
+  while (dataCounter.nData_ == 0 && ndn_getNowMilliseconds() < endTime)
+    removedFace.processEvents(100);
+  ASSERT_EQ(1, dataCounter.nData_) <<
+    "The face did not process events after it was removed";
+}
+
+int
+main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -24,7 +24,10 @@
 #include <time.h>
 #include <sys/time.h>
 #include <unistd.h>
+#include <sys/stat.h>
+#include <algorithm>
 #include <fstream>
+#include <sstream>
 #include <cstdio>
 #include <stdexcept>
 #include <ndn-cpp/security/key-chain.hpp>
@@ -32,6 +35,7 @@
 #include <ndn-cpp/security/policy/self-verify-policy-manager.hpp>
 #include <ndn-cpp/security/identity/basic-identity-storage.hpp>
 #include <ndn-cpp/security/identity/file-private-key-storage.hpp>
+#include <ndn-cpp/lite/util/crypto-lite.hpp>
 #include "../../src/encoding/base64.hpp"
 
 using namespace std;
@@ -73,6 +77,33 @@ getPolicyConfigDirectory()
   return policyConfigDirectory;
 }
 
+/**
+ * Get the path of the private key file, the same as
+ * FilePrivateKeyStorage::nameTransform.
+ */
+static string
+getPrivateKeyFilePath(const string& keyStorePath, const Name& keyName)
+{
+  string keyUri = keyName.toUri();
+  uint8_t hash[ndn_SHA256_DIGEST_SIZE];
+  CryptoLite::digestSha256((uint8_t*)&keyUri[0], keyUri.size(), hash);
+
+  string digest = toBase64(hash, sizeof(hash));
+  ndn_trim(digest);
+  std::replace(digest.begin(), digest.end(), '/', '%');
+
+  return keyStorePath + "/" + digest + ".pri";
+}
+
+static string
+readFile(const string& filePath)
+{
+  ifstream file(filePath.c_str());
+  stringstream contents;
+  contents << file.rdbuf();
+  return contents.str();
+}
+
 const char* RSA_DER =
 "MIIBIjANBgkqhkiG9w0BAQEFAAOCAQ8AMIIBCgKCAQEAuFoDcNtffwbfFix64fw0\
 hI2tKMkFrc6Ex7yw0YLMK9vGE8lXOyBl/qXabow6RCz+GldmFN6E2Qhm1+AX3Zm5\
@@ -341,6 +372,40 @@ TEST_F(TestSqlIdentityStorage, EcdsaIdentity)
   ASSERT_FALSE(identityStorage->doesKeyExist(keyName));
 }
 
+TEST_F(TestSqlIdentityStorage, RewritePrivateKeyFile)
+{
+  string keyStorePath = getPolicyConfigDirectory() + "/test-private-keys";
+  FilePrivateKeyStorage privateKeyStorage(keyStorePath);
+  Name keyName1("/TestSqlIdentityStorage/RewritePrivateKeyFile/ksk-1");
+  Name keyName2("/TestSqlIdentityStorage/RewritePrivateKeyFile/ksk-2");
+  privateKeyStorage.deleteKeyPair(keyName1);
+  privateKeyStorage.deleteKeyPair(keyName2);
+  privateKeyStorage.generateKeyPair(keyName1, RsaKeyParams());
+  privateKeyStorage.generateKeyPair(keyName2, RsaKeyParams());
+
+  // RSA signatures are deterministic, so we can compare them.
+  const uint8_t buffer[] = { 1, 2, 3, 4 };
+  Blob signature1 = privateKeyStorage.sign(buffer, sizeof(buffer), keyName1);
+  Blob signature2 = privateKeyStorage.sign(buffer, sizeof(buffer), keyName2);
+  ASSERT_FALSE(signature1.equals(signature2));
+
+  // Rewrite the first private key file in place with the second key, which
+  // keeps the inode and usually the size and the modification second.
+  string filePath1 = getPrivateKeyFilePath(keyStorePath, keyName1);
+  string privateKey2 = readFile(getPrivateKeyFilePath(keyStorePath, keyName2));
+  ::chmod(filePath1.c_str(), S_IRUSR | S_IWUSR);
+  {
+    ofstream file(filePath1.c_str());
+    file << privateKey2;
+  }
+
+  ASSERT_TRUE(privateKeyStorage.sign(buffer, sizeof(buffer), keyName1).equals
+              (signature2)) << "The rewritten private key file was not reloaded";
+
+  privateKeyStorage.deleteKeyPair(keyName1);
+  privateKeyStorage.deleteKeyPair(keyName2);
+}
+
 int
 main(int argc, char **argv)
 {
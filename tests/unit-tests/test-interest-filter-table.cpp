@@ -0,0 +1,120 @@
+/**
+ * Copyright (C) 2017 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+
+#include "gtest/gtest.h"
+#include "../../src/impl/interest-filter-table.hpp"
+
+using namespace std;
+using namespace ndn;
+
+/**
+ * Add an entry for the InterestFilter to the table.
+ */
+static void
+setInterestFilter
+  (InterestFilterTable& table, uint64_t interestFilterId,
+   const InterestFilter& filter)
+{
+  table.setInterestFilter
+    (interestFilterId, ptr_lib::make_shared<InterestFilter>(filter),
+     OnInterestCallback(), 0);
+}
+
+/**
+ * Get the interestFilterId of each entry which matches the interest name.
+ */
+static vector<uint64_t>
+getMatchedIds(InterestFilterTable& table, const Name& name)
+{
+  vector<ptr_lib::shared_ptr<InterestFilterTable::Entry> > matchedFilters;
+  table.getMatchedFilters(Interest(name), matchedFilters);
+
+  vector<uint64_t> ids;
+  for (size_t i = 0; i < matchedFilters.size(); ++i)
+    ids.push_back(matchedFilters[i]->getInterestFilterId());
+  return ids;
+}
+
+TEST(TestInterestFilterTable, MatchOrder)
+{
+  InterestFilterTable table;
+  setInterestFilter(table, 1, InterestFilter("/a/b"));
+  setInterestFilter(table, 2, InterestFilter("/x"));
+  setInterestFilter(table, 3, InterestFilter("/a"));
+  setInterestFilter(table, 4, InterestFilter("/a/b/c/d"));
+  setInterestFilter(table, 5, InterestFilter("/"));
+
+  vector<uint64_t> ids = getMatchedIds(table, Name("/a/b/c"));
+  ASSERT_EQ((size_t)3, ids.size());
+  // The matches are in the order the filters were added, not by prefix length.
+  ASSERT_EQ((uint64_t)1, ids[0]);
+  ASSERT_EQ((uint64_t)3, ids[1]);
+  ASSERT_EQ((uint64_t)5, ids[2]);
+
+  ids = getMatchedIds(table, Name("/a/b/c/d/e"));
+  ASSERT_EQ((size_t)4, ids.size());
+  ASSERT_EQ((uint64_t)4, ids[2]);
+
+  ids = getMatchedIds(table, Name("/y"));
+  ASSERT_EQ((size_t)1, ids.size());
+  ASSERT_EQ((uint64_t)5, ids[0]);
+}
+
+TEST(TestInterestFilterTable, RegexFilter)
+{
+  InterestFilterTable table;
+  setInterestFilter(table, 1, InterestFilter("/a", "<b><>"));
+  setInterestFilter(table, 2, InterestFilter("/a"));
+
+  // Both prefixes are in the index, but only one regex matches.
+  vector<uint64_t> ids = getMatchedIds(table, Name("/a/b/c"));
+  ASSERT_EQ((size_t)2, ids.size());
+  ASSERT_EQ((uint64_t)1, ids[0]);
+
+  ids = getMatchedIds(table, Name("/a/c/c"));
+  ASSERT_EQ((size_t)1, ids.size());
+  ASSERT_EQ((uint64_t)2, ids[0]);
+}
+
+TEST(TestInterestFilterTable, Unset)
+{
+  InterestFilterTable table;
+  setInterestFilter(table, 1, InterestFilter("/a"));
+  setInterestFilter(table, 2, InterestFilter("/a"));
+
+  // Unsetting one filter doesn't remove another with the same prefix.
+  table.unsetInterestFilter(1);
+  vector<uint64_t> ids = getMatchedIds(table, Name("/a/b"));
+  ASSERT_EQ((size_t)1, ids.size());
+  ASSERT_EQ((uint64_t)2, ids[0]);
+
+  // Unsetting a missing filter does nothing.
+  table.unsetInterestFilter(1);
+  table.unsetInterestFilter(2);
+  ASSERT_EQ((size_t)0, getMatchedIds(table, Name("/a/b")).size());
+}
+
+int
+main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
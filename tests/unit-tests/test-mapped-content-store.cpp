@@ -0,0 +1,275 @@
+/**
+ * Copyright (C) 2017 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+#include "gtest/gtest.h"
+#include <fstream>
+#include <stdexcept>
+#include <ndn-cpp/util/mapped-content-store.hpp>
+
+using namespace std;
+using namespace ndn;
+
+// The size of the file header before the circular log.
+static const size_t FILE_HEADER_SIZE = 64;
+
+// With the 16-byte record header, this makes a record of 80 bytes.
+static const size_t ENCODING_SIZE = 50;
+
+static bool
+fileExists(const string& filePath)
+{
+  ifstream stream(filePath.c_str());
+  bool result = (bool)stream;
+  stream.close();
+  return result;
+}
+
+static string
+getPolicyConfigDirectory()
+{
+  string policyConfigDirectory = "policy_config";
+  // Check if expected files are in this directory.
+  if (!fileExists(policyConfigDirectory + "/regex_ruleset.conf")) {
+    // Maybe we are running "make check" from the ndn-cpp root.  There may be
+    //   a way to tell "make check" to run from tests/unit-tests, but for
+    //   now just set policyConfigDirectory explicitly.
+    policyConfigDirectory = "tests/unit-tests/policy_config";
+
+    if(!fileExists(policyConfigDirectory + "/regex_ruleset.conf"))
+      throw runtime_error("Cannot find the directory for policy-config");
+  }
+
+  return policyConfigDirectory;
+}
+
+/**
+ * Overwrite the 32-bit recordLength_ of the record header at the position in
+ * the log with value.
+ */
+static void
+setRecordLength(const string& filePath, uint64_t position, uint32_t value)
+{
+  fstream file(filePath.c_str(), ios::in | ios::out | ios::binary);
+  file.seekp(FILE_HEADER_SIZE + position);
+  file.write((const char*)&value, sizeof(value));
+  file.close();
+}
+
+class TestMappedContentStore : public ::testing::Test {
+public:
+  TestMappedContentStore()
+  {
+    filePath_ = getPolicyConfigDirectory() + "/test-content-store.map";
+    remove(filePath_.c_str());
+
+    for (size_t i = 0; i < 4; ++i)
+      encodings_.push_back(vector<uint8_t>(ENCODING_SIZE, (uint8_t)(i + 1)));
+  }
+
+  virtual void
+  TearDown()
+  {
+    remove(filePath_.c_str());
+  }
+
+  uint64_t
+  append(MappedContentStore& store, size_t i)
+  {
+    return store.append(&encodings_[i][0], encodings_[i].size(), 1000.0 * i);
+  }
+
+  bool
+  readEquals(MappedContentStore& store, uint64_t position, size_t i)
+  {
+    Blob encoding;
+    if (!store.read(position, encoding))
+      return false;
+    return encoding.equals(Blob(encodings_[i]));
+  }
+
+  string filePath_;
+  vector<vector<uint8_t> > encodings_;
+};
+
+TEST_F(TestMappedContentStore, AppendRead)
+{
+  MappedContentStore store(filePath_, 1024);
+  ASSERT_EQ((size_t)1024, store.getCapacity());
+
+  uint64_t position0 = append(store, 0);
+  uint64_t position1 = append(store, 1);
+  ASSERT_EQ((uint64_t)0, position0);
+  ASSERT_EQ((uint64_t)80, position1);
+  ASSERT_TRUE(readEquals(store, position0, 0));
+  ASSERT_TRUE(readEquals(store, position1, 1));
+  Blob encoding;
+  ASSERT_FALSE(store.read(160, encoding)) << "Read past the end of the log";
+
+  uint64_t position = 0;
+  vector<MappedContentStore::Record> records;
+  ASSERT_EQ((uint64_t)0, store.readNewRecords(position, records));
+  ASSERT_EQ((size_t)2, records.size());
+  ASSERT_EQ((uint64_t)160, position);
+  ASSERT_EQ(position1, records[1].position);
+  ASSERT_EQ(1000.0, records[1].addTime);
+  ASSERT_TRUE(records[1].encoding.equals(Blob(encodings_[1])));
+
+  // Only the new records are read.
+  append(store, 2);
+  records.clear();
+  store.readNewRecords(position, records);
+  ASSERT_EQ((size_t)1, records.size());
+  ASSERT_TRUE(records[0].encoding.equals(Blob(encodings_[2])));
+
+  // Read in batches.
+  position = 0;
+  records.clear();
+  store.readNewRecords(position, records, 1);
+  ASSERT_EQ((size_t)1, records.size());
+  ASSERT_EQ((uint64_t)80, position);
+  store.readNewRecords(position, records, ENCODING_SIZE + 1);
+  ASSERT_EQ((size_t)3, records.size());
+  ASSERT_EQ((uint64_t)240, position);
+
+  ASSERT_THROW
+    (store.append(&encodings_[0][0], 0, 0), runtime_error) <<
+    "Expected error appending an empty encoding";
+}
+
+TEST_F(TestMappedContentStore, WrapAround)
+{
+  uint64_t positions[4];
+  {
+    MappedContentStore store(filePath_, 256);
+    for (size_t i = 0; i < 4; ++i)
+      positions[i] = append(store, i);
+
+    // The last record doesn't fit before the end, so it follows the padding.
+    ASSERT_EQ((uint64_t)160, positions[2]);
+    ASSERT_EQ((uint64_t)256, positions[3]);
+    // The first record is overwritten to make room.
+    Blob encoding;
+    ASSERT_FALSE(store.read(positions[0], encoding));
+    for (size_t i = 1; i < 4; ++i)
+      ASSERT_TRUE(readEquals(store, positions[i], i));
+
+    uint64_t position = 0;
+    vector<MappedContentStore::Record> records;
+    ASSERT_EQ(positions[1], store.readNewRecords(position, records));
+    ASSERT_EQ((size_t)3, records.size()) << "The padding should be skipped";
+    ASSERT_EQ(positions[3], records[2].position);
+  }
+
+  // Reopen with a different capacity, which is ignored for an existing file.
+  MappedContentStore store(filePath_, 4096);
+  ASSERT_EQ((size_t)256, store.getCapacity());
+  uint64_t position = 0;
+  vector<MappedContentStore::Record> records;
+  ASSERT_EQ(positions[1], store.readNewRecords(position, records));
+  ASSERT_EQ((size_t)3, records.size());
+  for (size_t i = 1; i < 4; ++i)
+    ASSERT_TRUE(records[i - 1].encoding.equals(Blob(encodings_[i])));
+
+  // Positions are not reused after reopening.
+  ASSERT_EQ((uint64_t)336, append(store, 0));
+}
+
+TEST_F(TestMappedContentStore, NotAContentStore)
+{
+  {
+    ofstream file(filePath_.c_str());
+    file << "This is not a content store. It is longer than the header to "
+            "make sure that the magic is checked.";
+  }
+
+  ASSERT_THROW(MappedContentStore(filePath_, 1024), runtime_error);
+}
+
+TEST_F(TestMappedContentStore, CorruptedRecordOnOpen)
+{
+  {
+    MappedContentStore store(filePath_, 1024);
+    append(store, 0);
+    append(store, 1);
+  }
+  setRecordLength(filePath_, 80, 0);
+
+  // Opening resets the corrupted log.
+  MappedContentStore store(filePath_, 1024);
+  uint64_t position = 0;
+  vector<MappedContentStore::Record> records;
+  ASSERT_EQ((uint64_t)160, store.readNewRecords(position, records));
+  ASSERT_EQ((size_t)0, records.size());
+  Blob encoding;
+  ASSERT_FALSE(store.read(0, encoding));
+
+  uint64_t newPosition = append(store, 2);
+  ASSERT_EQ((uint64_t)160, newPosition);
+  ASSERT_TRUE(readEquals(store, newPosition, 2));
+}
+
+TEST_F(TestMappedContentStore, CorruptedRecordWhileOpen)
+{
+  MappedContentStore store(filePath_, 1024);
+  append(store, 0);
+  append(store, 1);
+  // Another process sees the change through the shared mapping.
+  setRecordLength(filePath_, 0, 0);
+
+  // Reading must not loop on the zero length, and resets the log.
+  uint64_t position = 0;
+  vector<MappedContentStore::Record> records;
+  ASSERT_EQ((uint64_t)160, store.readNewRecords(position, records));
+  ASSERT_EQ((size_t)0, records.size());
+  ASSERT_EQ((uint64_t)160, position);
+
+  uint64_t newPosition = append(store, 2);
+  records.clear();
+  store.readNewRecords(position, records);
+  ASSERT_EQ((size_t)1, records.size());
+  ASSERT_EQ(newPosition, records[0].position);
+}
+
+TEST_F(TestMappedContentStore, CorruptedRecordInMakeRoom)
+{
+  MappedContentStore store(filePath_, 256);
+  for (size_t i = 0; i < 3; ++i)
+    append(store, i);
+  setRecordLength(filePath_, 0, 0);
+
+  // Making room must not loop on the zero length, and resets the log.
+  uint64_t position = append(store, 3);
+  ASSERT_EQ((uint64_t)256, position);
+  ASSERT_TRUE(readEquals(store, position, 3));
+  Blob encoding;
+  ASSERT_FALSE(store.read(80, encoding));
+
+  uint64_t readPosition = 0;
+  vector<MappedContentStore::Record> records;
+  ASSERT_EQ((uint64_t)256, store.readNewRecords(readPosition, records));
+  ASSERT_EQ((size_t)1, records.size());
+}
+
+int
+main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
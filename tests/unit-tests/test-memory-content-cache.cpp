@@ -0,0 +1,392 @@
+/**
+ * Copyright (C) 2017 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+#include "gtest/gtest.h"
+#include <fstream>
+#include <stdexcept>
+#include <unistd.h>
+#include <ndn-cpp/digest-sha256-signature.hpp>
+#include <ndn-cpp/util/memory-content-cache.hpp>
+
+using namespace std;
+using namespace ndn;
+using namespace ndn::func_lib;
+
+static bool
+fileExists(const string& filePath)
+{
+  ifstream stream(filePath.c_str());
+  bool result = (bool)stream;
+  stream.close();
+  return result;
+}
+
+static string
+getPolicyConfigDirectory()
+{
+  string policyConfigDirectory = "policy_config";
+  // Check if expected files are in this directory.
+  if (!fileExists(policyConfigDirectory + "/regex_ruleset.conf")) {
+    // Maybe we are running "make check" from the ndn-cpp root.  There may be
+    //   a way to tell "make check" to run from tests/unit-tests, but for
+    //   now just set policyConfigDirectory explicitly.
+    policyConfigDirectory = "tests/unit-tests/policy_config";
+
+    if(!fileExists(policyConfigDirectory + "/regex_ruleset.conf"))
+      throw runtime_error("Cannot find the directory for policy-config");
+  }
+
+  return policyConfigDirectory;
+}
+
+/**
+ * A CacheTestFace saves the OnInterestCallback from setInterestFilter so that
+ * the test can give interests to the MemoryContentCache, and saves the packets
+ * from send. It doesn't connect to a forwarder.
+ */
+class CacheTestFace : public Face {
+public:
+  CacheTestFace()
+  : Face("localhost")
+  {
+  }
+
+  virtual uint64_t
+  setInterestFilter(const Name& prefix, const OnInterestCallback& onInterest)
+  {
+    prefix_.reset(new Name(prefix));
+    onInterest_ = onInterest;
+    return 1;
+  }
+
+  virtual void
+  send(const uint8_t *encoding, size_t encodingLength)
+  {
+    ptr_lib::shared_ptr<Data> data(new Data());
+    data->wireDecode(encoding, encodingLength);
+    sentData_.push_back(data);
+  }
+
+  /**
+   * Give the interest to the OnInterestCallback from setInterestFilter.
+   * @param uri The interest name URI.
+   * @param childSelector The child selector, or -1 for none.
+   * @return The Data packet which the cache sent, or null if none.
+   */
+  ptr_lib::shared_ptr<Data>
+  receiveInterest(const string& uri, int childSelector = -1)
+  {
+    ptr_lib::shared_ptr<Interest> interest(new Interest(Name(uri)));
+    interest->setChildSelector(childSelector);
+    size_t nSent = sentData_.size();
+    onInterest_
+      (prefix_, interest, *this, 1,
+       ptr_lib::make_shared<InterestFilter>(*prefix_));
+    if (sentData_.size() == nSent)
+      return ptr_lib::shared_ptr<Data>();
+    return sentData_.back();
+  }
+
+  ptr_lib::shared_ptr<Name> prefix_;
+  OnInterestCallback onInterest_;
+  vector<ptr_lib::shared_ptr<Data> > sentData_;
+};
+
+class RemovedContent {
+public:
+  void
+  onContentRemoved
+    (const ptr_lib::shared_ptr<MemoryContentCache::ContentList>& contentList)
+  {
+    for (size_t i = 0; i < contentList->size(); ++i)
+      names_.push_back((*contentList)[i]->getName().toUri());
+  }
+
+  vector<string> names_;
+};
+
+static Data
+makeData(const string& uri, const string& content = "content",
+         Milliseconds freshnessPeriod = -1)
+{
+  Data data((Name(uri)));
+  data.setContent(Blob((const uint8_t*)content.c_str(), content.size()));
+  data.getMetaInfo().setFreshnessPeriod(freshnessPeriod);
+  data.setSignature(DigestSha256Signature());
+  return data;
+}
+
+class TestMemoryContentCache : public ::testing::Test {
+public:
+  TestMemoryContentCache()
+  : cache_(&face_)
+  {
+    cache_.setInterestFilter(Name("/"));
+    cache_.setOnContentRemoved
+      (bind(&RemovedContent::onContentRemoved, &removed_, _1));
+  }
+
+  /**
+   * Send an interest for the exact name, so that the content is used.
+   */
+  void
+  use(const string& uri) { face_.receiveInterest(uri); }
+
+  /**
+   * Check if the cache has the content for the exact name.
+   */
+  bool
+  has(const string& uri)
+  {
+    ptr_lib::shared_ptr<Data> data = face_.receiveInterest(uri);
+    return data && data->getName().equals(Name(uri));
+  }
+
+  CacheTestFace face_;
+  MemoryContentCache cache_;
+  RemovedContent removed_;
+};
+
+TEST_F(TestMemoryContentCache, NameIndex)
+{
+  cache_.add(makeData("/A/2"));
+  cache_.add(makeData("/A/1"));
+  cache_.add(makeData("/A/3"));
+  cache_.add(makeData("/B/1"));
+
+  ptr_lib::shared_ptr<Data> data = face_.receiveInterest("/A", 0);
+  ASSERT_TRUE(data->getName().equals(Name("/A/1"))) <<
+    "The leftmost child should be selected";
+  data = face_.receiveInterest("/A", 1);
+  ASSERT_TRUE(data->getName().equals(Name("/A/3"))) <<
+    "The rightmost child should be selected";
+  data = face_.receiveInterest("/B");
+  ASSERT_TRUE(data->getName().equals(Name("/B/1")));
+  data = face_.receiveInterest("/");
+  ASSERT_TRUE(data->getName().equals(Name("/A/1")));
+  ASSERT_EQ((uint64_t)4, cache_.getNHits());
+
+  // Content with the interest name as a prefix is not in the range of /A.
+  ASSERT_FALSE((bool)face_.receiveInterest("/AB"));
+  ASSERT_FALSE((bool)face_.receiveInterest("/A/1/x"));
+  ASSERT_EQ((uint64_t)2, cache_.getNMisses());
+
+  // Adding the same name replaces the content without reporting a removal.
+  cache_.add(makeData("/A/2", "new content"));
+  data = face_.receiveInterest("/A/2");
+  ASSERT_TRUE(data->getContent().equals
+    (Blob((const uint8_t*)"new content", 11)));
+  ASSERT_EQ((size_t)0, removed_.names_.size());
+}
+
+TEST_F(TestMemoryContentCache, LeastRecentlyUsed)
+{
+  cache_.setContentLimits(3, 0);
+  cache_.add(makeData("/1"));
+  cache_.add(makeData("/2"));
+  cache_.add(makeData("/3"));
+  use("/1");
+
+  cache_.add(makeData("/4"));
+  ASSERT_EQ((size_t)1, removed_.names_.size());
+  ASSERT_EQ(string("/2"), removed_.names_[0]);
+  ASSERT_EQ((uint64_t)1, cache_.getNEvictions());
+  ASSERT_TRUE(has("/1"));
+  ASSERT_FALSE(has("/2"));
+
+  // Lowering the limit evicts now.
+  cache_.setContentLimits(1, 0);
+  ASSERT_EQ((size_t)3, removed_.names_.size());
+  ASSERT_TRUE(has("/1")) << "The most recently used content should be kept";
+}
+
+TEST_F(TestMemoryContentCache, LeastFrequentlyUsed)
+{
+  cache_.setEvictionPolicy(MemoryContentCache::LFU);
+  cache_.setContentLimits(3, 0);
+  cache_.add(makeData("/1"));
+  cache_.add(makeData("/2"));
+  cache_.add(makeData("/3"));
+  use("/1");
+  use("/1");
+  use("/3");
+
+  cache_.add(makeData("/4"));
+  ASSERT_EQ((size_t)1, removed_.names_.size());
+  ASSERT_EQ(string("/2"), removed_.names_[0]);
+
+  // /4 has no uses, and the added /5 is not evicted.
+  cache_.add(makeData("/5"));
+  ASSERT_EQ((size_t)2, removed_.names_.size());
+  ASSERT_EQ(string("/4"), removed_.names_[1]);
+  ASSERT_TRUE(has("/1"));
+  ASSERT_TRUE(has("/3"));
+}
+
+TEST_F(TestMemoryContentCache, Clock)
+{
+  cache_.setEvictionPolicy(MemoryContentCache::CLOCK);
+  cache_.setContentLimits(3, 0);
+  cache_.add(makeData("/1"));
+  cache_.add(makeData("/2"));
+  cache_.add(makeData("/3"));
+
+  // New content is referenced, so the first sweep clears all the flags.
+  cache_.add(makeData("/4"));
+  ASSERT_EQ((size_t)1, removed_.names_.size());
+  ASSERT_EQ(string("/1"), removed_.names_[0]);
+
+  // /2 is used, so it gets a second chance and /3 is evicted.
+  use("/2");
+  cache_.add(makeData("/5"));
+  ASSERT_EQ((size_t)2, removed_.names_.size());
+  ASSERT_EQ(string("/3"), removed_.names_[1]);
+  ASSERT_TRUE(has("/2"));
+
+  // /5 was skipped as the added content, so it still has its flag.
+  cache_.add(makeData("/6"));
+  ASSERT_EQ((size_t)3, removed_.names_.size());
+  ASSERT_EQ(string("/4"), removed_.names_[2]);
+}
+
+TEST_F(TestMemoryContentCache, MaxBytes)
+{
+  size_t nBytes = makeData("/1").wireEncode().size();
+  cache_.setContentLimits(0, 2 * nBytes);
+  cache_.add(makeData("/1"));
+  cache_.add(makeData("/2"));
+  ASSERT_EQ(2 * nBytes, cache_.getNContentBytes());
+
+  cache_.add(makeData("/3"));
+  ASSERT_EQ((size_t)1, removed_.names_.size());
+  ASSERT_EQ(string("/1"), removed_.names_[0]);
+  ASSERT_EQ(2 * nBytes, cache_.getNContentBytes());
+
+  // Replacing content updates the byte count, and can evict other content.
+  cache_.add(makeData("/3", "longer content"));
+  ASSERT_EQ((size_t)2, removed_.names_.size());
+  ASSERT_EQ(string("/2"), removed_.names_[1]);
+  ASSERT_EQ(makeData("/3", "longer content").wireEncode().size(),
+            cache_.getNContentBytes());
+}
+
+TEST_F(TestMemoryContentCache, StaleContent)
+{
+  MemoryContentCache cache(&face_, 0);
+  cache.setInterestFilter(Name("/"));
+  RemovedContent removed;
+  cache.setOnContentRemoved
+    (bind(&RemovedContent::onContentRemoved, &removed, _1));
+
+  cache.add(makeData("/stale", "content", 10));
+  cache.add(makeData("/replaced", "content", 10));
+  // Replace with content which doesn't go stale.
+  cache.add(makeData("/replaced"));
+  usleep(50 * 1000);
+
+  // The cleanup in add removes the stale content but not the replacement.
+  cache.add(makeData("/other"));
+  ASSERT_EQ((size_t)1, removed.names_.size());
+  ASSERT_EQ(string("/stale"), removed.names_[0]);
+  ASSERT_TRUE((bool)face_.receiveInterest("/replaced"));
+}
+
+TEST_F(TestMemoryContentCache, PendingInterests)
+{
+  const OnInterestCallback& storePendingInterest =
+    cache_.getStorePendingInterest();
+  ptr_lib::shared_ptr<Name> prefix(new Name("/"));
+  ptr_lib::shared_ptr<InterestFilter> filter(new InterestFilter("/"));
+
+  ptr_lib::shared_ptr<Interest> shortInterest(new Interest(Name("/P/1")));
+  shortInterest->setInterestLifetimeMilliseconds(50);
+  ptr_lib::shared_ptr<Interest> longInterest(new Interest(Name("/P")));
+  longInterest->setInterestLifetimeMilliseconds(10000);
+  // An interest with no lifetime doesn't time out.
+  ptr_lib::shared_ptr<Interest> noTimeoutInterest(new Interest(Name("/Q")));
+  storePendingInterest(prefix, shortInterest, face_, 1, filter);
+  storePendingInterest(prefix, longInterest, face_, 1, filter);
+  storePendingInterest(prefix, noTimeoutInterest, face_, 1, filter);
+
+  vector<ptr_lib::shared_ptr<const MemoryContentCache::PendingInterest> >
+    pendingInterests;
+  cache_.getPendingInterestsWithPrefix(Name("/P"), pendingInterests);
+  ASSERT_EQ((size_t)2, pendingInterests.size());
+  cache_.getPendingInterestsForName(Name("/P/1/x"), pendingInterests);
+  ASSERT_EQ((size_t)2, pendingInterests.size());
+  cache_.getPendingInterestsForName(Name("/P/2"), pendingInterests);
+  ASSERT_EQ((size_t)1, pendingInterests.size());
+  cache_.getPendingInterestsWithPrefix(Name("/"), pendingInterests);
+  ASSERT_EQ((size_t)3, pendingInterests.size());
+
+  usleep(100 * 1000);
+  cache_.getPendingInterestsWithPrefix(Name("/P"), pendingInterests);
+  ASSERT_EQ((size_t)1, pendingInterests.size()) <<
+    "The timed-out interest was not removed";
+  ASSERT_TRUE(pendingInterests[0]->getInterest()->getName().equals(Name("/P")));
+
+  // Adding matching Data sends it and removes the satisfied interest.
+  cache_.add(makeData("/P/1"));
+  ASSERT_EQ((size_t)1, face_.sentData_.size());
+  ASSERT_TRUE(face_.sentData_[0]->getName().equals(Name("/P/1")));
+  cache_.getPendingInterestsWithPrefix(Name("/P"), pendingInterests);
+  ASSERT_EQ((size_t)0, pendingInterests.size());
+  cache_.getPendingInterestsWithPrefix(Name("/Q"), pendingInterests);
+  ASSERT_EQ((size_t)1, pendingInterests.size());
+}
+
+TEST_F(TestMemoryContentCache, OverwrittenInStore)
+{
+  string filePath = getPolicyConfigDirectory() + "/test-content-cache.map";
+  remove(filePath.c_str());
+
+  {
+    ptr_lib::shared_ptr<MappedContentStore> store
+      (new MappedContentStore(filePath, 1024));
+    MemoryContentCache cache(&face_, store);
+    cache.setInterestFilter(Name("/"));
+    RemovedContent removed;
+    cache.setOnContentRemoved
+      (bind(&RemovedContent::onContentRemoved, &removed, _1));
+
+    for (int i = 0; i < 40; ++i) {
+      ostringstream uri;
+      uri << "/" << i;
+      cache.add(makeData(uri.str()));
+    }
+
+    ASSERT_TRUE(removed.names_.size() > 0) <<
+      "The content overwritten in the store was not reported";
+    ASSERT_EQ(string("/0"), removed.names_[0]);
+    ASSERT_FALSE((bool)face_.receiveInterest("/0"));
+    ASSERT_TRUE((bool)face_.receiveInterest("/39"));
+    ASSERT_EQ((uint64_t)0, cache.getNEvictions()) <<
+      "Overwritten content is not an eviction";
+  }
+
+  remove(filePath.c_str());
+}
+
+int
+main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -273,6 +273,55 @@ TEST_F(TestNameMethods, EncodeDecode)
   ASSERT_EQ(decodedName2, name2);
 }
 
+TEST_F(TestNameMethods, Hash)
+{
+  Name name("/local/ndn/prefix");
+  Name decodedName;
+  decodedName.wireDecode(Blob(TEST_NAME, sizeof(TEST_NAME)), *TlvWireFormat::get());
+  ASSERT_EQ(name.hash(), decodedName.hash());
+  ASSERT_EQ(name.get(1).hash(), decodedName.get(1).hash());
+  ASSERT_NE(name.get(0).hash(), name.get(1).hash());
+
+  // Changing the name must change the saved hash code.
+  size_t hashCode = name.hash();
+  name.append("x");
+  ASSERT_NE(hashCode, name.hash());
+  ASSERT_EQ(Name("/local/ndn/prefix/x").hash(), name.hash());
+
+  NameMap<int>::type map;
+  map[Name("/local/ndn/prefix")] = 1;
+  map[name] = 2;
+  ASSERT_EQ((size_t)2, map.size());
+  ASSERT_EQ(1, map[decodedName]);
+  ASSERT_EQ(2, map[Name("/local/ndn/prefix/x")]);
+}
+
+TEST_F(TestNameMethods, DecodeIntoExistingName)
+{
+  Name name("/local/other/prefix/extra");
+  const uint8_t* localBuffer = name.get(0).getValue().buf();
+  const uint8_t* prefixBuffer = name.get(2).getValue().buf();
+
+  name.wireDecode(Blob(TEST_NAME, sizeof(TEST_NAME)), *TlvWireFormat::get());
+  ASSERT_EQ(Name("/local/ndn/prefix"), name);
+  // The components which didn't change should keep their value.
+  ASSERT_EQ(localBuffer, name.get(0).getValue().buf());
+  ASSERT_EQ(prefixBuffer, name.get(2).getValue().buf());
+
+  // A generic component with the same bytes as the digest must be replaced.
+  Name digestName
+    ("/local/ndn/prefix/sha256digest="
+     "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f");
+  Name name2("/local/ndn/prefix");
+  name2.append(digestName.get(3).getValue());
+  ASSERT_TRUE(name2.get(3).isGeneric());
+  name2.wireDecode
+    (Blob(TEST_NAME_IMPLICIT_DIGEST, sizeof(TEST_NAME_IMPLICIT_DIGEST)),
+     *TlvWireFormat::get());
+  ASSERT_TRUE(name2.get(3).isImplicitSha256Digest());
+  ASSERT_EQ(digestName, name2);
+}
+
 TEST_F(TestNameMethods, ImplicitSha256Digest)
 {
   Name name;
@@ -0,0 +1,447 @@
+/**
+ * Copyright (C) 2017 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+
+#include "gtest/gtest.h"
+#include <cstring>
+#include <stdexcept>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <ndn-cpp/digest-sha256-signature.hpp>
+#include <ndn-cpp/transport/udp-transport.hpp>
+#include "../../src/c/util/time.h"
+#include "../../src/impl/pending-interest-table.hpp"
+
+using namespace std;
+using namespace ndn;
+using namespace ndn::func_lib;
+
+static void
+onNetworkNack
+  (const ptr_lib::shared_ptr<const Interest>& interest,
+   const ptr_lib::shared_ptr<NetworkNack>& networkNack) {}
+
+/**
+ * Add an entry for an Interest with the name to the table.
+ * @param onNetworkNack The OnNetworkNack for the entry, or OnNetworkNack() for
+ * none.
+ * @return The new entry.
+ */
+static ptr_lib::shared_ptr<PendingInterestTable::Entry>
+addEntry
+  (PendingInterestTable& table, uint64_t pendingInterestId, const Name& name,
+   const OnNetworkNack& onNetworkNack = OnNetworkNack())
+{
+  return table.add
+    (pendingInterestId, ptr_lib::make_shared<Interest>(name), OnData(),
+     OnTimeout(), onNetworkNack);
+}
+
+static Data
+makeData(const Name& name)
+{
+  Data data(name);
+  data.setSignature(DigestSha256Signature());
+  return data;
+}
+
+TEST(TestPendingInterestTable, ExpressedInterestOrder)
+{
+  PendingInterestTable table;
+  addEntry(table, 1, Name("/a"));
+  addEntry(table, 2, Name("/a/b/c"));
+  addEntry(table, 3, Name("/a/b"));
+  addEntry(table, 4, Name("/x"));
+  addEntry(table, 5, Name("/a/b/c/d/e"));
+  ASSERT_EQ((size_t)5, table.size());
+
+  vector<ptr_lib::shared_ptr<PendingInterestTable::Entry> > entries;
+  table.extractEntriesForExpressedInterest(makeData(Name("/a/b/c/d")), entries);
+  ASSERT_EQ((size_t)3, entries.size());
+  // The most recently expressed interest is first, not the shortest name.
+  ASSERT_EQ((uint64_t)3, entries[0]->getPendingInterestId());
+  ASSERT_EQ((uint64_t)2, entries[1]->getPendingInterestId());
+  ASSERT_EQ((uint64_t)1, entries[2]->getPendingInterestId());
+  for (size_t i = 0; i < entries.size(); ++i)
+    ASSERT_TRUE(entries[i]->getIsRemoved());
+
+  ASSERT_EQ((size_t)2, table.size());
+  entries.clear();
+  table.extractEntriesForExpressedInterest(makeData(Name("/a/b/c/d")), entries);
+  ASSERT_EQ((size_t)0, entries.size()) << "The extracted entries were not removed";
+}
+
+TEST(TestPendingInterestTable, Selectors)
+{
+  PendingInterestTable table;
+  ptr_lib::shared_ptr<Interest> interest(new Interest(Name("/a")));
+  interest->setMaxSuffixComponents(2);
+  table.add(1, interest, OnData(), OnTimeout(), OnNetworkNack());
+
+  // The name is in the index, but the selectors don't match.
+  vector<ptr_lib::shared_ptr<PendingInterestTable::Entry> > entries;
+  table.extractEntriesForExpressedInterest(makeData(Name("/a/b/c")), entries);
+  ASSERT_EQ((size_t)0, entries.size());
+  ASSERT_EQ((size_t)1, table.size());
+
+  table.extractEntriesForExpressedInterest(makeData(Name("/a/b")), entries);
+  ASSERT_EQ((size_t)1, entries.size());
+  ASSERT_EQ((size_t)0, table.size());
+}
+
+TEST(TestPendingInterestTable, ImplicitDigest)
+{
+  PendingInterestTable table;
+  Data data = makeData(Name("/a/b"));
+  Data otherData = makeData(Name("/a/b"));
+  otherData.setContent(Blob((const uint8_t*)"other", 5));
+  // The interest name ends with the implicit digest, which is not in the data
+  // name.
+  addEntry(table, 1, *data.getFullName());
+
+  vector<ptr_lib::shared_ptr<PendingInterestTable::Entry> > entries;
+  table.extractEntriesForExpressedInterest(otherData, entries);
+  ASSERT_EQ((size_t)0, entries.size());
+
+  table.extractEntriesForExpressedInterest(data, entries);
+  ASSERT_EQ((size_t)1, entries.size()) <<
+    "The interest with the implicit digest was not found in the index";
+  ASSERT_EQ((size_t)0, table.size());
+}
+
+TEST(TestPendingInterestTable, NackInterest)
+{
+  PendingInterestTable table;
+  ptr_lib::shared_ptr<PendingInterestTable::Entry> entry1 = addEntry
+    (table, 1, Name("/a/b"), &onNetworkNack);
+  ptr_lib::shared_ptr<PendingInterestTable::Entry> entry2 = addEntry
+    (table, 2, Name("/a/b"));
+  addEntry(table, 3, Name("/a"), &onNetworkNack);
+
+  vector<ptr_lib::shared_ptr<PendingInterestTable::Entry> > entries;
+  table.extractEntriesForNackInterest(*entry1->getInterest(), entries);
+  ASSERT_EQ((size_t)1, entries.size());
+  ASSERT_EQ(entry1.get(), entries[0].get());
+  // The entry without an OnNetworkNack stays for the timeout.
+  ASSERT_EQ((size_t)2, table.size());
+  ASSERT_FALSE(entry2->getIsRemoved());
+}
+
+TEST(TestPendingInterestTable, Remove)
+{
+  PendingInterestTable table;
+  ptr_lib::shared_ptr<PendingInterestTable::Entry> entry1 = addEntry
+    (table, 1, Name("/a"));
+  ptr_lib::shared_ptr<PendingInterestTable::Entry> entry2 = addEntry
+    (table, 2, Name("/a"));
+
+  ASSERT_EQ(entry1.get(), table.removePendingInterest(1).get());
+  ASSERT_TRUE(entry1->getIsRemoved());
+  ASSERT_FALSE(table.removeEntry(entry1));
+  ASSERT_TRUE(table.removeEntry(entry2));
+  ASSERT_EQ((size_t)0, table.size());
+
+  // Removing before adding prevents the add.
+  ASSERT_FALSE((bool)table.removePendingInterest(3));
+  ASSERT_FALSE((bool)addEntry(table, 3, Name("/a")));
+  ASSERT_EQ((size_t)0, table.size());
+  // The removal request is only used once.
+  ASSERT_TRUE((bool)addEntry(table, 3, Name("/a")));
+
+  // The removed entries are no longer in the name index.
+  vector<ptr_lib::shared_ptr<PendingInterestTable::Entry> > entries;
+  table.extractEntriesForExpressedInterest(makeData(Name("/a")), entries);
+  ASSERT_EQ((size_t)1, entries.size());
+  ASSERT_EQ((uint64_t)3, entries[0]->getPendingInterestId());
+}
+
+/**
+ * A SubclassFace is a subclass of Face which doesn't override anything.
+ */
+class SubclassFace : public Face {
+public:
+  SubclassFace
+    (const ptr_lib::shared_ptr<Transport>& transport,
+     const ptr_lib::shared_ptr<const Transport::ConnectionInfo>& connectionInfo)
+  : Face(transport, connectionInfo)
+  {
+  }
+};
+
+/**
+ * A CountingFace is a subclass of Face which overrides callLaterCancellable
+ * to count the calls and the cancels.
+ */
+class CountingFace : public Face {
+public:
+  CountingFace
+    (const ptr_lib::shared_ptr<Transport>& transport,
+     const ptr_lib::shared_ptr<const Transport::ConnectionInfo>& connectionInfo)
+  : Face(transport, connectionInfo), nCalls_(0), nCancels_(0)
+  {
+  }
+
+  virtual ptr_lib::shared_ptr<CancellableCall>
+  callLaterCancellable
+    (Milliseconds delayMilliseconds, const Callback& callback)
+  {
+    ++nCalls_;
+    // The library only keeps a weak_ptr, so keep the CountingCall.
+    calls_.push_back(ptr_lib::shared_ptr<CancellableCall>(new CountingCall
+      (Face::callLaterCancellable(delayMilliseconds, callback), nCancels_)));
+    return calls_.back();
+  }
+
+  int nCalls_;
+  int nCancels_;
+  vector<ptr_lib::shared_ptr<CancellableCall> > calls_;
+
+private:
+  class CountingCall : public CancellableCall {
+  public:
+    CountingCall
+      (const ptr_lib::shared_ptr<CancellableCall>& call, int& nCancels)
+    : call_(call), nCancels_(nCancels)
+    {
+    }
+
+    virtual void
+    cancel()
+    {
+      ++nCancels_;
+      call_->cancel();
+    }
+
+  private:
+    ptr_lib::shared_ptr<CancellableCall> call_;
+    int& nCancels_;
+  };
+};
+
+/**
+ * A CallLaterFace is a subclass of Face which overrides only callLater to keep
+ * the calls in its own list, which the Face never processes.
+ */
+class CallLaterFace : public Face {
+public:
+  CallLaterFace
+    (const ptr_lib::shared_ptr<Transport>& transport,
+     const ptr_lib::shared_ptr<const Transport::ConnectionInfo>& connectionInfo)
+  : Face(transport, connectionInfo)
+  {
+  }
+
+  virtual void
+  callLater(Milliseconds delayMilliseconds, const Callback& callback)
+  {
+    calls_.push_back(make_pair
+      (ndn_getNowMilliseconds() + delayMilliseconds, callback));
+  }
+
+  /**
+   * Call and remove the calls whose time has come.
+   */
+  void
+  callTimedOut()
+  {
+    MillisecondsSince1970 now = ndn_getNowMilliseconds();
+    // A callback may add to calls_, so first remove the timed-out calls.
+    vector<Callback> timedOut;
+    for (size_t i = 0; i < calls_.size(); ) {
+      if (calls_[i].first <= now) {
+        timedOut.push_back(calls_[i].second);
+        calls_.erase(calls_.begin() + i);
+      }
+      else
+        ++i;
+    }
+
+    for (size_t i = 0; i < timedOut.size(); ++i)
+      timedOut[i]();
+  }
+
+  vector<pair<MillisecondsSince1970, Callback> > calls_;
+};
+
+class CallbackCounter {
+public:
+  CallbackCounter()
+  : nData_(0), nTimeouts_(0)
+  {
+  }
+
+  void
+  onData
+    (const ptr_lib::shared_ptr<const Interest>& interest,
+     const ptr_lib::shared_ptr<Data>& data)
+  {
+    ++nData_;
+  }
+
+  void
+  onTimeout(const ptr_lib::shared_ptr<const Interest>& interest)
+  {
+    ++nTimeouts_;
+  }
+
+  int nData_;
+  int nTimeouts_;
+};
+
+/**
+ * TestFaceTimeouts has a UDP socket on the loopback interface which receives
+ * the interests from the faces and doesn't answer.
+ */
+class TestFaceTimeouts : public ::testing::Test {
+public:
+  TestFaceTimeouts()
+  {
+    socket_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (socket_ < 0)
+      throw runtime_error("TestFaceTimeouts: Cannot create the socket");
+
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0;
+    socklen_t addressLength = sizeof(address);
+    if (::bind(socket_, (struct sockaddr*)&address, sizeof(address)) < 0 ||
+        getsockname(socket_, (struct sockaddr*)&address, &addressLength) < 0) {
+      ::close(socket_);
+      throw runtime_error("TestFaceTimeouts: Cannot bind the socket");
+    }
+    port_ = ntohs(address.sin_port);
+  }
+
+  ~TestFaceTimeouts()
+  {
+    ::close(socket_);
+  }
+
+  ptr_lib::shared_ptr<Transport>
+  makeTransport() { return ptr_lib::make_shared<UdpTransport>(); }
+
+  ptr_lib::shared_ptr<Transport::ConnectionInfo>
+  makeConnectionInfo()
+  {
+    return ptr_lib::make_shared<UdpTransport::ConnectionInfo>
+      ("127.0.0.1", port_);
+  }
+
+  /**
+   * Express an Interest on the face with the callbacks of counter.
+   * @return The pendingInterestId.
+   */
+  static uint64_t
+  expressInterest
+    (Face& face, const Name& name,
+     const ptr_lib::shared_ptr<CallbackCounter>& counter,
+     Milliseconds lifetimeMilliseconds)
+  {
+    Interest interest(name);
+    interest.setInterestLifetimeMilliseconds(lifetimeMilliseconds);
+    return face.expressInterest
+      (interest, bind(&CallbackCounter::onData, counter, _1, _2),
+       bind(&CallbackCounter::onTimeout, counter, _1));
+  }
+
+  int socket_;
+  unsigned short port_;
+};
+
+TEST_F(TestFaceTimeouts, RemoveReleasesTimeout)
+{
+  SubclassFace face(makeTransport(), makeConnectionInfo());
+  ptr_lib::shared_ptr<CallbackCounter> counter(new CallbackCounter());
+  ptr_lib::weak_ptr<CallbackCounter> weakCounter(counter);
+  uint64_t pendingInterestId = expressInterest
+    (face, Name("/test/remove"), counter, 10000);
+  counter.reset();
+  ASSERT_FALSE(weakCounter.expired());
+
+  face.removePendingInterest(pendingInterestId);
+  ASSERT_TRUE(weakCounter.expired()) <<
+    "The interest timeout of the Face subclass was not cancelled";
+}
+
+TEST_F(TestFaceTimeouts, OverriddenCallLater)
+{
+  CountingFace face(makeTransport(), makeConnectionInfo());
+  ptr_lib::shared_ptr<CallbackCounter> counter(new CallbackCounter());
+  uint64_t pendingInterestId1 = expressInterest
+    (face, Name("/test/removed"), counter, 50);
+  expressInterest(face, Name("/test/timeout"), counter, 50);
+  ASSERT_EQ(2, face.nCalls_);
+
+  face.removePendingInterest(pendingInterestId1);
+  ASSERT_EQ(1, face.nCancels_);
+
+  MillisecondsSince1970 endTime = ndn_getNowMilliseconds() + 2000;
+  while (counter->nTimeouts_ < 1 && ndn_getNowMilliseconds() < endTime) {
+    face.processEvents();
+    usleep(10000);
+  }
+  ASSERT_EQ(1, counter->nTimeouts_);
+  ASSERT_EQ(0, counter->nData_);
+}
+
+TEST_F(TestFaceTimeouts, OverriddenOnlyCallLater)
+{
+  CallLaterFace face(makeTransport(), makeConnectionInfo());
+  ptr_lib::shared_ptr<CallbackCounter> counter(new CallbackCounter());
+  ptr_lib::weak_ptr<CallbackCounter> weakCounter(counter);
+  uint64_t pendingInterestId1 = expressInterest
+    (face, Name("/test/removed"), counter, 50);
+  expressInterest(face, Name("/test/timeout"), counter, 50);
+  ASSERT_EQ((size_t)2, face.calls_.size()) <<
+    "The interest timeouts were not scheduled with the overridden callLater";
+
+  face.removePendingInterest(pendingInterestId1);
+
+  MillisecondsSince1970 endTime = ndn_getNowMilliseconds() + 2000;
+  while (counter->nTimeouts_ < 1 && ndn_getNowMilliseconds() < endTime) {
+    face.processEvents();
+    face.callTimedOut();
+    usleep(10000);
+  }
+  ASSERT_EQ(1, counter->nTimeouts_);
+  ASSERT_EQ(0, counter->nData_);
+  ASSERT_EQ((size_t)0, face.calls_.size());
+
+  // The timeout of a removed interest releases its callbacks while it is still
+  // in the list of calls.
+  uint64_t pendingInterestId2 = expressInterest
+    (face, Name("/test/removed2"), counter, 10000);
+  counter.reset();
+  ASSERT_FALSE(weakCounter.expired());
+  face.removePendingInterest(pendingInterestId2);
+  ASSERT_EQ((size_t)1, face.calls_.size());
+  ASSERT_TRUE(weakCounter.expired());
+}
+
+int
+main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
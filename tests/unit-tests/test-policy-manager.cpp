@@ -34,6 +34,8 @@
 #include <ndn-cpp/security/policy/config-policy-manager.hpp>
 #include <ndn-cpp/security/policy/no-verify-policy-manager.hpp>
 #include <ndn-cpp/security/policy/self-verify-policy-manager.hpp>
+#include <ndn-cpp/security/policy/verifier-pool.hpp>
+#include <ndn-cpp/face-reactor.hpp>
 
 using namespace std;
 using namespace ndn;
@@ -261,6 +263,49 @@ static VerificationResult doVerify
   return verificationResult;
 }
 
+/**
+ * A CountingPolicyManager is a SelfVerifyPolicyManager which counts the calls
+ * to checkVerificationPolicy for Data and to refresh, and has a settable change
+ * count.
+ */
+class CountingPolicyManager : public SelfVerifyPolicyManager {
+public:
+  CountingPolicyManager(IdentityStorage* identityStorage)
+  : SelfVerifyPolicyManager(identityStorage), nDataChecks_(0), nRefreshes_(0),
+    changeCount_(0), changeOnRefresh_(false)
+  {
+  }
+
+  using SelfVerifyPolicyManager::checkVerificationPolicy;
+
+  virtual ptr_lib::shared_ptr<ValidationRequest>
+  checkVerificationPolicy
+    (const ptr_lib::shared_ptr<Data>& data, int stepCount,
+     const OnVerified& onVerified,
+     const OnDataValidationFailed& onValidationFailed)
+  {
+    ++nDataChecks_;
+    return SelfVerifyPolicyManager::checkVerificationPolicy
+      (data, stepCount, onVerified, onValidationFailed);
+  }
+
+  virtual uint64_t
+  getChangeCount() const { return changeCount_; }
+
+  virtual void
+  refresh()
+  {
+    ++nRefreshes_;
+    if (changeOnRefresh_)
+      ++changeCount_;
+  }
+
+  int nDataChecks_;
+  int nRefreshes_;
+  uint64_t changeCount_;
+  bool changeOnRefresh_;
+};
+
 class TestConfigPolicyManager : public ::testing::Test {
 public:
   TestConfigPolicyManager()
@@ -449,6 +494,7 @@ TEST_F(TestConfigPolicyManager, Refresh10s)
   ASSERT_EQ(vr.failureCount_, 0) <<
     "ConfigPolicyManager called failure callback with pending ValidationRequest";
 
+  uint64_t changeCountBeforeRefresh = policyManager_->getChangeCount();
   usleep(6000000);
 
   // Now we should find it.
@@ -460,6 +506,178 @@ TEST_F(TestConfigPolicyManager, Refresh10s)
     "Verification success called " << vr.successCount_ << " times instead of 1";
   ASSERT_EQ(vr.failureCount_, 0) <<
     "ConfigPolicyManager did not verify valid signed data";
+  uint64_t changeCount = policyManager_->getChangeCount();
+  ASSERT_TRUE(changeCount > changeCountBeforeRefresh) <<
+    "Adding a trust anchor did not change the policy";
+
+  // Reloading the same trust anchors doesn't change the policy.
+  usleep(6000000);
+  policyManager_->refresh();
+  ASSERT_EQ(changeCount, policyManager_->getChangeCount()) <<
+    "Reloading unchanged trust anchors changed the policy";
+}
+
+TEST_F(TestConfigPolicyManager, VerifiedDataCache)
+{
+  ptr_lib::shared_ptr<CountingPolicyManager> policyManager
+    (new CountingPolicyManager(identityStorage_.get()));
+  KeyChain keyChain(identityManager_, policyManager);
+  keyChain.setVerifiedDataCache(10, 60000.0);
+
+  Name identityName  = Name("TestValidator/VerifiedDataCache");
+  keyChain.createIdentityAndCertificate(identityName);
+
+  ptr_lib::shared_ptr<Data> data(new Data(Name("/TestData/1")));
+  keyChain.signByIdentity(*data, identityName);
+
+  VerificationResult vr;
+  OnVerified onVerified = bind(&VerificationResult::onVerified, &vr, _1);
+  OnDataValidationFailed onValidationFailed = bind
+    (&VerificationResult::onValidationFailed, &vr, _1, _2);
+
+  keyChain.verifyData(data, onVerified, onValidationFailed);
+  ASSERT_EQ(1, vr.successCount_);
+  ASSERT_EQ(1, policyManager->nDataChecks_);
+
+  // A decoded copy has the same implicit digest, so it is found in the cache.
+  ptr_lib::shared_ptr<Data> dataCopy(new Data());
+  dataCopy->wireDecode(data->wireEncode());
+  keyChain.verifyData(dataCopy, onVerified, onValidationFailed);
+  ASSERT_EQ(2, vr.successCount_);
+  ASSERT_EQ(1, policyManager->nDataChecks_) <<
+    "The verified Data was not found in the cache";
+  ASSERT_EQ(2, policyManager->nRefreshes_) <<
+    "verifyData did not refresh the policy before using the cache";
+
+  // A failed verification is not cached.
+  ptr_lib::shared_ptr<Data> unsignedData(new Data(Name("/TestData/2")));
+  keyChain.verifyData(unsignedData, onVerified, onValidationFailed);
+  keyChain.verifyData(unsignedData, onVerified, onValidationFailed);
+  ASSERT_EQ(2, vr.failureCount_);
+  ASSERT_EQ(3, policyManager->nDataChecks_);
+
+  // Changing the policy in refresh clears the cache.
+  policyManager->changeOnRefresh_ = true;
+  keyChain.verifyData(data, onVerified, onValidationFailed);
+  ASSERT_EQ(3, vr.successCount_);
+  ASSERT_EQ(4, policyManager->nDataChecks_) <<
+    "The cache was not cleared when the policy changed";
+}
+
+TEST_F(TestConfigPolicyManager, VerifiedDataCacheNoRefresh)
+{
+  // Put the signing certificate in the anchor directory before loading.
+  IdentityCertificate cert;
+  vector<uint8_t> certData;
+  fromBase64(CERT_DUMP, certData);
+  cert.wireDecode(Blob(certData));
+  keyChain_->signByIdentity(cert, identityName_);
+  Blob signedCertBlob = cert.wireEncode();
+  {
+    ofstream certFile(testCertFile_.c_str());
+    certFile << toBase64(signedCertBlob.buf(), signedCertBlob.size(), true);
+  }
+
+  // Load simple_rules.conf without the refresh period of the anchor directory.
+  ifstream configFile((policyConfigDirectory_ + "/simple_rules.conf").c_str());
+  stringstream config;
+  config << configFile.rdbuf();
+  string configString = config.str();
+  size_t refreshIndex = configString.find("refresh 5s");
+  ASSERT_NE(string::npos, refreshIndex);
+  configString.erase(refreshIndex, string("refresh 5s").size());
+  ptr_lib::shared_ptr<ConfigPolicyManager> policyManager
+    (new ConfigPolicyManager());
+  policyManager->load(configString, "simple_rules.conf");
+  KeyChain keyChain(identityManager_, policyManager);
+  keyChain.setVerifiedDataCache(10, 60000.0);
+
+  ifstream dataFile((policyConfigDirectory_ + "/testData").c_str());
+  stringstream encodedData;
+  encodedData << dataFile.rdbuf();
+  vector<uint8_t> dataBlob;
+  fromBase64(encodedData.str(), dataBlob);
+  ptr_lib::shared_ptr<Data> data(new Data());
+  data->wireDecode(dataBlob);
+
+  VerificationResult vr;
+  OnVerified onVerified = bind(&VerificationResult::onVerified, &vr, _1);
+  OnDataValidationFailed onValidationFailed = bind
+    (&VerificationResult::onValidationFailed, &vr, _1, _2);
+
+  keyChain.verifyData(data, onVerified, onValidationFailed);
+  ASSERT_EQ(1, vr.successCount_);
+  uint64_t changeCount = policyManager->getChangeCount();
+
+  // If the cache hit read the anchor directory, the removed certificate would
+  // change the policy.
+  remove(testCertFile_.c_str());
+  keyChain.verifyData(data, onVerified, onValidationFailed);
+  ASSERT_EQ(2, vr.successCount_);
+  ASSERT_EQ(0, vr.failureCount_);
+  ASSERT_EQ(changeCount, policyManager->getChangeCount()) <<
+    "A cache hit reloaded the anchor directory which has no refresh period";
+}
+
+TEST_F(TestConfigPolicyManager, VerifierPool)
+{
+  // The FaceReactor calls the posted results without connecting face_.
+  FaceReactor reactor;
+  reactor.addFace(face_);
+  ptr_lib::shared_ptr<VerifierPool> verifierPool(new VerifierPool(face_, 2));
+  keyChain_->setVerifierPool(verifierPool);
+
+  ptr_lib::shared_ptr<Data> data(new Data(Name("/TestData/1")));
+  keyChain_->signByIdentity(*data, identityName_);
+  // Changing the content after signing makes the signature invalid.
+  ptr_lib::shared_ptr<Data> badData(new Data(Name("/TestData/2")));
+  keyChain_->signByIdentity(*badData, identityName_);
+  badData->setContent(Blob((const uint8_t*)"bad", 3));
+
+  VerificationResult vr;
+  OnVerified onVerified = bind(&VerificationResult::onVerified, &vr, _1);
+  OnDataValidationFailed onValidationFailed = bind
+    (&VerificationResult::onValidationFailed, &vr, _1, _2);
+
+  keyChain_->verifyData(data, onVerified, onValidationFailed);
+  keyChain_->verifyData(badData, onVerified, onValidationFailed);
+  // The results are only called from processEvents.
+  ASSERT_EQ(0, vr.successCount_);
+  ASSERT_EQ(0, vr.failureCount_);
+
+  // A posted result ends the wait, so this doesn't wait for maxWait.
+  double startSeconds = getNowSeconds();
+  for (int i = 0; i < 4 && vr.successCount_ + vr.failureCount_ < 2; ++i)
+    reactor.processEvents(10000);
+  ASSERT_EQ(1, vr.successCount_) << "Verification of the signed data failed";
+  ASSERT_EQ(1, vr.failureCount_) << "Verification of the modified data succeeded";
+  ASSERT_LT(getNowSeconds() - startSeconds, 2.0) <<
+    "The posted results did not end the wait in processEvents";
+
+  reactor.removeFace(face_);
+}
+
+TEST_F(TestConfigPolicyManager, VerifierPoolWithFaceProcessEvents)
+{
+  ptr_lib::shared_ptr<VerifierPool> verifierPool(new VerifierPool(face_, 1));
+  keyChain_->setVerifierPool(verifierPool);
+
+  ptr_lib::shared_ptr<Data> data(new Data(Name("/TestData/1")));
+  keyChain_->signByIdentity(*data, identityName_);
+
+  VerificationResult vr;
+  OnVerified onVerified = bind(&VerificationResult::onVerified, &vr, _1);
+  OnDataValidationFailed onValidationFailed = bind
+    (&VerificationResult::onValidationFailed, &vr, _1, _2);
+
+  // face_ is not connected, so only the posted result can end the wait.
+  double startSeconds = getNowSeconds();
+  keyChain_->verifyData(data, onVerified, onValidationFailed);
+  for (int i = 0; i < 4 && vr.successCount_ + vr.failureCount_ < 1; ++i)
+    face_.processEvents(10000);
+  ASSERT_EQ(1, vr.successCount_) << "Verification of the signed data failed";
+  ASSERT_LT(getNowSeconds() - startSeconds, 2.0) <<
+    "The posted result did not end the wait in Face.processEvents";
 }
 
 int
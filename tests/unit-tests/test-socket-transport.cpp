@@ -0,0 +1,656 @@
+/**
+ * Copyright (C) 2017 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version, with the additional exemption that
+ * compiling, linking, and/or using OpenSSL is allowed.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * A copy of the GNU Lesser General Public License is in the file COPYING.
+ */
+
+#include "gtest/gtest.h"
+#include <cstring>
+#include <cstdio>
+#include <sstream>
+#include <stdexcept>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <ndn-cpp/interest.hpp>
+#include <ndn-cpp/transport/tcp-transport.hpp>
+#include <ndn-cpp/transport/udp-transport.hpp>
+#include <ndn-cpp/transport/unix-transport.hpp>
+#include "../../src/c/transport/socket-transport.h"
+#include "../../src/c/util/time.h"
+#include "../../src/encoding/element-listener.hpp"
+#include "../../src/util/dynamic-uint8-vector.hpp"
+#if NDN_CPP_HAVE_STD_THREAD
+#include <thread>
+#endif
+
+using namespace std;
+using namespace ndn;
+
+// The number of packets at which the transports send the queue from a callback.
+static const size_t MAX_SEND_QUEUE_PACKETS = 64;
+
+/**
+ * Make a packet of the given length where each byte is value.
+ */
+static Blob
+makePacket(size_t length, uint8_t value)
+{
+  return Blob(vector<uint8_t>(length, value));
+}
+
+/**
+ * Get the bytes which a stream socket should receive for the packets.
+ * @param packets The packets.
+ * @param begin The index of the first packet.
+ * @param end The index after the last packet.
+ * @return The concatenated packets.
+ */
+static vector<uint8_t>
+concatenate(const vector<Blob>& packets, size_t begin, size_t end)
+{
+  vector<uint8_t> result;
+  for (size_t i = begin; i < end; ++i)
+    result.insert(result.end(), packets[i].buf(), packets[i].buf() + packets[i].size());
+  return result;
+}
+
+/**
+ * Receive from the stream socket until it has nBytes or nothing more arrives
+ * within the timeout.
+ * @param socketDescriptor The socket.
+ * @param nBytes The number of bytes to receive.
+ * @param timeoutMilliseconds The time to wait for each receive.
+ * @return The received bytes.
+ */
+static vector<uint8_t>
+receiveStream(int socketDescriptor, size_t nBytes, int timeoutMilliseconds)
+{
+  vector<uint8_t> result;
+  uint8_t buffer[10000];
+  while (result.size() < nBytes) {
+    struct pollfd pollInfo;
+    pollInfo.fd = socketDescriptor;
+    pollInfo.events = POLLIN;
+    if (poll(&pollInfo, 1, timeoutMilliseconds) <= 0)
+      break;
+
+    size_t nBytesToReceive = nBytes - result.size();
+    if (nBytesToReceive > sizeof(buffer))
+      nBytesToReceive = sizeof(buffer);
+    ssize_t nBytesReceived = recv(socketDescriptor, buffer, nBytesToReceive, 0);
+    if (nBytesReceived <= 0)
+      break;
+    result.insert(result.end(), buffer, buffer + nBytesReceived);
+  }
+
+  return result;
+}
+
+/**
+ * Check if the socket has data to receive within the timeout.
+ */
+static bool
+isReadable(int socketDescriptor, int timeoutMilliseconds)
+{
+  struct pollfd pollInfo;
+  pollInfo.fd = socketDescriptor;
+  pollInfo.events = POLLIN;
+  return poll(&pollInfo, 1, timeoutMilliseconds) > 0;
+}
+
+/**
+ * A StreamListener is a listening TCP socket on the loopback interface or a
+ * listening Unix socket, in place of NFD.
+ */
+class StreamListener {
+public:
+  StreamListener(bool isUnix)
+  : isUnix_(isUnix), port_(0)
+  {
+    socket_ = ::socket(isUnix ? AF_UNIX : AF_INET, SOCK_STREAM, 0);
+    if (socket_ < 0)
+      throw runtime_error("StreamListener: Cannot create the socket");
+
+    int bindResult;
+    if (isUnix) {
+      char filePath[100];
+      sprintf(filePath, "/tmp/test-socket-transport-%d.sock", (int)getpid());
+      filePath_ = filePath;
+      ::unlink(filePath_.c_str());
+
+      struct sockaddr_un address;
+      memset(&address, 0, sizeof(address));
+      address.sun_family = AF_UNIX;
+      strcpy(address.sun_path, filePath_.c_str());
+      bindResult = ::bind(socket_, (struct sockaddr*)&address, sizeof(address));
+    }
+    else {
+      struct sockaddr_in address;
+      memset(&address, 0, sizeof(address));
+      address.sin_family = AF_INET;
+      address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+      address.sin_port = 0;
+      socklen_t addressLength = sizeof(address);
+      bindResult = ::bind(socket_, (struct sockaddr*)&address, sizeof(address));
+      if (bindResult == 0)
+        bindResult = getsockname
+          (socket_, (struct sockaddr*)&address, &addressLength);
+      port_ = ntohs(address.sin_port);
+    }
+
+    if (bindResult < 0 || ::listen(socket_, 5) < 0) {
+      ::close(socket_);
+      throw runtime_error("StreamListener: Cannot bind the socket");
+    }
+  }
+
+  ~StreamListener()
+  {
+    ::close(socket_);
+    if (isUnix_)
+      ::unlink(filePath_.c_str());
+  }
+
+  /**
+   * Make a TcpTransport or UnixTransport and the ConnectionInfo to connect to
+   * this listener.
+   */
+  void
+  makeTransport
+    (ptr_lib::shared_ptr<Transport>& transport,
+     ptr_lib::shared_ptr<Transport::ConnectionInfo>& connectionInfo)
+  {
+    if (isUnix_) {
+      transport.reset(new UnixTransport());
+      connectionInfo.reset
+        (new UnixTransport::ConnectionInfo(filePath_.c_str()));
+    }
+    else {
+      transport.reset(new TcpTransport());
+      connectionInfo.reset(new TcpTransport::ConnectionInfo("127.0.0.1", port_));
+    }
+  }
+
+  /**
+   * Accept a connection.
+   * @return The connected socket, or -1 if none was accepted in time.
+   */
+  int
+  accept()
+  {
+    if (!isReadable(socket_, 2000))
+      return -1;
+    return ::accept(socket_, 0, 0);
+  }
+
+  int
+  getSocket() { return socket_; }
+
+  unsigned short
+  getPort() { return port_; }
+
+private:
+  bool isUnix_;
+  int socket_;
+  unsigned short port_;
+  string filePath_;
+};
+
+/**
+ * A QueueChecker is the ElementListener of a stream transport. When it
+ * receives an element, it sends packets like a Face callback and records what
+ * the peer socket has received so far.
+ */
+class QueueChecker : public ElementListener {
+public:
+  QueueChecker(const vector<Blob>& packets)
+  : packets_(packets), transport_(0), peerSocket_(-1), nElements_(0),
+    nBytesBeforeLimit_(0), nBytesAfterLimit_(0)
+  {
+  }
+
+  virtual void
+  onReceivedElement(const uint8_t *element, size_t elementLength)
+  {
+    ++nElements_;
+
+    size_t i = 0;
+    for (; i < MAX_SEND_QUEUE_PACKETS - 1; ++i)
+      send(i);
+    // The transport queues the packets until the queue is full.
+    nBytesBeforeLimit_ = receiveStream(peerSocket_, 1, 100).size();
+
+    send(i++);
+    receivedAtLimit_ = receiveStream
+      (peerSocket_, concatenate(packets_, 0, i).size(), 2000);
+
+    size_t flushBegin = i;
+    for (; i < packets_.size() - 1; ++i)
+      send(i);
+    nBytesAfterLimit_ = receiveStream(peerSocket_, 1, 100).size();
+
+    transport_->flush();
+    receivedAfterFlush_ = receiveStream
+      (peerSocket_, concatenate(packets_, flushBegin, i).size(), 2000);
+
+    // The transport sends the last packet when processEvents returns.
+    send(i);
+  }
+
+  void
+  send(size_t i) { transport_->send(packets_[i].buf(), packets_[i].size()); }
+
+  vector<Blob> packets_;
+  Transport* transport_;
+  int peerSocket_;
+  int nElements_;
+  size_t nBytesBeforeLimit_;
+  vector<uint8_t> receivedAtLimit_;
+  size_t nBytesAfterLimit_;
+  vector<uint8_t> receivedAfterFlush_;
+};
+
+/**
+ * Check send, sendBatch, flush and the send queue of a TcpTransport or a
+ * UnixTransport.
+ */
+static void
+checkStreamTransport(bool isUnix)
+{
+  StreamListener listener(isUnix);
+  ptr_lib::shared_ptr<Transport> transport;
+  ptr_lib::shared_ptr<Transport::ConnectionInfo> connectionInfo;
+  listener.makeTransport(transport, connectionInfo);
+
+  vector<Blob> packets;
+  for (size_t i = 0; i < MAX_SEND_QUEUE_PACKETS + 10; ++i)
+    packets.push_back(makePacket(100 + i, (uint8_t)i));
+  QueueChecker checker(packets);
+  checker.transport_ = transport.get();
+
+  transport->connect(*connectionInfo, checker, Transport::OnConnected());
+  int peerSocket = listener.accept();
+  ASSERT_TRUE(peerSocket >= 0);
+  checker.peerSocket_ = peerSocket;
+
+  // Outside of processEvents, send and sendBatch send right away.
+  transport->send(packets[0].buf(), packets[0].size());
+  ASSERT_TRUE(concatenate(packets, 0, 1) ==
+              receiveStream(peerSocket, packets[0].size(), 2000)) <<
+    "send outside of processEvents did not send right away";
+  vector<Blob> batch(packets.begin(), packets.begin() + 3);
+  transport->sendBatch(batch);
+  ASSERT_TRUE(concatenate(packets, 0, 3) ==
+              receiveStream(peerSocket, concatenate(packets, 0, 3).size(), 2000)) <<
+    "sendBatch did not send the packets in order";
+
+  // Send an element so that processEvents calls the QueueChecker.
+  Blob element = Interest(Name("/test/queue")).wireEncode();
+  ASSERT_EQ((ssize_t)element.size(),
+            ::send(peerSocket, element.buf(), element.size(), 0));
+  MillisecondsSince1970 endTime = ndn_getNowMilliseconds() + 2000;
+  while (checker.nElements_ == 0 && ndn_getNowMilliseconds() < endTime) {
+    isReadable(transport->getSocketDescriptor(), 100);
+    transport->processEvents();
+  }
+  ASSERT_EQ(1, checker.nElements_);
+
+  ASSERT_EQ((size_t)0, checker.nBytesBeforeLimit_) <<
+    "A packet sent in a callback was not queued";
+  ASSERT_TRUE(concatenate(packets, 0, MAX_SEND_QUEUE_PACKETS) ==
+              checker.receivedAtLimit_) <<
+    "A full send queue was not sent in order";
+  ASSERT_EQ((size_t)0, checker.nBytesAfterLimit_) <<
+    "A packet sent after the full queue was not queued";
+  ASSERT_TRUE(concatenate
+              (packets, MAX_SEND_QUEUE_PACKETS, packets.size() - 1) ==
+              checker.receivedAfterFlush_) <<
+    "flush did not send the queued packets";
+  ASSERT_TRUE(concatenate(packets, packets.size() - 1, packets.size()) ==
+              receiveStream(peerSocket, packets.back().size(), 2000)) <<
+    "processEvents did not send the queue when it returned";
+
+  transport->close();
+  ::close(peerSocket);
+}
+
+TEST(TestSocketTransport, SendBatch)
+{
+  int sockets[2];
+  ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, sockets));
+  DynamicUInt8Vector elementBuffer(1000);
+  struct ndn_SocketTransport transport;
+  ndn_SocketTransport_initialize(&transport, &elementBuffer);
+  transport.socketDescriptor = sockets[0];
+
+  // Use more packets than one writev takes, including empty packets.
+  vector<Blob> packets;
+  for (size_t i = 0; i < 150; ++i)
+    packets.push_back(makePacket(i % 10 == 0 ? 0 : i * 3, (uint8_t)i));
+  vector<struct ndn_Blob> blobs(packets.size());
+  for (size_t i = 0; i < packets.size(); ++i) {
+    blobs[i].value = packets[i].buf();
+    blobs[i].length = packets[i].size();
+  }
+
+  ASSERT_EQ(NDN_ERROR_success, ndn_SocketTransport_sendBatch
+    (&transport, &blobs[0], blobs.size()));
+  vector<uint8_t> expected = concatenate(packets, 0, packets.size());
+  ASSERT_TRUE(expected == receiveStream(sockets[1], expected.size(), 2000)) <<
+    "sendBatch did not send the packets in order";
+
+  Blob packet = makePacket(1000, 7);
+  ASSERT_EQ(NDN_ERROR_success, ndn_SocketTransport_send
+    (&transport, packet.buf(), packet.size()));
+  ASSERT_TRUE(*packet == receiveStream(sockets[1], packet.size(), 2000));
+
+  ndn_SocketTransport_close(&transport);
+  ::close(sockets[1]);
+}
+
+#if NDN_CPP_HAVE_STD_THREAD
+/**
+ * Receive nBytes slowly from the socket, so that the sender's writes block.
+ */
+static void
+receiveSlowly(int socketDescriptor, size_t nBytes, vector<uint8_t>* result)
+{
+  uint8_t buffer[2000];
+  MillisecondsSince1970 endTime = ndn_getNowMilliseconds() + 10000;
+  while (result->size() < nBytes && ndn_getNowMilliseconds() < endTime) {
+    ssize_t nBytesReceived = recv
+      (socketDescriptor, buffer, sizeof(buffer), MSG_DONTWAIT);
+    if (nBytesReceived == 0)
+      break;
+    if (nBytesReceived > 0)
+      result->insert(result->end(), buffer, buffer + nBytesReceived);
+    usleep(1000);
+  }
+}
+
+TEST(TestSocketTransport, PartialWrites)
+{
+  StreamListener listener(false);
+  // Small buffers and a send timeout make writev and send return after only
+  // writing part of the data while the receiver is slow.
+  int bufferSize = 4096;
+  setsockopt(listener.getSocket(), SOL_SOCKET, SO_RCVBUF, &bufferSize,
+             sizeof(bufferSize));
+
+  int clientSocket = ::socket(AF_INET, SOCK_STREAM, 0);
+  ASSERT_TRUE(clientSocket >= 0);
+  setsockopt(clientSocket, SOL_SOCKET, SO_SNDBUF, &bufferSize,
+             sizeof(bufferSize));
+  struct sockaddr_in address;
+  memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address.sin_port = htons(listener.getPort());
+  ASSERT_EQ(0, ::connect(clientSocket, (struct sockaddr*)&address, sizeof(address)));
+  int peerSocket = listener.accept();
+  ASSERT_TRUE(peerSocket >= 0);
+  struct timeval timeout;
+  timeout.tv_sec = 0;
+  timeout.tv_usec = 50000;
+  setsockopt(clientSocket, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+  DynamicUInt8Vector elementBuffer(1000);
+  struct ndn_SocketTransport transport;
+  ndn_SocketTransport_initialize(&transport, &elementBuffer);
+  transport.socketDescriptor = clientSocket;
+
+  vector<Blob> packets;
+  for (size_t i = 0; i < 100; ++i)
+    packets.push_back(makePacket(3000 + i, (uint8_t)i));
+  vector<struct ndn_Blob> blobs(packets.size());
+  for (size_t i = 0; i < packets.size(); ++i) {
+    blobs[i].value = packets[i].buf();
+    blobs[i].length = packets[i].size();
+  }
+  Blob largePacket = makePacket(200000, 0xAB);
+  vector<uint8_t> expected = concatenate(packets, 0, packets.size());
+  expected.insert(expected.end(), largePacket.buf(),
+                  largePacket.buf() + largePacket.size());
+
+  vector<uint8_t> received;
+  thread receiver(receiveSlowly, peerSocket, expected.size(), &received);
+  ndn_Error batchError = ndn_SocketTransport_sendBatch
+    (&transport, &blobs[0], blobs.size());
+  ndn_Error sendError = ndn_SocketTransport_send
+    (&transport, largePacket.buf(), largePacket.size());
+  receiver.join();
+
+  ASSERT_EQ(NDN_ERROR_success, batchError);
+  ASSERT_EQ(NDN_ERROR_success, sendError);
+  ASSERT_EQ(expected.size(), received.size());
+  ASSERT_TRUE(expected == received) <<
+    "The packets were corrupted or reordered after a partial write";
+
+  ndn_SocketTransport_close(&transport);
+  ::close(peerSocket);
+}
+#endif
+
+TEST(TestSocketTransport, TcpTransportQueue)
+{
+  checkStreamTransport(false);
+}
+
+TEST(TestSocketTransport, UnixTransportQueue)
+{
+  checkStreamTransport(true);
+}
+
+/**
+ * A DatagramSender is the ElementListener of a UdpTransport which sends the
+ * packets when it receives an element.
+ */
+class DatagramSender : public ElementListener {
+public:
+  DatagramSender(const vector<Blob>& packets)
+  : packets_(packets), transport_(0), peerSocket_(-1), nElements_(0),
+    wasReadable_(false)
+  {
+  }
+
+  virtual void
+  onReceivedElement(const uint8_t *element, size_t elementLength)
+  {
+    ++nElements_;
+    for (size_t i = 0; i < packets_.size(); ++i)
+      transport_->send(packets_[i].buf(), packets_[i].size());
+    wasReadable_ = isReadable(peerSocket_, 100);
+  }
+
+  vector<Blob> packets_;
+  Transport* transport_;
+  int peerSocket_;
+  int nElements_;
+  bool wasReadable_;
+};
+
+TEST(TestSocketTransport, UdpTransportQueue)
+{
+  int peerSocket = ::socket(AF_INET, SOCK_DGRAM, 0);
+  ASSERT_TRUE(peerSocket >= 0);
+  struct sockaddr_in address;
+  memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address.sin_port = 0;
+  socklen_t addressLength = sizeof(address);
+  ASSERT_EQ(0, ::bind(peerSocket, (struct sockaddr*)&address, sizeof(address)));
+  ASSERT_EQ(0, getsockname(peerSocket, (struct sockaddr*)&address, &addressLength));
+
+  vector<Blob> packets;
+  for (size_t i = 0; i < 5; ++i)
+    packets.push_back(makePacket(100 + i * 50, (uint8_t)i));
+  DatagramSender sender(packets);
+  UdpTransport transport;
+  sender.transport_ = &transport;
+  sender.peerSocket_ = peerSocket;
+  transport.connect
+    (UdpTransport::ConnectionInfo("127.0.0.1", ntohs(address.sin_port)),
+     sender, Transport::OnConnected());
+
+  // Outside of processEvents, send sends right away. Get the transport address.
+  transport.send(packets[0].buf(), packets[0].size());
+  ASSERT_TRUE(isReadable(peerSocket, 2000));
+  uint8_t buffer[MAX_NDN_PACKET_SIZE];
+  struct sockaddr_in from;
+  socklen_t fromLength = sizeof(from);
+  ASSERT_EQ((ssize_t)packets[0].size(), recvfrom
+    (peerSocket, buffer, sizeof(buffer), 0, (struct sockaddr*)&from,
+     &fromLength));
+
+  Blob element = Interest(Name("/test/queue")).wireEncode();
+  sendto(peerSocket, element.buf(), element.size(), 0, (struct sockaddr*)&from,
+         fromLength);
+  MillisecondsSince1970 endTime = ndn_getNowMilliseconds() + 2000;
+  while (sender.nElements_ == 0 && ndn_getNowMilliseconds() < endTime) {
+    isReadable(transport.getSocketDescriptor(), 100);
+    transport.processEvents();
+  }
+  ASSERT_EQ(1, sender.nElements_);
+  ASSERT_FALSE(sender.wasReadable_) <<
+    "A datagram sent in a callback was not queued";
+
+  // processEvents sent the queue, one datagram per packet.
+  for (size_t i = 0; i < packets.size(); ++i) {
+    ASSERT_TRUE(isReadable(peerSocket, 2000));
+    ssize_t nBytes = recv(peerSocket, buffer, sizeof(buffer), 0);
+    ASSERT_EQ((ssize_t)packets[i].size(), nBytes);
+    ASSERT_TRUE(Blob(buffer, nBytes).equals(packets[i])) <<
+      "The queued datagrams were not sent in order";
+  }
+
+  transport.close();
+  ::close(peerSocket);
+}
+
+/**
+ * An ElementCollector is an ElementListener which saves a copy of each
+ * received element.
+ */
+class ElementCollector : public ElementListener {
+public:
+  virtual void
+  onReceivedElement(const uint8_t *element, size_t elementLength)
+  {
+    elements_.push_back(Blob(element, elementLength));
+  }
+
+  vector<Blob> elements_;
+};
+
+/**
+ * Send the datagrams on the peer socket, then call processDatagramEvents with
+ * nBuffers until it returns success, and check that the valid elements are
+ * received in order. The ElementReader's partial data has a fixed buffer of
+ * 100 bytes, like a UdpTransportLite with a small buffer, so that a truncated
+ * element which doesn't fit is a decode error in the middle of the batch.
+ * @param nBuffers The number of buffers for processDatagramEvents.
+ */
+static void
+checkReceiveDatagrams(size_t nBuffers)
+{
+  int sockets[2];
+  ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_DGRAM, 0, sockets));
+  uint8_t partialDataArray[100];
+  struct ndn_DynamicUInt8Array partialData;
+  ndn_DynamicUInt8Array_initialize
+    (&partialData, partialDataArray, sizeof(partialDataArray), 0);
+  ElementCollector collector;
+  struct ndn_SocketTransport transport;
+  ndn_SocketTransport_initialize(&transport, &partialData);
+  transport.elementReader.elementListener = &collector;
+  transport.socketDescriptor = sockets[0];
+
+  vector<Blob> expected;
+  for (size_t i = 0; i < 8; ++i) {
+    ostringstream uri;
+    uri << "/test/datagram/" << i;
+    expected.push_back(Interest(Name(uri.str())).wireEncode());
+  }
+  // A truncated element which fits in the partial data is silently dropped.
+  Blob truncated(expected[0].buf(), expected[0].size() / 2);
+  // A truncated element which doesn't fit in the partial data is an error.
+  vector<uint8_t> tooLarge(150, 0);
+  tooLarge[0] = 5;
+  tooLarge[1] = 253;
+  tooLarge[2] = 0x01;
+  tooLarge[3] = 0x00;
+
+  vector<Blob> datagrams;
+  datagrams.push_back(expected[0]);
+  // Two elements in one datagram.
+  datagrams.push_back(Blob(concatenate(expected, 1, 3)));
+  datagrams.push_back(truncated);
+  datagrams.push_back(expected[3]);
+  datagrams.push_back(expected[4]);
+  datagrams.push_back(Blob(tooLarge));
+  datagrams.push_back(expected[5]);
+  datagrams.push_back(expected[6]);
+  datagrams.push_back(expected[7]);
+  for (size_t i = 0; i < datagrams.size(); ++i)
+    ASSERT_EQ((ssize_t)datagrams[i].size(), ::send
+      (sockets[1], datagrams[i].buf(), datagrams[i].size(), 0));
+
+  vector<uint8_t> buffers(nBuffers * MAX_NDN_PACKET_SIZE);
+  ndn_Error error = ndn_SocketTransport_processDatagramEvents
+    (&transport, &buffers[0], MAX_NDN_PACKET_SIZE, nBuffers);
+  ASSERT_EQ(NDN_ERROR_DynamicUInt8Array_realloc_function_pointer_not_supplied,
+            error);
+  // The datagrams after the error are still received.
+  ASSERT_EQ(NDN_ERROR_success, ndn_SocketTransport_processDatagramEvents
+    (&transport, &buffers[0], MAX_NDN_PACKET_SIZE, nBuffers));
+
+  ASSERT_EQ(expected.size(), collector.elements_.size());
+  for (size_t i = 0; i < expected.size(); ++i)
+    ASSERT_TRUE(collector.elements_[i].equals(expected[i])) <<
+      "The elements were not received in order";
+  ASSERT_EQ(0, transport.elementReader.usePartialData);
+
+  ndn_SocketTransport_close(&transport);
+  ::close(sockets[1]);
+}
+
+TEST(TestSocketTransport, ReceiveDatagram)
+{
+  // One buffer, as used by UdpTransportLite.processEvents.
+  checkReceiveDatagrams(1);
+}
+
+TEST(TestSocketTransport, ReceiveDatagramBatch)
+{
+  // The error is in the middle of the first batch.
+  checkReceiveDatagrams(8);
+  // The error is in the second batch.
+  checkReceiveDatagrams(4);
+}
+
+int
+main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
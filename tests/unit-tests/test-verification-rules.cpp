@@ -28,6 +28,7 @@
 #include <ndn-cpp/security/identity/memory-identity-storage.hpp>
 #include <ndn-cpp/security/identity/memory-private-key-storage.hpp>
 #include <ndn-cpp/security/policy/config-policy-manager.hpp>
+#include "../../src/util/boost-info-parser.hpp"
 
 using namespace std;
 using namespace ndn;
@@ -367,6 +368,87 @@ TEST_F(TestVerificationRules, HyperRelation)
     (signatureName2, dataName, *matchedRule, failureReason));
 }
 
+TEST_F(TestVerificationRules, RuleOrder)
+{
+  // The indexed relation rules and the regex rule must still be checked in
+  // the order of the configuration.
+  ConfigPolicyManager policyManager;
+  policyManager.load
+    ("validator\n"
+     "{\n"
+     "  rule\n"
+     "  {\n"
+     "    id \"Long prefix\"\n"
+     "    for data\n"
+     "    filter\n"
+     "    {\n"
+     "      type name\n"
+     "      name /A/B\n"
+     "      relation is-prefix-of\n"
+     "    }\n"
+     "    checker\n"
+     "    {\n"
+     "      type hierarchical\n"
+     "    }\n"
+     "  }\n"
+     "  rule\n"
+     "  {\n"
+     "    id \"Regex\"\n"
+     "    for data\n"
+     "    filter\n"
+     "    {\n"
+     "      type name\n"
+     "      regex ^<A><>*$\n"
+     "    }\n"
+     "    checker\n"
+     "    {\n"
+     "      type hierarchical\n"
+     "    }\n"
+     "  }\n"
+     "  rule\n"
+     "  {\n"
+     "    id \"Short prefix\"\n"
+     "    for data\n"
+     "    filter\n"
+     "    {\n"
+     "      type name\n"
+     "      name /\n"
+     "      relation is-prefix-of\n"
+     "    }\n"
+     "    checker\n"
+     "    {\n"
+     "      type hierarchical\n"
+     "    }\n"
+     "  }\n"
+     "  rule\n"
+     "  {\n"
+     "    id \"Interest\"\n"
+     "    for interest\n"
+     "    checker\n"
+     "    {\n"
+     "      type hierarchical\n"
+     "    }\n"
+     "  }\n"
+     "}\n", "RuleOrder");
+
+  const BoostInfoTree* matchedRule =
+    policyManager.findMatchingRule(Name("/A/B/C"), "data");
+  ASSERT_TRUE(matchedRule);
+  ASSERT_EQ("Long prefix", *matchedRule->getFirstValue("id"));
+
+  matchedRule = policyManager.findMatchingRule(Name("/A/C"), "data");
+  ASSERT_TRUE(matchedRule);
+  ASSERT_EQ("Regex", *matchedRule->getFirstValue("id"));
+
+  matchedRule = policyManager.findMatchingRule(Name("/B/C"), "data");
+  ASSERT_TRUE(matchedRule);
+  ASSERT_EQ("Short prefix", *matchedRule->getFirstValue("id"));
+
+  matchedRule = policyManager.findMatchingRule(Name("/B/C"), "interest");
+  ASSERT_TRUE(matchedRule);
+  ASSERT_EQ("Interest", *matchedRule->getFirstValue("id"));
+}
+
 int
 main(int argc, char **argv)
 {